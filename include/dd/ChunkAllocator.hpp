@@ -0,0 +1,120 @@
+/*
+ * This file is part of the JKQ DD Package which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_CHUNKALLOCATOR_HPP
+#define DD_PACKAGE_CHUNKALLOCATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#if defined(__linux__)
+    #include <sys/mman.h>
+#endif
+
+namespace dd {
+
+    // settings of the default allocator for chunks of nodes and complex table entries
+    struct ChunkAllocatorSettings {
+        // chunks of at least this many bytes are mapped directly and aligned to huge pages
+        static constexpr std::size_t HUGE_PAGE_SIZE = std::size_t{2} << 20U;
+
+        // advise the kernel to back large chunks with transparent huge pages
+        static inline bool transparentHugePages = true;
+        // first try to obtain large chunks from the pool of explicitly reserved huge pages (MAP_HUGETLB)
+        static inline bool reservedHugePages = false;
+    };
+
+    /// Default allocator for the chunks of nodes and complex table entries
+    /// Large chunks are mapped directly from the operating system, aligned to and padded to a multiple of the huge
+    /// page size, so that they may be backed by 2 MiB pages. This reduces TLB misses when traversing large DDs.
+    /// Chunks are initialized by the thread allocating them, which places them on that thread's NUMA node under the
+    /// default first-touch policy. Small chunks and platforms other than Linux use the global operator new.
+    /// \tparam T type of the chunks' elements
+    template<class T>
+    class ChunkAllocator {
+    public:
+        using value_type = T;
+
+        ChunkAllocator() noexcept = default;
+        template<class U>
+        ChunkAllocator(const ChunkAllocator<U>& /*other*/) noexcept {} // NOLINT(google-explicit-constructor)
+
+        [[nodiscard]] T* allocate(std::size_t n) {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            const auto bytes = n * sizeof(T);
+            if (!isHuge(bytes)) {
+                return static_cast<T*>(::operator new(bytes));
+            }
+#if defined(__linux__)
+            return static_cast<T*>(mapHuge(padded(bytes)));
+#else
+            return static_cast<T*>(::operator new(bytes));
+#endif
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            const auto bytes = n * sizeof(T);
+            if (!isHuge(bytes)) {
+                ::operator delete(p);
+                return;
+            }
+#if defined(__linux__)
+            munmap(p, padded(bytes));
+#else
+            ::operator delete(p);
+#endif
+        }
+
+        template<class U>
+        bool operator==(const ChunkAllocator<U>& /*other*/) const noexcept { return true; }
+        template<class U>
+        bool operator!=(const ChunkAllocator<U>& /*other*/) const noexcept { return false; }
+
+    private:
+        static constexpr std::size_t HUGE_PAGE_SIZE = ChunkAllocatorSettings::HUGE_PAGE_SIZE;
+
+        static constexpr bool        isHuge(std::size_t bytes) { return bytes >= HUGE_PAGE_SIZE; }
+        static constexpr std::size_t padded(std::size_t bytes) { return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE; }
+
+#if defined(__linux__)
+        static void* mapHuge(std::size_t bytes) {
+    #if defined(MAP_HUGETLB)
+            if (ChunkAllocatorSettings::reservedHugePages) {
+                void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+                if (p != MAP_FAILED) {
+                    return p;
+                }
+            }
+    #endif
+            // over-allocate in order to align the mapping to a huge page boundary and unmap the excess
+            auto* raw = static_cast<std::uint8_t*>(mmap(nullptr, bytes + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+            if (raw == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            const auto offset  = reinterpret_cast<std::uintptr_t>(raw) % HUGE_PAGE_SIZE;
+            auto*      aligned = offset == 0 ? raw : raw + (HUGE_PAGE_SIZE - offset);
+            if (aligned != raw) {
+                munmap(raw, static_cast<std::size_t>(aligned - raw));
+            }
+            if (const auto tail = static_cast<std::size_t>((raw + bytes + HUGE_PAGE_SIZE) - (aligned + bytes)); tail > 0) {
+                munmap(aligned + bytes, tail);
+            }
+    #if defined(MADV_HUGEPAGE)
+            if (ChunkAllocatorSettings::transparentHugePages) {
+                madvise(aligned, bytes, MADV_HUGEPAGE);
+            }
+    #endif
+            return aligned;
+        }
+#endif
+    };
+
+} // namespace dd
+
+#endif //DD_PACKAGE_CHUNKALLOCATOR_HPP
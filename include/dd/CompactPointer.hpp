@@ -0,0 +1,269 @@
+/*
+ * This file is part of the JKQ DD Package which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_COMPACTPOINTER_HPP
+#define DD_PACKAGE_COMPACTPOINTER_HPP
+
+#include "ChunkAllocator.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#ifdef DD_PACKAGE_COMPACT_NODES
+    #if !defined(__unix__) && !defined(__APPLE__)
+        #error "The compact node layout (DD_PACKAGE_COMPACT_NODES) requires mmap."
+    #endif
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace dd {
+#ifdef DD_PACKAGE_COMPACT_NODES
+    /// Arena from which all objects of type T (nodes or complex table entries) are allocated in the compact build
+    /// A contiguous range of virtual memory for CAPACITY objects is reserved on first use and memory is committed when
+    /// chunks are allocated. This way, every object is identified by its slot, i.e., its index in the arena. Slot 0 is
+    /// never allocated and represents nullptr, the slots below RESERVED hold static objects (see emplace). Released
+    /// chunks are reused for chunks of the same size.
+    /// \tparam T type of the objects
+    template<class T>
+    class CompactArena {
+    public:
+        static constexpr std::size_t CAPACITY = std::size_t{1} << 31U;
+        static constexpr std::size_t RESERVED = 4;
+
+        // start of the arena. It is set when the first object is allocated or emplaced, i.e., before any pointer to
+        // an object of the arena can exist.
+        [[nodiscard]] static T* base() noexcept { return start; }
+
+        [[nodiscard]] static std::uint32_t slot(const T* p) {
+            assert(p >= base() && p < base() + CAPACITY);
+            return static_cast<std::uint32_t>(p - base());
+        }
+
+        [[nodiscard]] static T* allocate(std::size_t n) {
+            auto&                  s = state();
+            const std::scoped_lock lock(s.mutex);
+            reserve();
+            if (auto it = s.released.find(n); it != s.released.end() && !it->second.empty()) {
+                auto* p = base() + it->second.back();
+                it->second.pop_back();
+                return p;
+            }
+            if (n > CAPACITY - s.next) {
+                throw std::bad_alloc();
+            }
+            auto* p = base() + s.next;
+            s.next += n;
+            commit(p, n);
+            return p;
+        }
+
+        static void deallocate(T* p, std::size_t n) noexcept {
+            auto&                  s = state();
+            const std::scoped_lock lock(s.mutex);
+            // as with the ChunkAllocator, the memory of small chunks is kept. Of large chunks, the pages not shared
+            // with neighboring chunks are returned to the operating system.
+            if (n * sizeof(T) >= ChunkAllocatorSettings::HUGE_PAGE_SIZE) {
+                const auto page  = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+                const auto begin = (reinterpret_cast<std::uintptr_t>(p) + page - 1) / page * page;
+                const auto end   = reinterpret_cast<std::uintptr_t>(p + n) / page * page;
+                if (begin < end) {
+                    madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+                }
+            }
+            s.released[n].push_back(slot(p));
+        }
+
+        // construct a copy of the static object `value` in the reserved slot `index` (0 < index < RESERVED)
+        static T& emplace(std::uint32_t index, const T& value) {
+            assert(index > 0 && index < RESERVED);
+            auto&                  s = state();
+            const std::scoped_lock lock(s.mutex);
+            reserve();
+            return *new (base() + index) T(value);
+        }
+
+    private:
+        struct State {
+            std::mutex                                        mutex{};
+            std::size_t                                       next = RESERVED;
+            std::map<std::size_t, std::vector<std::uint32_t>> released{};
+        };
+
+        static inline T* start = nullptr;
+
+        static State& state() {
+            static State s{};
+            return s;
+        }
+
+        // reserve the range of the arena unless this has happened before (with the lock of the state held)
+        static void reserve() {
+            if (start != nullptr) {
+                return;
+            }
+            auto flags = MAP_PRIVATE | MAP_ANONYMOUS;
+    #if defined(MAP_NORESERVE)
+            flags |= MAP_NORESERVE;
+    #endif
+            void* p = mmap(nullptr, CAPACITY * sizeof(T), PROT_NONE, flags, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            commit(static_cast<T*>(p), RESERVED);
+            start = static_cast<T*>(p);
+        }
+
+        static void commit(T* p, std::size_t n) {
+            const auto page  = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+            const auto begin = reinterpret_cast<std::uintptr_t>(p) / page * page;
+            const auto end   = (reinterpret_cast<std::uintptr_t>(p + n) + page - 1) / page * page;
+            if (mprotect(reinterpret_cast<void*>(begin), end - begin, PROT_READ | PROT_WRITE) != 0) {
+                throw std::bad_alloc();
+            }
+    #if defined(MADV_HUGEPAGE)
+            if (ChunkAllocatorSettings::transparentHugePages && end - begin >= ChunkAllocatorSettings::HUGE_PAGE_SIZE) {
+                madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+            }
+    #endif
+        }
+    };
+
+    /// Allocator for the chunks of nodes and complex table entries in the compact build (see CompactArena)
+    template<class T>
+    class CompactAllocator {
+    public:
+        using value_type = T;
+
+        CompactAllocator() noexcept = default;
+        template<class U>
+        CompactAllocator(const CompactAllocator<U>& /*other*/) noexcept {} // NOLINT(google-explicit-constructor)
+
+        [[nodiscard]] T* allocate(std::size_t n) { return CompactArena<T>::allocate(n); }
+        void             deallocate(T* p, std::size_t n) noexcept { CompactArena<T>::deallocate(p, n); }
+
+        template<class U>
+        bool operator==(const CompactAllocator<U>& /*other*/) const noexcept { return true; }
+        template<class U>
+        bool operator!=(const CompactAllocator<U>& /*other*/) const noexcept { return false; }
+    };
+
+    /// Pointer to an object of a CompactArena, which is stored as the 32bit slot of the object
+    /// It converts implicitly from and to ordinary pointers, so that it can be used in place of them. If TAGGED, the
+    /// least significant bit of the pointer (e.g., the sign of a complex table entry, see ComplexTable::Entry) is kept
+    /// in the least significant bit of the slot, which leaves 31 bits for the slot itself.
+    /// \tparam T type of the objects
+    /// \tparam TAGGED whether the least significant bit of the pointer is used as a tag
+    template<class T, bool TAGGED = false>
+    class CompactPointer {
+        using Arena = CompactArena<std::remove_const_t<T>>;
+
+    public:
+        constexpr CompactPointer() noexcept = default;
+        constexpr CompactPointer(std::nullptr_t) noexcept {} // NOLINT(google-explicit-constructor)
+        CompactPointer(T* p) noexcept:                       // NOLINT(google-explicit-constructor)
+            bits(encode(p)) {}
+        CompactPointer(const CompactPointer<T, !TAGGED>& p) noexcept: // NOLINT(google-explicit-constructor)
+            bits(encode(p)) {}
+
+        // pointer to the object in the given slot of the arena
+        [[nodiscard]] static constexpr CompactPointer fromSlot(std::uint32_t slot) noexcept {
+            CompactPointer p{};
+            p.bits = TAGGED ? slot << 1U : slot;
+            return p;
+        }
+
+        operator T*() const noexcept { return decode(bits); } // NOLINT(google-explicit-constructor)
+        T* operator->() const noexcept { return decode(bits); }
+        T& operator*() const noexcept { return *decode(bits); }
+
+        [[nodiscard]] constexpr std::uint32_t getBits() const noexcept { return bits; }
+
+        friend constexpr bool operator==(CompactPointer lhs, CompactPointer rhs) noexcept { return lhs.bits == rhs.bits; }
+        friend constexpr bool operator!=(CompactPointer lhs, CompactPointer rhs) noexcept { return lhs.bits != rhs.bits; }
+        friend constexpr bool operator==(CompactPointer lhs, std::nullptr_t) noexcept { return lhs.bits == 0; }
+        friend constexpr bool operator!=(CompactPointer lhs, std::nullptr_t) noexcept { return lhs.bits != 0; }
+        friend bool           operator==(CompactPointer lhs, const T* rhs) noexcept { return decode(lhs.bits) == rhs; }
+        friend bool           operator!=(CompactPointer lhs, const T* rhs) noexcept { return decode(lhs.bits) != rhs; }
+        friend bool           operator==(const T* lhs, CompactPointer rhs) noexcept { return lhs == decode(rhs.bits); }
+        friend bool           operator!=(const T* lhs, CompactPointer rhs) noexcept { return lhs != decode(rhs.bits); }
+        friend bool           operator==(CompactPointer lhs, T* rhs) noexcept { return decode(lhs.bits) == rhs; }
+        friend bool           operator!=(CompactPointer lhs, T* rhs) noexcept { return decode(lhs.bits) != rhs; }
+        friend bool           operator==(T* lhs, CompactPointer rhs) noexcept { return lhs == decode(rhs.bits); }
+        friend bool           operator!=(T* lhs, CompactPointer rhs) noexcept { return lhs != decode(rhs.bits); }
+
+    private:
+        std::uint32_t bits = 0;
+
+        static std::uint32_t encode(const T* p) noexcept {
+            if constexpr (TAGGED) {
+                const auto raw     = reinterpret_cast<std::uintptr_t>(p);
+                const auto aligned = reinterpret_cast<const T*>(raw & ~std::uintptr_t{1});
+                return aligned == nullptr ? 0U : Arena::slot(aligned) << 1U | static_cast<std::uint32_t>(raw & 1U);
+            } else {
+                return p == nullptr ? 0U : Arena::slot(p);
+            }
+        }
+
+        static T* decode(std::uint32_t bits) noexcept {
+            if constexpr (TAGGED) {
+                const auto slot = bits >> 1U;
+                if (slot == 0) {
+                    return nullptr;
+                }
+                return reinterpret_cast<T*>(reinterpret_cast<std::uintptr_t>(Arena::base() + slot) | (bits & 1U));
+            } else {
+                return bits == 0 ? nullptr : Arena::base() + bits;
+            }
+        }
+    };
+
+    // pointers stored in nodes, edges and complex numbers
+    template<class T, bool TAGGED = false>
+    using StoredPointer = CompactPointer<T, TAGGED>;
+    // allocator used for the chunks of nodes and complex table entries by default
+    template<class T>
+    using DefaultChunkAllocator = CompactAllocator<T>;
+#else
+    // pointers stored in nodes, edges and complex numbers
+    template<class T, bool TAGGED = false>
+    using StoredPointer = T*;
+    // allocator used for the chunks of nodes and complex table entries by default
+    template<class T>
+    using DefaultChunkAllocator = ChunkAllocator<T>;
+#endif
+
+    // ordinary pointer to the object a stored pointer refers to (e.g., for deducing the type of the object)
+    template<class T>
+    [[nodiscard]] constexpr T* toPointer(T* p) noexcept {
+        return p;
+    }
+#ifdef DD_PACKAGE_COMPACT_NODES
+    template<class T, bool TAGGED>
+    [[nodiscard]] inline T* toPointer(const CompactPointer<T, TAGGED>& p) noexcept {
+        return p;
+    }
+#endif
+
+    // bits identifying the object a stored pointer refers to (e.g., for hashing)
+    template<class T>
+    [[nodiscard]] inline std::size_t pointerBits(const T* p) noexcept {
+        return reinterpret_cast<std::size_t>(p);
+    }
+#ifdef DD_PACKAGE_COMPACT_NODES
+    template<class T, bool TAGGED>
+    [[nodiscard]] inline std::size_t pointerBits(const CompactPointer<T, TAGGED>& p) noexcept {
+        return p.getBits();
+    }
+#endif
+} // namespace dd
+
+#endif //DD_PACKAGE_COMPACTPOINTER_HPP
@@ -6,6 +6,7 @@
 #ifndef DD_PACKAGE_COMPLEX_HPP
 #define DD_PACKAGE_COMPLEX_HPP
 
+#include "CompactPointer.hpp"
 #include "ComplexTable.hpp"
 #include "ComplexValue.hpp"
 
@@ -17,8 +18,8 @@ namespace dd {
     using CTEntry = ComplexTable<>::Entry;
 
     struct Complex {
-        CTEntry* r;
-        CTEntry* i;
+        StoredPointer<CTEntry, true> r;
+        StoredPointer<CTEntry, true> i;
 
         static Complex zero;
         static Complex one;
@@ -80,16 +81,22 @@ namespace dd {
         return os;
     }
 
+#ifdef DD_PACKAGE_COMPACT_NODES
+    // refer to the slots of the static entries, so that the constants do not depend on the initialization of the arena
+    inline Complex Complex::zero{StoredPointer<CTEntry, true>::fromSlot(ComplexTable<>::ZERO_SLOT), StoredPointer<CTEntry, true>::fromSlot(ComplexTable<>::ZERO_SLOT)};
+    inline Complex Complex::one{StoredPointer<CTEntry, true>::fromSlot(ComplexTable<>::ONE_SLOT), StoredPointer<CTEntry, true>::fromSlot(ComplexTable<>::ZERO_SLOT)};
+#else
     inline Complex Complex::zero{&ComplexTable<>::zero, &ComplexTable<>::zero};
     inline Complex Complex::one{&ComplexTable<>::one, &ComplexTable<>::zero};
+#endif
 } // namespace dd
 
 namespace std {
     template<>
     struct hash<dd::Complex> {
         std::size_t operator()(dd::Complex const& c) const noexcept {
-            auto h1 = dd::murmur64(reinterpret_cast<std::size_t>(c.r));
-            auto h2 = dd::murmur64(reinterpret_cast<std::size_t>(c.i));
+            auto h1 = dd::murmur64(dd::pointerBits(c.r));
+            auto h2 = dd::murmur64(dd::pointerBits(c.i));
             return dd::combineHash(h1, h2);
         }
     };
@@ -6,16 +6,19 @@
 #ifndef DD_PACKAGE_COMPLEXCACHE_HPP
 #define DD_PACKAGE_COMPLEXCACHE_HPP
 
+#include "CompactPointer.hpp"
 #include "Complex.hpp"
 #include "ComplexTable.hpp"
 
 #include <cassert>
 #include <cstddef>
+#include <map>
+#include <string>
 #include <vector>
 
 namespace dd {
 
-    template<std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2>
+    template<std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2, template<class> class Allocator = DefaultChunkAllocator>
     class ComplexCache {
         using Entry = ComplexTable<>::Entry;
 
@@ -36,8 +39,21 @@ namespace dd {
         [[nodiscard]] std::size_t getCount() const { return count; }
         [[nodiscard]] std::size_t getPeakCount() const { return peakCount; }
         [[nodiscard]] std::size_t getAllocations() const { return allocations; }
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"count", count},
+                    {"peakCount", peakCount},
+                    {"allocations", allocations},
+            };
+        }
+
         [[nodiscard]] std::size_t getGrowthFactor() const { return GROWTH_FACTOR; }
 
+        // amount of memory (in bytes) occupied by entries that is kept for reuse when the cache is cleared
+        [[nodiscard]] std::size_t getRetainedMemory() const { return retainedMemory; }
+        void                      setRetainedMemory(std::size_t bytes) { retainedMemory = bytes; }
+
         [[nodiscard]] Complex getCachedComplex() {
             // an entry is available on the stack
             if (available != nullptr) {
@@ -48,11 +64,13 @@ namespace dd {
                 return entry;
             }
 
-            // new chunk has to be allocated
+            // new chunk has to be allocated (unless a retained one is available)
             if (chunkIt == chunkEndIt) {
-                chunks.emplace_back(allocationSize);
-                allocations += allocationSize;
-                allocationSize *= GROWTH_FACTOR;
+                if (chunkID + 1 == chunks.size()) {
+                    chunks.emplace_back(allocationSize);
+                    allocations += allocationSize;
+                    allocationSize *= GROWTH_FACTOR;
+                }
                 chunkID++;
                 chunkIt    = chunks[chunkID].begin();
                 chunkEndIt = chunks[chunkID].end();
@@ -74,11 +92,13 @@ namespace dd {
                 return {available, available->next};
             }
 
-            // new chunk has to be allocated
+            // new chunk has to be allocated (unless a retained one is available)
             if (chunkIt == chunkEndIt) {
-                chunks.emplace_back(allocationSize);
-                allocations += allocationSize;
-                allocationSize *= GROWTH_FACTOR;
+                if (chunkID + 1 == chunks.size()) {
+                    chunks.emplace_back(allocationSize);
+                    allocations += allocationSize;
+                    allocationSize *= GROWTH_FACTOR;
+                }
                 chunkID++;
                 chunkIt    = chunks[chunkID].begin();
                 chunkEndIt = chunks[chunkID].end();
@@ -102,32 +122,38 @@ namespace dd {
             // clear available stack
             available = nullptr;
 
-            // release memory of all but the first chunk TODO: it could be desirable to keep the memory
-            while (chunkID > 0) {
-                chunks.pop_back();
-                chunkID--;
+            // release memory of all but the first chunk, except for chunks fitting into the retained memory
+            std::size_t retained = chunks[0].size();
+            std::size_t keep     = 1;
+            while (keep < chunks.size() && (retained + chunks[keep].size()) * sizeof(Entry) <= retainedMemory) {
+                retained += chunks[keep].size();
+                ++keep;
             }
+            chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(keep), chunks.end());
             // restore initial chunk setting
+            chunkID        = 0;
             chunkIt        = chunks[0].begin();
             chunkEndIt     = chunks[0].end();
-            allocationSize = INITIAL_ALLOCATION_SIZE * GROWTH_FACTOR;
-            allocations    = INITIAL_ALLOCATION_SIZE;
+            allocationSize = chunks.back().size() * GROWTH_FACTOR;
+            allocations    = retained;
 
             count     = 0;
             peakCount = 0;
         };
 
     private:
-        Entry*                                available{};
-        std::vector<std::vector<Entry>>       chunks{};
-        std::size_t                           chunkID;
-        typename std::vector<Entry>::iterator chunkIt;
-        typename std::vector<Entry>::iterator chunkEndIt;
-        std::size_t                           allocationSize;
-
-        std::size_t allocations = 0;
-        std::size_t count       = 0;
-        std::size_t peakCount   = 0;
+        using Chunk = std::vector<Entry, Allocator<Entry>>;
+        Entry*                   available{};
+        std::vector<Chunk>       chunks{};
+        std::size_t              chunkID;
+        typename Chunk::iterator chunkIt;
+        typename Chunk::iterator chunkEndIt;
+        std::size_t              allocationSize;
+
+        std::size_t allocations    = 0;
+        std::size_t count          = 0;
+        std::size_t peakCount      = 0;
+        std::size_t retainedMemory = 0;
     };
 } // namespace dd
 
@@ -12,9 +12,13 @@
 #include "ComplexValue.hpp"
 #include "Definitions.hpp"
 
+#include <array>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
+#include <mutex>
+#include <vector>
 
 namespace dd {
     struct ComplexNumbers {
@@ -27,12 +31,48 @@ namespace dd {
         void clear() {
             complexTable.clear();
             complexCache.clear();
+            for (auto& cache: workerCaches) {
+                cache.clear();
+            }
+        }
+
+        // prepare for being used by `nthreads` threads at the same time. The thread with dd::workerIndex 0 keeps
+        // using `complexCache`, while all other threads are provided with caches of their own. Lookups in the
+        // complex table are serialized.
+        void enableConcurrency(std::size_t nthreads) {
+            if (nthreads > workerCaches.size() + 1) {
+                workerCaches.resize(nthreads - 1);
+                for (auto& cache: workerCaches) {
+                    cache.setRetainedMemory(complexCache.getRetainedMemory());
+                }
+            }
+            concurrent = true;
+        }
+
+        void disableConcurrency() {
+            concurrent = false;
+        }
+
+        [[nodiscard]] bool isConcurrent() const { return concurrent; }
+
+        // keep up to `bytes` of memory for complex table entries and up to `bytes` for each cache when clearing
+        void setRetainedMemory(std::size_t bytes) {
+            complexTable.setRetainedMemory(bytes);
+            complexCache.setRetainedMemory(bytes);
+            for (auto& cache: workerCaches) {
+                cache.setRetainedMemory(bytes);
+            }
         }
 
         static void setTolerance(fp tol) {
             ComplexTable<>::setTolerance(tol);
         }
 
+        // tolerance up to which looked up numbers are identified (see ComplexTable::setLookupTolerance)
+        [[nodiscard]] fp getLookupTolerance() const { return complexTable.getLookupTolerance(); }
+        void             setLookupTolerance(fp tol) { complexTable.setLookupTolerance(tol); }
+        void             resetLookupTolerance() { complexTable.resetLookupTolerance(); }
+
         // operations on complex numbers
         // meanings are self-evident from the names
         static void add(Complex& r, const Complex& a, const Complex& b) {
@@ -160,13 +200,18 @@ namespace dd {
             return lookup(valr, vali);
         }
         Complex lookup(const fp& r, const fp& i) {
+            std::unique_lock<std::mutex> lock(tableMutex, std::defer_lock);
+            if (concurrent) {
+                lock.lock();
+            }
+
             Complex ret{};
 
             auto sign_r = std::signbit(r);
             if (sign_r) {
                 auto absr = std::abs(r);
                 // if absolute value is close enough to zero, just return the zero entry (avoiding -0.0)
-                if (absr < decltype(complexTable)::tolerance()) {
+                if (absr < complexTable.getLookupTolerance()) {
                     ret.r = &decltype(complexTable)::zero;
                 } else {
                     ret.r = CTEntry::getNegativePointer(complexTable.lookup(absr));
@@ -179,7 +224,7 @@ namespace dd {
             if (sign_i) {
                 auto absi = std::abs(i);
                 // if absolute value is close enough to zero, just return the zero entry (avoiding -0.0)
-                if (absi < decltype(complexTable)::tolerance()) {
+                if (absi < complexTable.getLookupTolerance()) {
                     ret.i = &decltype(complexTable)::zero;
                 } else {
                     ret.i = CTEntry::getNegativePointer(complexTable.lookup(absi));
@@ -192,6 +237,38 @@ namespace dd {
         }
         inline Complex lookup(const ComplexValue& c) { return lookup(c.r, c.i); }
 
+        // lookup several complex values in one batch (see ComplexTable::lookup); the result matches individual lookups
+        template<std::size_t N>
+        std::array<Complex, N> lookup(const std::array<ComplexValue, N>& values) {
+            std::array<fp, 2 * N>       magnitudes{};
+            std::array<CTEntry*, 2 * N> entries{};
+            for (std::size_t k = 0; k < N; ++k) {
+                magnitudes[2 * k]     = std::abs(values[k].r);
+                magnitudes[2 * k + 1] = std::abs(values[k].i);
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(tableMutex, std::defer_lock);
+                if (concurrent) {
+                    lock.lock();
+                }
+                complexTable.lookup(magnitudes.data(), entries.data(), magnitudes.size());
+            }
+
+            // negative numbers are encoded in the entry pointers (values close to zero always map to the zero entry)
+            const auto withSign = [](CTEntry* entry, const fp val) {
+                if (std::signbit(val) && entry != &decltype(complexTable)::zero) {
+                    return CTEntry::getNegativePointer(entry);
+                }
+                return entry;
+            };
+            std::array<Complex, N> ret{};
+            for (std::size_t k = 0; k < N; ++k) {
+                ret[k] = {withSign(entries[2 * k], values[k].r), withSign(entries[2 * k + 1], values[k].i)};
+            }
+            return ret;
+        }
+
         // reference counting and garbage collection
         static void incRef(const Complex& c) {
             // `zero` and `one` are static and never altered
@@ -213,11 +290,11 @@ namespace dd {
 
         // provide (temporary) cached complex number
         inline Complex getTemporary() {
-            return complexCache.getTemporaryComplex();
+            return cache().getTemporaryComplex();
         }
 
         inline Complex getTemporary(const fp& r, const fp& i) {
-            auto c     = complexCache.getTemporaryComplex();
+            auto c     = cache().getTemporaryComplex();
             c.r->value = r;
             c.i->value = i;
             return c;
@@ -228,11 +305,11 @@ namespace dd {
         }
 
         inline Complex getCached() {
-            return complexCache.getCachedComplex();
+            return cache().getCachedComplex();
         }
 
         inline Complex getCached(const fp& r, const fp& i) {
-            auto c     = complexCache.getCachedComplex();
+            auto c     = cache().getCachedComplex();
             c.r->value = r;
             c.i->value = i;
             return c;
@@ -243,12 +320,29 @@ namespace dd {
         }
 
         void returnToCache(Complex& c) {
-            complexCache.returnToCache(c);
+            cache().returnToCache(c);
         }
 
         [[nodiscard]] std::size_t cacheCount() const {
+            if (concurrent && workerIndex > 0) {
+                return workerCaches[workerIndex - 1].getCount();
+            }
             return complexCache.getCount();
         }
+
+    private:
+        // concurrent operation
+        bool                        concurrent = false;
+        std::vector<ComplexCache<>> workerCaches{};
+        std::mutex                  tableMutex{};
+
+        // cache of the current thread
+        inline ComplexCache<>& cache() {
+            if (concurrent && workerIndex > 0) {
+                return workerCaches[workerIndex - 1];
+            }
+            return complexCache;
+        }
     };
 } // namespace dd
 #endif
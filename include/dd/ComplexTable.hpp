@@ -6,12 +6,14 @@
 #ifndef DD_PACKAGE_COMPLEXTABLE_HPP
 #define DD_PACKAGE_COMPLEXTABLE_HPP
 
+#include "CompactPointer.hpp"
 #include "Definitions.hpp"
 
 #include <algorithm>
 #include <array>
 #include <cassert>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <iostream>
@@ -19,16 +21,24 @@
 #include <map>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <vector>
 
+#if defined(__AVX2__) && defined(__GNUC__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 namespace dd {
-    template<std::size_t NBUCKET = 32768, std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2, std::size_t INITIAL_GC_LIMIT = 65536>
+    template<std::size_t NBUCKET = 32768, std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2, std::size_t INITIAL_GC_LIMIT = 65536, template<class> class Allocator = DefaultChunkAllocator>
     class ComplexTable {
     public:
         struct Entry {
-            fp       value{};
-            Entry*   next{};
-            RefCount refCount{};
+            // the reference count precedes the pointer, so that it fills the gap after a single precision value
+            fp                   value{};
+            RefCount             refCount{};
+            StoredPointer<Entry> next{};
 
             ///
             /// The sign of number is encoded in the least significant bit of its entry pointer
@@ -78,17 +88,41 @@ namespace dd {
             }
 
             static void writeBinary(const Entry* e, std::ostream& os) {
-                auto temp = val(e);
+                const auto temp = static_cast<double>(val(e));
                 os.write(reinterpret_cast<const char*>(&temp), sizeof(decltype(temp)));
             }
         };
 
-        static inline Entry zero{0., nullptr, 1};
-        static inline Entry sqrt2_2{SQRT2_2, nullptr, 1};
-        static inline Entry one{1., nullptr, 1};
+        ///
+        /// Buckets store the values of their entries contiguously and in ascending order next to the (stable) entry
+        /// pointers. This way, a lookup compares several candidates with a single vector instruction instead of
+        /// chasing the pointers of a linked list.
+        ///
+        struct Bucket {
+            std::vector<fp>     values{};
+            std::vector<Entry*> entries{};
+
+            [[nodiscard]] std::size_t size() const { return values.size(); }
+            [[nodiscard]] bool        empty() const { return values.empty(); }
+        };
+
+#ifdef DD_PACKAGE_COMPACT_NODES
+        // the static entries are kept in the reserved slots of the arena, so that they can be referred to by a slot
+        static constexpr std::uint32_t ZERO_SLOT    = 1;
+        static constexpr std::uint32_t SQRT2_2_SLOT = 2;
+        static constexpr std::uint32_t ONE_SLOT     = 3;
+
+        static inline Entry& zero    = CompactArena<Entry>::emplace(ZERO_SLOT, {0., 1, nullptr});
+        static inline Entry& sqrt2_2 = CompactArena<Entry>::emplace(SQRT2_2_SLOT, {SQRT2_2, 1, nullptr});
+        static inline Entry& one     = CompactArena<Entry>::emplace(ONE_SLOT, {1., 1, nullptr});
+#else
+        static inline Entry zero{0., 1, nullptr};
+        static inline Entry sqrt2_2{SQRT2_2, 1, nullptr};
+        static inline Entry one{1., 1, nullptr};
+#endif
 
         ComplexTable():
-            chunkID(0), allocationSize(INITIAL_ALLOCATION_SIZE), gcLimit(INITIAL_GC_LIMIT) {
+            table(NBUCKET), chunkID(0), allocationSize(INITIAL_ALLOCATION_SIZE), gcLimit(INITIAL_GC_LIMIT) {
             // allocate first chunk of numbers
             chunks.emplace_back(allocationSize);
             allocations += allocationSize;
@@ -110,8 +144,31 @@ namespace dd {
             TOLERANCE = tol;
         }
 
+        // tolerance up to which looked up values are identified with the numbers in this table (and with 0, 1/sqrt(2)
+        // and 1). Unless overridden by setLookupTolerance, this is the process-wide tolerance (including later changes
+        // by setTolerance).
+        [[nodiscard]] fp getLookupTolerance() const { return std::max(TOLERANCE, lookupTolerance); }
+
+        // coarsen the lookup tolerance of this table. The static approximation functions keep using the process-wide
+        // tolerance, so a per-table tolerance may only be larger than it. It has to be smaller than the width of a
+        // bucket, since only the neighbouring buckets are searched. If the process-wide tolerance is raised above the
+        // per-table one later on, the process-wide tolerance applies.
+        void setLookupTolerance(fp tol) {
+            const auto width = static_cast<fp>(1) / static_cast<fp>(MASK);
+            if (!(tol >= TOLERANCE) || tol >= width) {
+                throw std::invalid_argument("Lookup tolerance has to be at least the process-wide tolerance and smaller than the width of a bucket.");
+            }
+            lookupTolerance = tol;
+        }
+
+        // follow the process-wide tolerance again
+        void resetLookupTolerance() { lookupTolerance = 0; }
+
         static constexpr std::size_t MASK = NBUCKET - 1;
 
+        // number of values whose buckets are prefetched together by a batch lookup
+        static constexpr std::size_t LOOKUP_BATCH = 8;
+
         // linear (clipped) hash function
         static constexpr std::size_t hash(const fp val) {
             assert(val >= 0);
@@ -126,6 +183,10 @@ namespace dd {
 
         [[nodiscard]] std::size_t getAllocations() const { return allocations; }
 
+        // amount of memory (in bytes) occupied by entries that is kept for reuse when the table is cleared
+        [[nodiscard]] std::size_t getRetainedMemory() const { return retainedMemory; }
+        void                      setRetainedMemory(std::size_t bytes) { retainedMemory = bytes; }
+
         [[nodiscard]] std::size_t getGrowthFactor() const { return GROWTH_FACTOR; }
 
         [[nodiscard]] const auto& getTable() const { return table; }
@@ -136,48 +197,48 @@ namespace dd {
             assert(!std::isnan(val));
             assert(val >= 0); // required anyway for the hash function
             ++lookups;
-            if (std::abs(val) < TOLERANCE) {
+            const fp tol = getLookupTolerance();
+            if (std::abs(val) < tol) {
                 ++hits;
                 return &zero;
             }
 
-            if (std::abs(val - 1.) < TOLERANCE) {
+            if (std::abs(val - 1.) < tol) {
                 ++hits;
                 return &one;
             }
 
-            if (std::abs(val - SQRT2_2) < TOLERANCE) {
+            if (std::abs(val - SQRT2_2) < tol) {
                 ++hits;
                 return &sqrt2_2;
             }
 
-            assert(val - TOLERANCE >= 0); // should be handle above as special case
+            assert(val - tol >= 0); // should be handle above as special case
 
-            const std::size_t lowerKey = hash(val - TOLERANCE);
-            const std::size_t upperKey = hash(val + TOLERANCE);
+            const std::size_t lowerKey = hash(val - tol);
+            const std::size_t upperKey = hash(val + tol);
 
             if (upperKey == lowerKey) {
                 ++findOrInserts;
-                return findOrInsert(lowerKey, val);
             }
 
-            // code below is to handle cases where the looked up value
-            // could be in the lower or upper buckets and we have to go through them
-
-            const std::size_t key = hash(val);
-
-            Entry* p = find(table[key], val);
-            if (p != nullptr) {
+            const std::size_t key      = hash(val);
+            std::size_t       position = 0;
+            if (Entry* p = find(table[key], val, tol, position); p != nullptr) {
                 return p;
             }
 
+            // code below is to handle cases where the looked up value
+            // could be in the lower or upper buckets and we have to go through them
+
             // search in (potentially) lower bucket
             if (lowerKey != key) {
                 ++lowerNeighbors;
                 // buckets are sorted so we only have to look into the last entry of the lower bucket
-                Entry* p_lower = tailTable[lowerKey];
-                if (p_lower != nullptr && val - p_lower->value < TOLERANCE) {
-                    return p_lower;
+                const auto& lower = table[lowerKey];
+                if (!lower.empty() && val - lower.values.back() < tol) {
+                    ++hits;
+                    return lower.entries.back();
                 }
             }
 
@@ -185,16 +246,47 @@ namespace dd {
             if (upperKey != key) {
                 ++upperNeighbors;
                 // buckets are sorted, we only have to look at the first element
-
-                Entry* p_upper = table[upperKey];
-                if (p_upper != nullptr && p_upper->value - val < TOLERANCE) {
-                    return p_upper;
+                const auto& upper = table[upperKey];
+                if (!upper.empty() && upper.values.front() - val < tol) {
+                    ++hits;
+                    return upper.entries.front();
                 }
             }
 
             // value was not found in the table -> get a new entry and add it to the central bucket
-            Entry* entry = insert(key, val);
-            return entry;
+            return insert(key, position, val);
+        }
+
+        // look up the `n` values (all non-negative) and store the corresponding entries in `entries`. Values are processed
+        // in batches: the buckets of all values in a batch are prefetched before the first one is resolved, and values
+        // occurring several times within a batch are resolved only once. The result matches individual lookups.
+        void lookup(const fp* values, Entry** entries, const std::size_t n) {
+            std::array<std::size_t, LOOKUP_BATCH> keys{};
+            for (std::size_t start = 0; start < n; start += LOOKUP_BATCH) {
+                const std::size_t size = std::min(LOOKUP_BATCH, n - start);
+                for (std::size_t i = 0; i < size; ++i) {
+                    assert(values[start + i] >= 0);
+                    keys[i] = hash(values[start + i]);
+                    prefetch(&table[keys[i]]);
+                }
+                for (std::size_t i = 0; i < size; ++i) {
+                    prefetch(table[keys[i]].values.data());
+                }
+                for (std::size_t i = 0; i < size; ++i) {
+                    const fp    val       = values[start + i];
+                    std::size_t duplicate = 0;
+                    while (duplicate < i && values[start + duplicate] != val) {
+                        ++duplicate;
+                    }
+                    if (duplicate < i) {
+                        ++lookups;
+                        ++hits;
+                        entries[start + i] = entries[start + duplicate];
+                    } else {
+                        entries[start + i] = lookup(val);
+                    }
+                }
+            }
         }
 
         [[nodiscard]] Entry* getEntry() {
@@ -207,11 +299,13 @@ namespace dd {
                 return entry;
             }
 
-            // new chunk has to be allocated
+            // new chunk has to be allocated (unless a retained one is available)
             if (chunkIt == chunkEndIt) {
-                chunks.emplace_back(allocationSize);
-                allocations += allocationSize;
-                allocationSize *= GROWTH_FACTOR;
+                if (chunkID + 1 == chunks.size()) {
+                    chunks.emplace_back(allocationSize);
+                    allocations += allocationSize;
+                    allocationSize *= GROWTH_FACTOR;
+                }
                 chunkID++;
                 chunkIt    = chunks[chunkID].begin();
                 chunkEndIt = chunks[chunkID].end();
@@ -284,66 +378,64 @@ namespace dd {
             std::size_t collected = 0;
             std::size_t remaining = 0;
             for (std::size_t key = 0; key < table.size(); ++key) {
-                Entry* p     = table[key];
-                Entry* lastp = nullptr;
-                while (p != nullptr) {
-                    if (p->refCount == 0) {
-                        Entry* next = p->next;
-                        if (lastp == nullptr) {
-                            table[key] = next;
-                        } else {
-                            lastp->next = next;
-                        }
-                        returnEntry(p);
-                        p = next;
-                        collected++;
-                    } else {
-                        lastp = p;
-                        p     = p->next;
-                        remaining++;
-                    }
-                    tailTable[key] = lastp;
-                }
+                collected += sweep(key, remaining);
             }
-            // The garbage collection limit changes dynamically depending on the number of remaining (active) nodes.
-            // If it were not changed, garbage collection would run through the complete table on each successive call
-            // once the number of remaining entries reaches the garbage collection limit. It is increased whenever the
-            // number of remaining entries is rather close to the garbage collection threshold and decreased if the
-            // number of remaining entries is much lower than the current limit.
-            if (remaining > gcLimit / 10 * 9) {
-                gcLimit = remaining + INITIAL_GC_LIMIT;
-            } else if (remaining < gcLimit / 128) {
-                gcLimit /= 2;
+            adaptGcLimit(remaining);
+            count    = remaining;
+            gcCursor = 0;
+            return collected;
+        }
+
+        // collect garbage in at most `nbuckets` buckets, continuing with the bucket the previous call stopped at.
+        // The garbage collection limit is adapted whenever all buckets have been swept.
+        std::size_t garbageCollectIncrementally(std::size_t nbuckets) {
+            gcCalls++;
+            if (count < gcLimit || count <= 1)
+                return 0;
+
+            gcRuns++;
+            std::size_t collected = 0;
+            std::size_t remaining = 0;
+            for (std::size_t i = 0; i < std::min(nbuckets, table.size()); ++i) {
+                collected += sweep(gcCursor, remaining);
+                if (++gcCursor == table.size()) {
+                    gcCursor = 0;
+                    adaptGcLimit(count - collected);
+                }
             }
-            count = remaining;
+            count -= collected;
             return collected;
         }
 
         void clear() {
             // clear table buckets
             for (auto& bucket: table) {
-                bucket = nullptr;
-            }
-            for (auto& entry: tailTable) {
-                entry = nullptr;
+                bucket.values.clear();
+                bucket.entries.clear();
             }
 
             // clear available stack
             available = nullptr;
 
-            // release memory of all but the first chunk TODO: it could be desirable to keep the memory
-            while (chunkID > 0) {
-                chunks.pop_back();
-                chunkID--;
+            // release memory of all but the first chunk, except for chunks fitting into the retained memory
+            std::size_t retained = chunks[0].size();
+            std::size_t keep     = 1;
+            while (keep < chunks.size() && (retained + chunks[keep].size()) * sizeof(Entry) <= retainedMemory) {
+                retained += chunks[keep].size();
+                ++keep;
             }
+            chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(keep), chunks.end());
             // restore initial chunk setting
+            chunkID        = 0;
             chunkIt        = chunks[0].begin();
             chunkEndIt     = chunks[0].end();
-            allocationSize = INITIAL_ALLOCATION_SIZE * GROWTH_FACTOR;
-            allocations    = INITIAL_ALLOCATION_SIZE;
+            allocationSize = chunks.back().size() * GROWTH_FACTOR;
+            allocations    = retained;
 
-            for (auto& entry: chunks[0]) {
-                entry.refCount = 0;
+            for (auto& chunk: chunks) {
+                for (auto& entry: chunk) {
+                    entry.refCount = 0;
+                }
             }
 
             count     = 0;
@@ -358,26 +450,25 @@ namespace dd {
             lowerNeighbors   = 0;
             upperNeighbors   = 0;
 
-            gcCalls = 0;
-            gcRuns  = 0;
-            gcLimit = INITIAL_GC_LIMIT;
+            gcCalls  = 0;
+            gcRuns   = 0;
+            gcLimit  = INITIAL_GC_LIMIT;
+            gcCursor = 0;
         };
 
         void print() {
             for (std::size_t key = 0; key < table.size(); ++key) {
-                auto p = table[key];
-                if (p != nullptr)
-                    std::cout << key << ": "
-                              << "\n";
+                const auto& bucket = table[key];
+                if (bucket.empty())
+                    continue;
 
-                while (p != nullptr) {
+                std::cout << key << ": "
+                          << "\n";
+                for (const auto* p: bucket.entries) {
                     std::cout << "\t\t" << p->value << " " << reinterpret_cast<std::uintptr_t>(p) << " " << p->refCount
                               << "\n";
-                    p = p->next;
                 }
-
-                if (table[key] != nullptr)
-                    std::cout << "\n";
+                std::cout << "\n";
             }
         }
 
@@ -385,7 +476,7 @@ namespace dd {
 
         [[nodiscard]] fp colRatio() const { return static_cast<fp>(collisions) / lookups; }
 
-        std::map<std::string, std::size_t> getStatistics() {
+        std::map<std::string, std::size_t> getStatistics() const {
             return {
                     {"hits", hits},
                     {"collisions", collisions},
@@ -395,8 +486,12 @@ namespace dd {
                     {"findOrInserts", findOrInserts},
                     {"upperNeighbors", upperNeighbors},
                     {"lowerNeighbors", lowerNeighbors},
+                    {"count", count},
+                    {"peakCount", peakCount},
+                    {"allocations", allocations},
                     {"gcCalls", gcCalls},
                     {"gcRuns", gcRuns},
+                    {"gcLimit", gcLimit},
             };
         }
 
@@ -420,12 +515,9 @@ namespace dd {
         }
 
     private:
-        using Bucket = Entry*;
-        using Table  = std::array<Bucket, NBUCKET>;
-
-        Table table{};
+        using Table = std::vector<Bucket>;
 
-        std::array<Entry*, NBUCKET> tailTable{};
+        Table table;
 
         // table lookup statistics
         std::size_t collisions       = 0;
@@ -437,109 +529,187 @@ namespace dd {
         std::size_t lowerNeighbors   = 0;
         std::size_t upperNeighbors   = 0;
 
-        // numerical tolerance to be used for floating point values
-        static inline fp TOLERANCE = 1e-13;
+        // numerical tolerance to be used for floating point values (single precision only resolves about 7 digits)
+        static inline fp TOLERANCE = std::is_same_v<fp, float> ? static_cast<fp>(1e-6) : static_cast<fp>(1e-13);
+        // tolerance of lookups in this table (0 to follow the process-wide tolerance)
+        fp lookupTolerance = 0;
 
-        Entry*                                available{};
-        std::vector<std::vector<Entry>>       chunks{};
-        std::size_t                           chunkID;
-        typename std::vector<Entry>::iterator chunkIt;
-        typename std::vector<Entry>::iterator chunkEndIt;
-        std::size_t                           allocationSize;
+        using Chunk = std::vector<Entry, Allocator<Entry>>;
+        Entry*                   available{};
+        std::vector<Chunk>       chunks{};
+        std::size_t              chunkID;
+        typename Chunk::iterator chunkIt;
+        typename Chunk::iterator chunkEndIt;
+        std::size_t              allocationSize;
 
-        std::size_t allocations = 0;
-        std::size_t count       = 0;
-        std::size_t peakCount   = 0;
+        std::size_t allocations    = 0;
+        std::size_t count          = 0;
+        std::size_t peakCount      = 0;
+        std::size_t retainedMemory = 0;
 
         // garbage collection
         std::size_t gcCalls = 0;
         std::size_t gcRuns  = 0;
         std::size_t gcLimit = 100000;
-
-        inline Entry* findOrInsert(const std::size_t key, const fp val) {
-            [[maybe_unused]] const fp val_tol = val + TOLERANCE;
-
-            Entry* curr = table[key];
-            Entry* prev = nullptr;
-
-            while (curr != nullptr && val_tol > curr->value) {
-                if (std::abs(curr->value - val) < TOLERANCE) {
-                    ++hits;
-                    return curr;
-                }
-                ++collisions;
-                prev = curr;
-                curr = curr->next;
+        // bucket at which the next incremental garbage collection starts
+        std::size_t gcCursor = 0;
+
+        // The garbage collection limit changes dynamically depending on the number of remaining (active) nodes.
+        // If it were not changed, garbage collection would run through the complete table on each successive call
+        // once the number of remaining entries reaches the garbage collection limit. It is increased whenever the
+        // number of remaining entries is rather close to the garbage collection threshold and decreased if the
+        // number of remaining entries is much lower than the current limit.
+        void adaptGcLimit(std::size_t remaining) {
+            if (remaining > gcLimit / 10 * 9) {
+                gcLimit = remaining + INITIAL_GC_LIMIT;
+            } else if (remaining < gcLimit / 128) {
+                gcLimit /= 2;
             }
+        }
 
-            ++inserts;
-            Entry* entry = getEntry();
-            entry->value = val;
-
-            if (prev == nullptr) {
-                // table bucket is empty
-                table[key] = entry;
-            } else {
-                prev->next = entry;
-            }
-            entry->next = curr;
-            if (curr == nullptr) {
-                tailTable[key] = entry;
-            }
-            count++;
-            peakCount = std::max(peakCount, count);
-            return entry;
+        // remove all unreferenced entries from a bucket. Returns the number of removed entries.
+        std::size_t sweep(std::size_t key, std::size_t& remaining) {
+            auto&       bucket = table[key];
+            std::size_t kept   = 0;
+            for (std::size_t i = 0; i < bucket.size(); ++i) {
+                Entry* p = bucket.entries[i];
+                if (p->refCount == 0) {
+                    returnEntry(p);
+                    continue;
+                }
+                bucket.values[kept]  = bucket.values[i];
+                bucket.entries[kept] = p;
+                ++kept;
+            }
+            const std::size_t collected = bucket.size() - kept;
+            bucket.values.resize(kept);
+            bucket.entries.resize(kept);
+            remaining += kept;
+            return collected;
         }
 
         /**
-         * Inserts a value into the bucket indexed by key. This function assumes no element within TOLERANCE is
+         * Inserts a value into the bucket indexed by key. This function assumes no element within the tolerance is
          * present in the bucket.
          * @param key index to the bucket
+         * @param position index within the bucket that keeps the bucket sorted (as determined by find)
          * @param val value to be inserted
          * @return pointer to the inserted entry
          */
-        inline Entry* insert(const std::size_t key, const fp val) {
+        inline Entry* insert(const std::size_t key, const std::size_t position, const fp val) {
             ++inserts;
             Entry* entry = getEntry();
             entry->value = val;
 
-            Entry* curr = table[key];
-            Entry* prev = nullptr;
+            auto&      bucket = table[key];
+            const auto offset = static_cast<std::ptrdiff_t>(position);
+            insertCollisions += bucket.size() - position;
+            bucket.values.insert(bucket.values.begin() + offset, val);
+            bucket.entries.insert(bucket.entries.begin() + offset, entry);
 
-            while (curr != nullptr && val < curr->value) {
-                ++insertCollisions;
-                prev = curr;
-                curr = curr->next;
-            }
-
-            if (prev == nullptr) {
-                // table bucket is empty
-                table[key] = entry;
-            } else {
-                prev->next = entry;
-            }
-            entry->next = curr;
-            if (curr == nullptr) {
-                tailTable[key] = entry;
-            }
             count++;
             peakCount = std::max(peakCount, count);
             return entry;
         }
 
-        inline Entry* find(const Bucket& bucket, const fp& val) {
-            Entry*   p       = bucket;
-            const fp val_tol = val - TOLERANCE;
-            while (p != nullptr && val_tol <= p->value) {
-                if (p->value - val < TOLERANCE) {
-                    ++hits;
-                    return p;
+        /**
+         * Searches a bucket for a value within tol of val. Candidates are compared in blocks of SIMD width
+         * and the search stops at the first block containing values above the tolerance window.
+         * @param bucket bucket to search
+         * @param val value to search for
+         * @param tol lookup tolerance
+         * @param position set to the index at which val has to be inserted if it is not found
+         * @return pointer to the matching entry or nullptr if the bucket does not contain the value
+         */
+        inline Entry* find(const Bucket& bucket, const fp val, const fp tol, std::size_t& position) {
+            const fp*         values = bucket.values.data();
+            const std::size_t size   = bucket.size();
+            const fp          lower  = val - tol;
+            const fp          upper  = val + tol;
+
+            std::size_t i = 0;
+#if defined(__AVX2__) && defined(__GNUC__) && defined(DD_PACKAGE_SINGLE_PRECISION)
+            const __m256 lowerBound = _mm256_set1_ps(lower);
+            const __m256 upperBound = _mm256_set1_ps(upper);
+            for (; i + 8 <= size; i += 8) {
+                const __m256 candidates = _mm256_loadu_ps(values + i);
+                const __m256 belowUpper = _mm256_cmp_ps(candidates, upperBound, _CMP_LT_OQ);
+                const auto   matches    = _mm256_movemask_ps(_mm256_and_ps(_mm256_cmp_ps(candidates, lowerBound, _CMP_GT_OQ), belowUpper));
+                if (matches != 0) {
+                    return hit(bucket, i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(matches))));
+                }
+                if (values[i + 7] >= upper) {
+                    // without a match, exactly the values below the tolerance window precede val
+                    position = i + static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(_mm256_movemask_ps(belowUpper))));
+                    collisions += position;
+                    return nullptr;
+                }
+            }
+#elif defined(__AVX2__) && defined(__GNUC__)
+            const __m256d lowerBound = _mm256_set1_pd(lower);
+            const __m256d upperBound = _mm256_set1_pd(upper);
+            for (; i + 4 <= size; i += 4) {
+                const __m256d candidates = _mm256_loadu_pd(values + i);
+                const __m256d belowUpper = _mm256_cmp_pd(candidates, upperBound, _CMP_LT_OQ);
+                const auto    matches    = _mm256_movemask_pd(_mm256_and_pd(_mm256_cmp_pd(candidates, lowerBound, _CMP_GT_OQ), belowUpper));
+                if (matches != 0) {
+                    return hit(bucket, i + static_cast<std::size_t>(__builtin_ctz(static_cast<unsigned>(matches))));
+                }
+                if (values[i + 3] >= upper) {
+                    // without a match, exactly the values below the tolerance window precede val
+                    position = i + static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(_mm256_movemask_pd(belowUpper))));
+                    collisions += position;
+                    return nullptr;
                 }
-                ++collisions;
-                p = p->next;
             }
+#elif defined(__ARM_NEON) && defined(__aarch64__) && defined(DD_PACKAGE_SINGLE_PRECISION)
+            const float32x4_t lowerBound = vdupq_n_f32(lower);
+            const float32x4_t upperBound = vdupq_n_f32(upper);
+            for (; i + 4 <= size; i += 4) {
+                const float32x4_t candidates = vld1q_f32(values + i);
+                const uint32x4_t  matches    = vandq_u32(vcgtq_f32(candidates, lowerBound), vcltq_f32(candidates, upperBound));
+                if (vmaxvq_u32(matches) != 0) {
+                    break; // resolved by the scalar loop below
+                }
+                if (values[i + 3] >= upper) {
+                    break;
+                }
+            }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+            const float64x2_t lowerBound = vdupq_n_f64(lower);
+            const float64x2_t upperBound = vdupq_n_f64(upper);
+            for (; i + 2 <= size; i += 2) {
+                const float64x2_t candidates = vld1q_f64(values + i);
+                const uint64x2_t  matches    = vandq_u64(vcgtq_f64(candidates, lowerBound), vcltq_f64(candidates, upperBound));
+                if (vgetq_lane_u64(matches, 0) != 0) {
+                    return hit(bucket, i);
+                }
+                if (vgetq_lane_u64(matches, 1) != 0) {
+                    return hit(bucket, i + 1);
+                }
+                if (values[i + 1] >= upper) {
+                    break;
+                }
+            }
+#endif
+            for (; i < size; ++i) {
+                if (values[i] >= upper) {
+                    break;
+                }
+                if (values[i] > lower) {
+                    return hit(bucket, i);
+                }
+            }
+            position = i;
+            collisions += position;
             return nullptr;
         }
+
+        inline Entry* hit(const Bucket& bucket, const std::size_t index) {
+            ++hits;
+            collisions += index;
+            return bucket.entries[index];
+        }
     };
 } // namespace dd
 #endif //DD_PACKAGE_COMPLEXTABLE_HPP
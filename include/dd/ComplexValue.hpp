@@ -46,14 +46,19 @@ namespace dd {
             return !operator==(other);
         }
 
+        // binary representations use double precision, independent of fp
         void readBinary(std::istream& is) {
-            is.read(reinterpret_cast<char*>(&r), sizeof(decltype(r)));
-            is.read(reinterpret_cast<char*>(&i), sizeof(decltype(i)));
+            SerializedWeight w{};
+            is.read(reinterpret_cast<char*>(&w.r), sizeof(decltype(w.r)));
+            is.read(reinterpret_cast<char*>(&w.i), sizeof(decltype(w.i)));
+            r = static_cast<fp>(w.r);
+            i = static_cast<fp>(w.i);
         }
 
         void writeBinary(std::ostream& os) const {
-            os.write(reinterpret_cast<const char*>(&r), sizeof(decltype(r)));
-            os.write(reinterpret_cast<const char*>(&i), sizeof(decltype(i)));
+            const SerializedWeight w{r, i};
+            os.write(reinterpret_cast<const char*>(&w.r), sizeof(decltype(w.r)));
+            os.write(reinterpret_cast<const char*>(&w.i), sizeof(decltype(w.i)));
         }
 
         void from_string(const std::string& real_str, std::string imag_str) {
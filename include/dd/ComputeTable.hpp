@@ -8,22 +8,116 @@
 
 #include "Definitions.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cassert>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace dd {
 
+    /// Storage for a compute table entry that may be read and written by multiple threads at the same time (seqlock)
+    /// The entry is stored as a sequence of words that are accessed atomically. A writer marks the entry as being
+    /// modified by making its version odd. Readers observing an odd or changed version treat the entry as invalid.
+    /// Concurrent writers do not wait for each other, but drop their update instead.
+    /// \tparam T type of the stored entry (has to be trivially copyable)
+    template<class T>
+    class VersionedEntry {
+        static_assert(std::is_trivially_copyable_v<T>, "Entries of compute tables have to be trivially copyable");
+        using Word                         = std::uint64_t;
+        static constexpr std::size_t WORDS = (sizeof(T) + sizeof(Word) - 1) / sizeof(Word);
+
+    public:
+        // access without synchronization (only to be used while no other thread accesses the entry)
+        [[nodiscard]] T load() const {
+            std::array<Word, WORDS> buffer{};
+            for (std::size_t i = 0; i < WORDS; ++i) {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            T value;
+            std::memcpy(static_cast<void*>(&value), buffer.data(), sizeof(T));
+            return value;
+        }
+
+        void store(const T& value) {
+            std::array<Word, WORDS> buffer{};
+            std::memcpy(buffer.data(), &value, sizeof(T));
+            for (std::size_t i = 0; i < WORDS; ++i) {
+                words[i].store(buffer[i], std::memory_order_relaxed);
+            }
+        }
+
+        // read the entry; returns false if it was modified while being read
+        [[nodiscard]] bool tryLoad(T& value) const {
+            const auto before = version.load(std::memory_order_acquire);
+            if (before & 1U) {
+                return false;
+            }
+            value = load();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            return version.load(std::memory_order_relaxed) == before;
+        }
+
+        // write the entry; returns false if another thread is writing it at the same time
+        bool tryStore(const T& value) {
+            auto current = version.load(std::memory_order_relaxed);
+            if ((current & 1U) || !version.compare_exchange_strong(current, current + 1, std::memory_order_relaxed)) {
+                return false;
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            store(value);
+            version.store(current + 2, std::memory_order_release);
+            return true;
+        }
+
+    private:
+        std::atomic<std::size_t>             version{0};
+        std::array<std::atomic<Word>, WORDS> words{};
+    };
+
+    /// Rule by which an insertion into a set of a set-associative compute table selects the bucket to replace
+    enum class ComputeTableReplacement {
+        // the first bucket that has not been used since the age bits of the set were reset
+        Age,
+        // the bucket holding the result of the shallowest recursion, i.e., whose left operand has the lowest variable
+        // index. This keeps the results that are the most expensive to recompute. Ties are broken by age.
+        Depth
+    };
+
     /// Data structure for caching computed results
+    /// The table can be switched to a concurrent mode (see enableConcurrency), in which multiple threads may
+    /// simultaneously look up and insert results. Entries that are modified while being read are treated as misses and
+    /// insertions colliding with another insertion are dropped. Statistics are kept per thread (see dd::workerIndex).
+    /// With WAYS > 1, the table is set-associative: a result may be stored in any of the WAYS adjacent buckets of the
+    /// set it hashes to. Every set keeps one age bit per bucket, which is set whenever the bucket is used. A new result
+    /// replaces the first bucket of its set that has not been used since the last time all age bits were set, or, with
+    /// ComputeTableReplacement::Depth, the bucket holding the result of the shallowest recursion. A result for operands
+    /// that are already stored in the set replaces their previous result.
     /// \tparam LeftOperandType type of the operation's left operand
     /// \tparam RightOperandType type of the operation's right operand
     /// \tparam ResultType type of the operation's result
-    /// \tparam NBUCKET number of hash buckets to use (has to be a power of two)
-    template<class LeftOperandType, class RightOperandType, class ResultType, std::size_t NBUCKET = 16384>
+    /// \tparam NBUCKET default number of hash buckets to use (has to be a power of two)
+    /// \tparam WAYS number of buckets per set (has to be a power of two of at most 8)
+    /// \tparam REPLACEMENT rule by which the bucket to replace is selected (only relevant if WAYS > 1)
+    template<class LeftOperandType, class RightOperandType, class ResultType, std::size_t NBUCKET = 16384, std::size_t WAYS = 1, ComputeTableReplacement REPLACEMENT = ComputeTableReplacement::Age>
     class ComputeTable {
+        static_assert(WAYS > 0 && WAYS <= 8 && (WAYS & (WAYS - 1)) == 0, "Number of ways has to be a power of two of at most 8");
+
     public:
-        ComputeTable() = default;
+        explicit ComputeTable(std::size_t nbuckets = NBUCKET) {
+            resize(nbuckets);
+        }
 
         struct Entry {
             LeftOperandType  leftOperand;
@@ -31,59 +125,258 @@ namespace dd {
             ResultType       result;
         };
 
-        static constexpr std::size_t MASK = NBUCKET - 1;
-
-        static std::size_t hash(const LeftOperandType& leftOperand, const RightOperandType& rightOperand) {
+        [[nodiscard]] std::size_t hash(const LeftOperandType& leftOperand, const RightOperandType& rightOperand) const {
             const auto h1   = std::hash<LeftOperandType>{}(leftOperand);
             const auto h2   = std::hash<RightOperandType>{}(rightOperand);
             const auto hash = dd::combineHash(h1, h2);
-            return hash & MASK;
+            return hash & mask;
         }
 
+        // index of the first bucket of the set a key belongs to
+        [[nodiscard]] std::size_t firstBucket(std::size_t key) const { return key * WAYS; }
+
         // access functions
-        [[nodiscard]] const auto& getTable() const { return table; }
+        [[nodiscard]] Entry getEntry(std::size_t key) const { return table[key].load(); }
+
+        [[nodiscard]] std::size_t getBuckets() const { return table.size(); }
+        [[nodiscard]] static constexpr std::size_t getWays() { return WAYS; }
+        [[nodiscard]] static constexpr ComputeTableReplacement getReplacement() { return REPLACEMENT; }
+
+        [[nodiscard]] bool isConcurrent() const { return concurrent; }
+
+        // change the number of buckets (has to be a power of two and at least WAYS). Valid entries are rehashed into the new table and
+        // their number is returned.
+        std::size_t resize(std::size_t nbuckets) {
+            assert(!concurrent);
+            if (nbuckets < WAYS || (nbuckets & (nbuckets - 1)) != 0) {
+                throw std::invalid_argument("Number of compute table buckets has to be a power of two of at least " + std::to_string(WAYS) + ", but is " + std::to_string(nbuckets) + ".");
+            }
+            auto old       = std::move(table);
+            auto oldLevels = std::move(levels);
+            table          = std::vector<VersionedEntry<Entry>>(nbuckets);
+            mask           = nbuckets / WAYS - 1;
+            if constexpr (WAYS > 1) {
+                age = std::vector<std::atomic<std::uint8_t>>(nbuckets / WAYS);
+            }
+            if constexpr (WAYS > 1 && REPLACEMENT == ComputeTableReplacement::Depth) {
+                levels = std::vector<std::atomic<Qubit>>(nbuckets);
+                for (auto& level: levels) {
+                    level.store(EMPTY_LEVEL, std::memory_order_relaxed);
+                }
+            }
+            std::size_t rehashed = 0;
+            for (std::size_t i = 0; i < old.size(); ++i) {
+                const auto entry = old[i].load();
+                if (entry.result.p != nullptr) {
+                    // the operands may refer to nodes that are about to be collected, so their levels are not read again
+                    const auto key = hash(entry.leftOperand, entry.rightOperand);
+                    const auto way = victim(key);
+                    table[firstBucket(key) + way].store(entry);
+                    touch(key, way);
+                    if (!oldLevels.empty()) {
+                        levels[firstBucket(key) + way].store(oldLevels[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+                    }
+                    ++rehashed;
+                }
+            }
+            return rehashed;
+        }
+
+        // double the number of buckets if the table has been used heavily, i.e., if at least `fillFactor` times as many
+        // results as there are buckets have been inserted, while the hit ratio stayed below `maxHitRatio`.
+        // Statistics are reset after resizing, except that the rehashed entries are counted, so that clear() still wipes
+        // them. Returns whether the table has been resized.
+        bool growIfThrashing(fp maxHitRatio, fp fillFactor, std::size_t maxBuckets) {
+            const auto buckets = getBuckets();
+            if (buckets >= maxBuckets || getLookups() == 0) {
+                return false;
+            }
+            if (static_cast<fp>(getCount()) < fillFactor * static_cast<fp>(buckets) || hitRatio() >= maxHitRatio) {
+                return false;
+            }
+            const auto rehashed = resize(2 * buckets);
+            std::fill(stats.begin(), stats.end(), Statistics{});
+            stats[0].count = rehashed;
+            return true;
+        }
+
+        // prepare the table for being accessed by `nthreads` threads at the same time
+        void enableConcurrency(std::size_t nthreads) {
+            if (stats.size() < nthreads) {
+                stats.resize(nthreads);
+            }
+            concurrent = true;
+        }
+        void disableConcurrency() { concurrent = false; }
 
         void insert(const LeftOperandType& leftOperand, const RightOperandType& rightOperand, const ResultType& result) {
-            const auto key = hash(leftOperand, rightOperand);
-            table[key]     = {leftOperand, rightOperand, result};
-            ++count;
+            const auto key  = hash(leftOperand, rightOperand);
+            const auto way  = insertionWay(key, leftOperand, rightOperand);
+            auto&      slot = table[firstBucket(key) + way];
+            if (concurrent) {
+                if (slot.tryStore({leftOperand, rightOperand, result})) {
+                    touch(key, way);
+                    setLevel(key, way, leftOperand);
+                    ++stats[workerIndex].count;
+                }
+                return;
+            }
+            slot.store({leftOperand, rightOperand, result});
+            touch(key, way);
+            setLevel(key, way, leftOperand);
+            ++stats[0].count;
         }
 
         ResultType lookup(const LeftOperandType& leftOperand, const RightOperandType& rightOperand) {
             ResultType result{};
-            lookups++;
+            auto&      statistics = stats[concurrent ? workerIndex : 0];
+            statistics.lookups++;
             const auto key   = hash(leftOperand, rightOperand);
-            auto&      entry = table[key];
-            if (entry.result.p == nullptr) return result;
-            if (entry.leftOperand != leftOperand) return result;
-            if (entry.rightOperand != rightOperand) return result;
+            const auto first = firstBucket(key);
+            for (std::size_t way = 0; way < WAYS; ++way) {
+                Entry entry{};
+                if (concurrent) {
+                    if (!table[first + way].tryLoad(entry)) continue;
+                } else {
+                    entry = table[first + way].load();
+                }
+                if (entry.result.p == nullptr) continue;
+                if (entry.leftOperand != leftOperand) continue;
+                if (entry.rightOperand != rightOperand) continue;
 
-            hits++;
-            return entry.result;
+                touch(key, way);
+                statistics.hits++;
+                return entry.result;
+            }
+            return result;
         }
 
         void clear() {
-            if (count > 0) {
+            if (getCount() > 0) {
                 for (auto& entry: table)
-                    entry.result.p = nullptr;
-                count = 0;
+                    entry.store(Entry{});
+                for (auto& bits: age)
+                    bits.store(0, std::memory_order_relaxed);
+                for (auto& level: levels)
+                    level.store(EMPTY_LEVEL, std::memory_order_relaxed);
             }
-            hits    = 0;
-            lookups = 0;
+            std::fill(stats.begin(), stats.end(), Statistics{});
         }
 
-        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(hits) / lookups; }
-        std::ostream&    printStatistics(std::ostream& os = std::cout) {
-            os << "hits: " << hits << ", looks: " << lookups << ", ratio: " << hitRatio() << std::endl;
+        [[nodiscard]] std::size_t getHits() const {
+            return std::accumulate(stats.begin(), stats.end(), std::size_t{0}, [](auto sum, const auto& s) { return sum + s.hits; });
+        }
+        [[nodiscard]] std::size_t getLookups() const {
+            return std::accumulate(stats.begin(), stats.end(), std::size_t{0}, [](auto sum, const auto& s) { return sum + s.lookups; });
+        }
+        [[nodiscard]] std::size_t getCount() const {
+            return std::accumulate(stats.begin(), stats.end(), std::size_t{0}, [](auto sum, const auto& s) { return sum + s.count; });
+        }
+
+        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(getHits()) / getLookups(); }
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"hits", getHits()},
+                    {"lookups", getLookups()},
+                    {"count", getCount()},
+            };
+        }
+
+        std::ostream& printStatistics(std::ostream& os = std::cout) {
+            os << "hits: " << getHits() << ", looks: " << getLookups() << ", ratio: " << hitRatio() << std::endl;
             return os;
         }
 
     private:
-        std::array<Entry, NBUCKET> table{};
-        // compute table lookup statistics
-        std::size_t hits    = 0;
-        std::size_t lookups = 0;
-        std::size_t count   = 0;
+        std::vector<VersionedEntry<Entry>> table{};
+        std::size_t                        mask = 0;
+
+        // age bits of the buckets of each set (only used for set-associative tables)
+        // concurrent updates are not synchronized, since losing one merely affects the choice of the next victim
+        std::vector<std::atomic<std::uint8_t>> age{};
+        static constexpr std::uint8_t          ALL_USED = static_cast<std::uint8_t>((1U << WAYS) - 1U);
+
+        // variable index of the left operand of the result in each bucket (only used for the depth replacement)
+        std::vector<std::atomic<Qubit>> levels{};
+        static constexpr Qubit          EMPTY_LEVEL = std::numeric_limits<Qubit>::min();
+
+        // bucket of a set to be replaced by the next insertion
+        [[nodiscard]] std::size_t victim([[maybe_unused]] std::size_t key) const {
+            if constexpr (WAYS == 1) {
+                return 0;
+            } else {
+                const auto bits = age[key].load(std::memory_order_relaxed);
+                if constexpr (REPLACEMENT == ComputeTableReplacement::Depth) {
+                    // the shallowest result (empty buckets first), preferring buckets that have not been used recently
+                    const auto  first  = firstBucket(key);
+                    std::size_t chosen = 0;
+                    auto        lowest = levels[first].load(std::memory_order_relaxed);
+                    for (std::size_t way = 1; way < WAYS; ++way) {
+                        const auto level = levels[first + way].load(std::memory_order_relaxed);
+                        if (level < lowest || (level == lowest && (bits & (1U << chosen)) != 0 && (bits & (1U << way)) == 0)) {
+                            chosen = way;
+                            lowest = level;
+                        }
+                    }
+                    return chosen;
+                } else {
+                    for (std::size_t way = 0; way < WAYS; ++way) {
+                        if ((bits & (1U << way)) == 0) {
+                            return way;
+                        }
+                    }
+                    return 0;
+                }
+            }
+        }
+
+        // bucket of a set an insertion writes to. Operands that are already stored keep their bucket, so that they do
+        // not occupy several buckets of the set.
+        [[nodiscard]] std::size_t insertionWay(std::size_t key, [[maybe_unused]] const LeftOperandType& leftOperand, [[maybe_unused]] const RightOperandType& rightOperand) const {
+            if constexpr (WAYS > 1) {
+                const auto first = firstBucket(key);
+                for (std::size_t way = 0; way < WAYS; ++way) {
+                    Entry entry{};
+                    if (concurrent) {
+                        if (!table[first + way].tryLoad(entry)) continue;
+                    } else {
+                        entry = table[first + way].load();
+                    }
+                    if (entry.result.p != nullptr && entry.leftOperand == leftOperand && entry.rightOperand == rightOperand) {
+                        return way;
+                    }
+                }
+            }
+            return victim(key);
+        }
+
+        void setLevel([[maybe_unused]] std::size_t key, [[maybe_unused]] std::size_t way, [[maybe_unused]] const LeftOperandType& leftOperand) {
+            if constexpr (WAYS > 1 && REPLACEMENT == ComputeTableReplacement::Depth) {
+                levels[firstBucket(key) + way].store(leftOperand.p == nullptr ? Qubit{-1} : leftOperand.p->v, std::memory_order_relaxed);
+            }
+        }
+
+        // mark a bucket as recently used. Once all buckets of the set have been used, only the current one remains marked.
+        void touch([[maybe_unused]] std::size_t key, [[maybe_unused]] std::size_t way) {
+            if constexpr (WAYS > 1) {
+                auto bits = static_cast<std::uint8_t>(age[key].load(std::memory_order_relaxed) | (1U << way));
+                if (bits == ALL_USED) {
+                    bits = static_cast<std::uint8_t>(1U << way);
+                }
+                age[key].store(bits, std::memory_order_relaxed);
+            }
+        }
+
+        // compute table lookup statistics (one set per thread)
+        struct alignas(64) Statistics {
+            std::size_t hits    = 0;
+            std::size_t lookups = 0;
+            std::size_t count   = 0;
+        };
+        std::vector<Statistics> stats = std::vector<Statistics>(1);
+
+        bool concurrent = false;
     };
 } // namespace dd
 
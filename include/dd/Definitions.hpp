@@ -6,7 +6,9 @@
 #ifndef DDpackage_DATATYPES_HPP
 #define DDpackage_DATATYPES_HPP
 
+#include <array>
 #include <complex>
+#include <cstddef>
 #include <cstdint>
 #include <type_traits>
 #include <utility>
@@ -24,11 +26,18 @@ namespace dd {
 
     // integer type used for reference counting
     // 32bit suffice for a max ref count of around 4 billion
-    using RefCount = std::uint_fast32_t;
+    // (std::uint_fast32_t would occupy 64bit on common platforms, which does not let a vNode fit into a cache line)
+    using RefCount = std::uint32_t;
     static_assert(std::is_unsigned_v<RefCount>, "RefCount should be unsigned.");
 
     // floating point type to use
+    // defining DD_PACKAGE_SINGLE_PRECISION (CMake option of the same name) selects float, which halves the size of
+    // complex table entries and edge weights at the cost of precision (see ComplexTable::tolerance)
+#ifdef DD_PACKAGE_SINGLE_PRECISION
+    using fp = float;
+#else
     using fp = double;
+#endif
     static_assert(std::is_floating_point_v<fp>, "fp should be a floating point type (float, *double*, long double)");
 
     // logic radix
@@ -53,7 +62,55 @@ namespace dd {
     using CVec = std::vector<std::complex<dd::fp>>;
     using CMat = std::vector<CVec>;
 
-    static constexpr std::uint_least64_t SERIALIZATION_VERSION = 1;
+    // edge weights are stored in double precision in all binary formats, so that files do not depend on fp
+    struct SerializedWeight {
+        double r;
+        double i;
+    };
+
+    static constexpr std::uint_least64_t SERIALIZATION_VERSION = 2;
+
+    // binary serialization (version 2): a header, followed by the table of distinct edge weights (pairs of real and
+    // imaginary part) and the node records in topological order, i.e., successors precede their predecessors
+    struct SerializationHeader {
+        std::uint64_t version;
+        std::uint64_t nodes;      // number of node records, the last one being the root node
+        std::uint64_t weights;    // number of entries of the weight table
+        std::uint64_t rootWeight; // index of the root edge's weight in the weight table
+    };
+    template<std::size_t N>
+    struct SerializedNode {
+        std::array<std::int64_t, N>  children; // indices of the successors' records (-1 for the terminal)
+        std::array<std::uint64_t, N> weights;  // indices of the edge weights in the weight table
+        std::int64_t                 v;
+    };
+
+    static constexpr std::uint_least64_t CHECKPOINT_VERSION = 1;
+
+    // package checkpoint: a header, followed by the table of distinct edge weights, the records of the vector nodes and of
+    // the matrix nodes (each in topological order) and the root edges of the vector and matrix DDs
+    struct CheckpointHeader {
+        std::uint64_t version;
+        std::uint64_t weights;
+        std::uint64_t vectorNodes;
+        std::uint64_t matrixNodes;
+        std::uint64_t vectorRoots;
+        std::uint64_t matrixRoots;
+    };
+    template<std::size_t N>
+    struct CheckpointNode {
+        SerializedNode<N> node;
+        std::uint64_t     flags; // bit 0: node is symmetric, bit 1: node resembles identity (matrix nodes only)
+    };
+    struct CheckpointRoot {
+        std::int64_t  node;   // index of the root node's record (-1 for the terminal)
+        std::uint64_t weight; // index of the root edge's weight in the weight table
+    };
+
+    // index of the worker thread currently operating on a package (0 for the thread driving the package)
+    // threads that concurrently access a package set this to a unique index, so that thread-local
+    // resources (e.g., free lists of nodes) can be selected without synchronization
+    inline thread_local std::size_t workerIndex = 0;
 
     // 64bit mixing hash (from MurmurHash3, https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp)
     constexpr std::size_t murmur64(std::size_t k) {
@@ -82,5 +139,12 @@ namespace dd {
     //        return b;
     //    }
 
+    // hint the processor to load the cache line containing `p` (this is a no-op for compilers offering no such hint)
+    inline void prefetch([[maybe_unused]] const void* p) {
+#if defined(__GNUC__)
+        __builtin_prefetch(p);
+#endif
+    }
+
 } // namespace dd
 #endif //DDpackage_DATATYPES_HPP
@@ -6,6 +6,7 @@
 #ifndef DD_PACKAGE_EDGE_HPP
 #define DD_PACKAGE_EDGE_HPP
 
+#include "CompactPointer.hpp"
 #include "Complex.hpp"
 #include "ComplexValue.hpp"
 
@@ -15,8 +16,8 @@
 namespace dd {
     template<class Node>
     struct Edge {
-        Node*   p;
-        Complex w;
+        StoredPointer<Node> p;
+        Complex             w;
 
         /// Comparing two DD edges with another involves comparing the respective pointers
         /// and checking whether the corresponding weights are "close enough" according to a given tolerance
@@ -63,13 +64,27 @@ namespace dd {
             return !operator==(other);
         }
     };
+
+    // pair of nodes (e.g., the bra and the ket of an expectation value, see Package::expectationValue)
+    template<class Node>
+    struct NodePair {
+        Node* first;
+        Node* second;
+
+        bool operator==(const NodePair& other) const {
+            return first == other.first && second == other.second;
+        }
+        bool operator!=(const NodePair& other) const {
+            return !operator==(other);
+        }
+    };
 } // namespace dd
 
 namespace std {
     template<class Node>
     struct hash<dd::Edge<Node>> {
         std::size_t operator()(dd::Edge<Node> const& e) const noexcept {
-            auto h1 = dd::murmur64(reinterpret_cast<std::size_t>(e.p));
+            auto h1 = dd::murmur64(dd::pointerBits(e.p));
             auto h2 = std::hash<dd::Complex>{}(e.w);
             return dd::combineHash(h1, h2);
         }
@@ -78,11 +93,20 @@ namespace std {
     template<class Node>
     struct hash<dd::CachedEdge<Node>> {
         std::size_t operator()(dd::CachedEdge<Node> const& e) const noexcept {
-            auto h1 = dd::murmur64(reinterpret_cast<std::size_t>(e.p));
+            auto h1 = dd::murmur64(dd::pointerBits(e.p));
             auto h2 = std::hash<dd::ComplexValue>{}(e.w);
             return dd::combineHash(h1, h2);
         }
     };
+
+    template<class Node>
+    struct hash<dd::NodePair<Node>> {
+        std::size_t operator()(dd::NodePair<Node> const& pair) const noexcept {
+            auto h1 = dd::murmur64(reinterpret_cast<std::size_t>(pair.first));
+            auto h2 = dd::murmur64(reinterpret_cast<std::size_t>(pair.second));
+            return dd::combineHash(h1, h2);
+        }
+    };
 } // namespace std
 
 #endif //DD_PACKAGE_EDGE_HPP
@@ -10,10 +10,13 @@
 #include "ComplexNumbers.hpp"
 #include "Definitions.hpp"
 #include "Edge.hpp"
+#include "NodeMap.hpp"
 #include "Package.hpp"
+#include "VisitedNodes.hpp"
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <fstream>
@@ -23,8 +26,8 @@
 #include <stack>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace dd {
@@ -40,7 +43,7 @@ namespace dd {
         return oss.str();
     }
     inline fp thicknessFromMagnitude(const Complex& a) {
-        return 3.0 * std::max(dd::ComplexNumbers::mag(a), 0.10);
+        return static_cast<fp>(3.0) * std::max(dd::ComplexNumbers::mag(a), static_cast<fp>(0.10));
     }
 
     template<class Edge>
@@ -48,7 +51,7 @@ namespace dd {
         os << "digraph \"DD\" {graph[];node[shape=plain];edge[arrowhead=none]\n";
         os << "root [label=\"\",shape=point,style=invis]\n";
         os << "t [label=<<font point-size=\"20\">1</font>>,shape=box,tooltip=\"1\",width=0.3,height=0.3]\n";
-        auto toplabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U;
+        auto toplabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U;
         auto mag      = thicknessFromMagnitude(e.w);
         os << "root->";
         if (e.isTerminal()) {
@@ -74,7 +77,7 @@ namespace dd {
         os << "root [label=\"\",shape=point,style=invis]\n";
         os << "t [label=<<font point-size=\"20\">1</font>>,shape=box,tooltip=\"1\",width=0.3,height=0.3]\n";
 
-        auto toplabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U;
+        auto toplabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U;
         auto mag      = thicknessFromMagnitude(e.w);
         auto color    = colorFromPhase(e.w);
         os << "root->";
@@ -96,7 +99,7 @@ namespace dd {
         os << "root [label=\"\",shape=point,style=invis]\n";
         os << "t [label=<<font point-size=\"20\">1</font>>,shape=box,tooltip=\"1\",width=0.3,height=0.3]\n";
 
-        auto toplabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U;
+        auto toplabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U;
         auto mag      = thicknessFromMagnitude(e.w);
         auto color    = colorFromPhase(e.w);
         os << "root->";
@@ -120,7 +123,7 @@ namespace dd {
                 } else if (e.w.r == &ComplexTable<>::one) {
                     os << "1";
                 } else {
-                    os << std::hex << reinterpret_cast<std::uintptr_t>(e.w.r) << std::dec;
+                    os << std::hex << reinterpret_cast<std::uintptr_t>(toPointer(e.w.r)) << std::dec;
                 }
                 os << " ";
                 if (e.w.i == &ComplexTable<>::zero) {
@@ -130,7 +133,7 @@ namespace dd {
                 } else if (e.w.i == &ComplexTable<>::one) {
                     os << "1";
                 } else {
-                    os << std::hex << reinterpret_cast<std::uintptr_t>(e.w.i) << std::dec;
+                    os << std::hex << reinterpret_cast<std::uintptr_t>(toPointer(e.w.i)) << std::dec;
                 }
             }
             os << "]</font>>";
@@ -140,7 +143,7 @@ namespace dd {
     }
 
     [[maybe_unused]] static std::ostream& modernNode(const Package::mEdge& e, std::ostream& os) {
-        auto nodelabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
+        auto nodelabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
         os << nodelabel << "[label=<";
         os << R"(<font point-size="10"><table border="1" cellspacing="0" cellpadding="2" style="rounded">)";
         os << R"(<tr><td colspan="2" rowspan="2" port="0" href="javascript:;" border="0" tooltip=")" << e.p->e[0].w << "\">" << (e.p->e[0].w.approximatelyZero() ? "&nbsp;0 " : "<font color=\"white\">&nbsp;0 </font>")
@@ -157,7 +160,7 @@ namespace dd {
         return os;
     }
     [[maybe_unused]] static std::ostream& modernNode(const Package::vEdge& e, std::ostream& os) {
-        auto nodelabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
+        auto nodelabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
         os << nodelabel << "[label=<";
         os << R"(<font point-size="8"><table border="1" cellspacing="0" cellpadding="0" style="rounded">)";
         os << R"(<tr><td colspan="2" border="0" cellpadding="1"><font point-size="20">q<sub><font point-size="12">)" << static_cast<std::size_t>(e.p->v) << R"(</font></sub></font></td></tr><tr>)";
@@ -167,7 +170,7 @@ namespace dd {
         return os;
     }
     [[maybe_unused]] static std::ostream& classicNode(const Package::mEdge& e, std::ostream& os) {
-        auto nodelabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
+        auto nodelabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
         os << nodelabel << "[shape=circle, width=0.53, fixedsize=true, label=<";
         os << R"(<font point-size="6"><table border="0" cellspacing="0" cellpadding="0">)";
         os << R"(<tr><td colspan="4"><font point-size="18">q<sub><font point-size="10">)" << static_cast<std::size_t>(e.p->v) << R"(</font></sub></font></td></tr><tr>)";
@@ -205,7 +208,7 @@ namespace dd {
         return os;
     }
     [[maybe_unused]] static std::ostream& classicNode(const Package::vEdge& e, std::ostream& os) {
-        auto nodelabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
+        auto nodelabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
         os << nodelabel << "[shape=circle, width=0.46, fixedsize=true, label=<";
         os << R"(<font point-size="6"><table border="0" cellspacing="0" cellpadding="0">)";
         os << R"(<tr><td colspan="2"><font point-size="18">q<sub><font point-size="10">)" << static_cast<std::size_t>(e.p->v) << R"(</font></sub></font></td></tr><tr>)";
@@ -229,10 +232,10 @@ namespace dd {
     template<class Edge>
     static std::ostream& memoryNode(const Edge& e, std::ostream& os) {
         constexpr std::size_t N         = std::tuple_size_v<decltype(e.p->e)>;
-        auto                  nodelabel = (reinterpret_cast<std::uintptr_t>(e.p) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
+        auto                  nodelabel = (reinterpret_cast<std::uintptr_t>(toPointer(e.p)) & 0x001fffffU) >> 1U; // this allows for 2^20 (roughly 1e6) unique nodes
         os << nodelabel << "[label=<";
         os << R"(<font point-size="10"><table border="1" cellspacing="0" cellpadding="2" style="rounded">)";
-        os << R"(<tr><td colspan=")" << N << R"(" border="1" sides="B">)" << std::hex << reinterpret_cast<std::uintptr_t>(e.p) << std::dec << " ref: " << e.p->ref << "</td></tr>";
+        os << R"(<tr><td colspan=")" << N << R"(" border="1" sides="B">)" << std::hex << reinterpret_cast<std::uintptr_t>(toPointer(e.p)) << std::dec << " ref: " << e.p->ref << "</td></tr>";
         os << "<tr>";
         for (std::size_t i = 0; i < N; ++i) {
             os << "<td port=\"" << i << R"(" href="javascript:;" border="0" tooltip=")" << e.p->e[i].w.toString(false, 4) << "\">";
@@ -245,14 +248,14 @@ namespace dd {
             os << "</td>";
         }
         os << "</tr>";
-        os << "</table></font>>,tooltip=\"" << std::hex << reinterpret_cast<std::uintptr_t>(e.p) << "\"]\n"
+        os << "</table></font>>,tooltip=\"" << std::hex << reinterpret_cast<std::uintptr_t>(toPointer(e.p)) << "\"]\n"
            << std::dec;
         return os;
     }
 
     [[maybe_unused]] static std::ostream& bwEdge(const Package::mEdge& from, const Package::mEdge& to, short idx, std::ostream& os, bool edgeLabels = false, bool classic = false) {
-        auto fromlabel = (reinterpret_cast<std::uintptr_t>(from.p) & 0x001fffffU) >> 1U;
-        auto tolabel   = (reinterpret_cast<std::uintptr_t>(to.p) & 0x001fffffU) >> 1U;
+        auto fromlabel = (reinterpret_cast<std::uintptr_t>(toPointer(from.p)) & 0x001fffffU) >> 1U;
+        auto tolabel   = (reinterpret_cast<std::uintptr_t>(toPointer(to.p)) & 0x001fffffU) >> 1U;
 
         os << fromlabel << ":" << idx << ":";
         if (classic) {
@@ -290,8 +293,8 @@ namespace dd {
         return os;
     }
     [[maybe_unused]] static std::ostream& bwEdge(const Package::vEdge& from, const Package::vEdge& to, short idx, std::ostream& os, bool edgeLabels = false, [[maybe_unused]] bool classic = false) {
-        auto fromlabel = (reinterpret_cast<std::uintptr_t>(from.p) & 0x001fffffU) >> 1U;
-        auto tolabel   = (reinterpret_cast<std::uintptr_t>(to.p) & 0x001fffffU) >> 1U;
+        auto fromlabel = (reinterpret_cast<std::uintptr_t>(toPointer(from.p)) & 0x001fffffU) >> 1U;
+        auto tolabel   = (reinterpret_cast<std::uintptr_t>(toPointer(to.p)) & 0x001fffffU) >> 1U;
 
         os << fromlabel << ":" << idx << ":";
         os << (idx == 0 ? "sw" : "se") << "->";
@@ -314,8 +317,8 @@ namespace dd {
         return os;
     }
     [[maybe_unused]] static std::ostream& coloredEdge(const Package::mEdge& from, const Package::mEdge& to, short idx, std::ostream& os, bool edgeLabels = false, bool classic = false) {
-        auto fromlabel = (reinterpret_cast<std::uintptr_t>(from.p) & 0x001fffffU) >> 1U;
-        auto tolabel   = (reinterpret_cast<std::uintptr_t>(to.p) & 0x001fffffU) >> 1U;
+        auto fromlabel = (reinterpret_cast<std::uintptr_t>(toPointer(from.p)) & 0x001fffffU) >> 1U;
+        auto tolabel   = (reinterpret_cast<std::uintptr_t>(toPointer(to.p)) & 0x001fffffU) >> 1U;
 
         os << fromlabel << ":" << idx << ":";
         if (classic) {
@@ -351,8 +354,8 @@ namespace dd {
         return os;
     }
     [[maybe_unused]] static std::ostream& coloredEdge(const Package::vEdge& from, const Package::vEdge& to, short idx, std::ostream& os, bool edgeLabels = false, [[maybe_unused]] bool classic = false) {
-        auto fromlabel = (reinterpret_cast<std::uintptr_t>(from.p) & 0x001fffffU) >> 1U;
-        auto tolabel   = (reinterpret_cast<std::uintptr_t>(to.p) & 0x001fffffU) >> 1U;
+        auto fromlabel = (reinterpret_cast<std::uintptr_t>(toPointer(from.p)) & 0x001fffffU) >> 1U;
+        auto tolabel   = (reinterpret_cast<std::uintptr_t>(toPointer(to.p)) & 0x001fffffU) >> 1U;
 
         os << fromlabel << ":" << idx << ":";
         os << (idx == 0 ? "sw" : "se") << "->";
@@ -374,8 +377,8 @@ namespace dd {
     }
     template<class Edge>
     static std::ostream& memoryEdge(const Edge& from, const Edge& to, short idx, std::ostream& os, bool edgeLabels = false) {
-        auto fromlabel = (reinterpret_cast<std::uintptr_t>(from.p) & 0x001fffffU) >> 1U;
-        auto tolabel   = (reinterpret_cast<std::uintptr_t>(to.p) & 0x001fffffU) >> 1U;
+        auto fromlabel = (reinterpret_cast<std::uintptr_t>(toPointer(from.p)) & 0x001fffffU) >> 1U;
+        auto tolabel   = (reinterpret_cast<std::uintptr_t>(toPointer(to.p)) & 0x001fffffU) >> 1U;
 
         os << fromlabel << ":" << idx << ":s->";
         if (to.isTerminal()) {
@@ -399,7 +402,7 @@ namespace dd {
                 } else if (to.w.r == &ComplexTable<>::one) {
                     os << "1";
                 } else {
-                    os << std::hex << reinterpret_cast<std::uintptr_t>(to.w.r) << std::dec;
+                    os << std::hex << reinterpret_cast<std::uintptr_t>(toPointer(to.w.r)) << std::dec;
                 }
                 os << " ";
                 if (to.w.i == &ComplexTable<>::zero) {
@@ -409,7 +412,7 @@ namespace dd {
                 } else if (to.w.i == &ComplexTable<>::one) {
                     os << "1";
                 } else {
-                    os << std::hex << reinterpret_cast<std::uintptr_t>(to.w.i) << std::dec;
+                    os << std::hex << reinterpret_cast<std::uintptr_t>(toPointer(to.w.i)) << std::dec;
                 }
             }
             os << "]</font>>";
@@ -432,7 +435,7 @@ namespace dd {
             header(e, oss, edgeLabels);
         }
 
-        std::unordered_set<decltype(e.p)> nodes{};
+        VisitedNodes<std::remove_reference_t<decltype(*e.p)>> nodes{};
 
         auto priocmp = [](const Edge* left, const Edge* right) { return left->p->v < right->p->v; };
 
@@ -449,8 +452,7 @@ namespace dd {
                 continue;
 
             // check if node has already been processed
-            auto ret = nodes.emplace(node->p);
-            if (!ret.second) continue;
+            if (!nodes.insert(node->p)) continue;
 
             // node definition as HTML-like label (href="javascript:;" is used as workaround to make tooltips work)
             if (memory) {
@@ -505,16 +507,72 @@ namespace dd {
     /// Note: do not rely on the binary format being portable across different architectures/platforms
     ///
 
+    // append the record of the node `p` and of all its descendants not recorded yet to `records` (in post order)
+    template<class Node, std::size_t N, class WeightIndex>
+    static std::int64_t serializeNode(const Node* p, NodeMap<const Node*, std::int64_t>& indices, std::vector<SerializedNode<N>>& records, const WeightIndex& weightIndex) {
+        if (Node::isTerminal(p)) {
+            return -1;
+        }
+        if (const auto* it = indices.find(p); it != nullptr) {
+            return *it;
+        }
+        SerializedNode<N> record{};
+        for (std::size_t i = 0; i < N; ++i) {
+            const auto& edge = p->e[i];
+            if (edge.w.approximatelyZero()) {
+                record.children[i] = -1;
+                record.weights[i]  = weightIndex(Complex::zero);
+            } else {
+                record.children[i] = serializeNode(toPointer(edge.p), indices, records, weightIndex);
+                record.weights[i]  = weightIndex(edge.w);
+            }
+        }
+        record.v         = p->v;
+        const auto index = static_cast<std::int64_t>(records.size());
+        records.push_back(record);
+        indices.try_emplace(p, index);
+        return index;
+    }
+
+    // write the DD `basic` in the binary format (version 2), see SerializationHeader
+    template<class Edge>
+    static void serializeBinary(const Edge& basic, std::ostream& os) {
+        using Node              = std::remove_reference_t<decltype(*basic.p)>;
+        constexpr std::size_t N = std::tuple_size_v<decltype(basic.p->e)>;
+        static_assert(sizeof(SerializedNode<N>) == (2 * N + 1) * sizeof(std::int64_t), "Node records must not be padded.");
+        static_assert(sizeof(SerializedWeight) == 2 * sizeof(double), "Weights must not be padded.");
+
+        // weights are deduplicated by the complex table entries representing them
+        std::unordered_map<Complex, std::uint64_t> weightIndices{};
+        std::vector<SerializedWeight>              weights{};
+        const auto                                 weightIndex = [&](const Complex& w) {
+            const auto [it, inserted] = weightIndices.try_emplace(w, weights.size());
+            if (inserted) {
+                weights.push_back({CTEntry::val(w.r), CTEntry::val(w.i)});
+            }
+            return it->second;
+        };
+
+        NodeMap<const Node*, std::int64_t> indices{};
+        std::vector<SerializedNode<N>>     records{};
+        serializeNode(toPointer(basic.p), indices, records, weightIndex);
+        const auto rootWeight = weightIndex(basic.w);
+
+        const SerializationHeader header{SERIALIZATION_VERSION, records.size(), weights.size(), rootWeight};
+        os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        os.write(reinterpret_cast<const char*>(weights.data()), static_cast<std::streamsize>(weights.size() * sizeof(SerializedWeight)));
+        os.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(SerializedNode<N>)));
+    }
+
     [[maybe_unused]] static void serialize(const Package::vEdge& basic, std::ostream& os, bool writeBinary = false) {
         if (writeBinary) {
-            os.write(reinterpret_cast<const char*>(&SERIALIZATION_VERSION), sizeof(decltype(SERIALIZATION_VERSION)));
-            basic.w.writeBinary(os);
-        } else {
-            os << SERIALIZATION_VERSION << "\n";
-            os << basic.w.toString(false, 16) << "\n";
+            serializeBinary(basic, os);
+            return;
         }
-        std::int_least64_t                                      next_index = 0;
-        std::unordered_map<Package::vNode*, std::int_least64_t> node_index{};
+        os << SERIALIZATION_VERSION << "\n";
+        os << basic.w.toString(false, 16) << "\n";
+        std::int_least64_t                           next_index = 0;
+        NodeMap<Package::vNode*, std::int_least64_t> node_index{};
 
         // POST ORDER TRAVERSAL USING ONE STACK   https://www.geeksforgeeks.org/iterative-postorder-traversal-using-stack/
         std::stack<const Package::vEdge*> stack{};
@@ -527,7 +585,7 @@ namespace dd {
                         auto& edge = node->p->e[i];
                         if (edge.isTerminal()) continue;
                         if (edge.w.approximatelyZero()) continue;
-                        if (node_index.find(edge.p) != node_index.end()) continue;
+                        if (node_index.contains(edge.p)) continue;
 
                         // non-zero edge to be included
                         stack.push(&edge);
@@ -542,7 +600,7 @@ namespace dd {
                 for (auto i = 1U; i < RADIX && !hasChild; ++i) {
                     auto& edge = node->p->e[i];
                     if (edge.w.approximatelyZero()) continue;
-                    if (node_index.find(edge.p) != node_index.end()) continue;
+                    if (node_index.contains(edge.p)) continue;
                     if (!stack.empty())
                         hasChild = edge.p == stack.top()->p;
                 }
@@ -553,95 +611,68 @@ namespace dd {
                     stack.push(node);
                     node = temp;
                 } else {
-                    if (node_index.find(node->p) != node_index.end()) {
+                    if (node_index.contains(node->p)) {
                         node = nullptr;
                         continue;
                     }
                     node_index[node->p] = next_index;
                     next_index++;
 
-                    if (writeBinary) {
-                        os.write(reinterpret_cast<const char*>(&node_index[node->p]), sizeof(decltype(node_index[node->p])));
-                        os.write(reinterpret_cast<const char*>(&node->p->v), sizeof(decltype(node->p->v)));
+                    os << node_index[node->p] << " " << static_cast<std::size_t>(node->p->v);
 
-                        // iterate over edges in reverse to guarantee correct processing order
-                        for (auto i = 0U; i < RADIX; ++i) {
-                            auto&              edge     = node->p->e[i];
+                    // iterate over edges in reverse to guarantee correct processing order
+                    for (auto i = 0U; i < RADIX; ++i) {
+                        os << " (";
+                        auto& edge = node->p->e[i];
+                        if (!edge.w.approximatelyZero()) {
                             std::int_least64_t edge_idx = edge.isTerminal() ? -1 : node_index[edge.p];
-                            os.write(reinterpret_cast<const char*>(&edge_idx), sizeof(decltype(edge_idx)));
-                            edge.w.writeBinary(os);
-                        }
-                    } else {
-                        os << node_index[node->p] << " " << static_cast<std::size_t>(node->p->v);
-
-                        // iterate over edges in reverse to guarantee correct processing order
-                        for (auto i = 0U; i < RADIX; ++i) {
-                            os << " (";
-                            auto& edge = node->p->e[i];
-                            if (!edge.w.approximatelyZero()) {
-                                std::int_least64_t edge_idx = edge.isTerminal() ? -1 : node_index[edge.p];
-                                os << edge_idx << " " << edge.w.toString(false, 16);
-                            }
-                            os << ")";
+                            os << edge_idx << " " << edge.w.toString(false, 16);
                         }
-                        os << "\n";
+                        os << ")";
                     }
+                    os << "\n";
                     node = nullptr;
                 }
             } while (!stack.empty());
         }
     }
-    static void serializeMatrix(const Package::mEdge& basic, std::int_least64_t& idx, std::unordered_map<Package::mNode*, std::int_least64_t>& node_index, std::unordered_set<Package::mNode*>& visited, std::ostream& os, bool writeBinary = false) {
+    static void serializeMatrix(const Package::mEdge& basic, std::int_least64_t& idx, NodeMap<Package::mNode*, std::int_least64_t>& node_index, VisitedNodes<Package::mNode>& visited, std::ostream& os) {
         if (!basic.isTerminal()) {
             for (auto& e: basic.p->e) {
-                if (auto [iter, success] = visited.insert(e.p); success) {
-                    serializeMatrix(e, idx, node_index, visited, os, writeBinary);
+                if (visited.insert(e.p)) {
+                    serializeMatrix(e, idx, node_index, visited, os);
                 }
             }
 
-            if (node_index.find(basic.p) == node_index.end()) {
-                node_index[basic.p] = idx;
+            if (node_index.try_emplace(basic.p, idx).second) {
                 ++idx;
             }
 
-            if (writeBinary) {
-                os.write(reinterpret_cast<const char*>(&node_index[basic.p]), sizeof(decltype(node_index[basic.p])));
-                os.write(reinterpret_cast<const char*>(&basic.p->v), sizeof(decltype(basic.p->v)));
+            os << node_index[basic.p] << " " << static_cast<std::size_t>(basic.p->v);
 
-                // iterate over edges in reverse to guarantee correct processing order
-                for (auto& edge: basic.p->e) {
+            // iterate over edges in reverse to guarantee correct processing order
+            for (auto& edge: basic.p->e) {
+                os << " (";
+                if (!edge.w.approximatelyZero()) {
                     std::int_least64_t edge_idx = edge.isTerminal() ? -1 : node_index[edge.p];
-                    os.write(reinterpret_cast<const char*>(&edge_idx), sizeof(decltype(edge_idx)));
-                    edge.w.writeBinary(os);
+                    os << edge_idx << " " << edge.w.toString(false, 16);
                 }
-            } else {
-                os << node_index[basic.p] << " " << static_cast<std::size_t>(basic.p->v);
-
-                // iterate over edges in reverse to guarantee correct processing order
-                for (auto& edge: basic.p->e) {
-                    os << " (";
-                    if (!edge.w.approximatelyZero()) {
-                        std::int_least64_t edge_idx = edge.isTerminal() ? -1 : node_index[edge.p];
-                        os << edge_idx << " " << edge.w.toString(false, 16);
-                    }
-                    os << ")";
-                }
-                os << "\n";
+                os << ")";
             }
+            os << "\n";
         }
     }
     [[maybe_unused]] static void serialize(const Package::mEdge& basic, std::ostream& os, bool writeBinary = false) {
         if (writeBinary) {
-            os.write(reinterpret_cast<const char*>(&SERIALIZATION_VERSION), sizeof(decltype(SERIALIZATION_VERSION)));
-            basic.w.writeBinary(os);
-        } else {
-            os << SERIALIZATION_VERSION << "\n";
-            os << basic.w.toString(false, 16) << "\n";
-        }
-        std::int_least64_t                                      idx = 0;
-        std::unordered_map<Package::mNode*, std::int_least64_t> node_index{};
-        std::unordered_set<Package::mNode*>                     visited{};
-        serializeMatrix(basic, idx, node_index, visited, os, writeBinary);
+            serializeBinary(basic, os);
+            return;
+        }
+        os << SERIALIZATION_VERSION << "\n";
+        os << basic.w.toString(false, 16) << "\n";
+        std::int_least64_t                           idx = 0;
+        NodeMap<Package::mNode*, std::int_least64_t> node_index{};
+        VisitedNodes<Package::mNode>                 visited{};
+        serializeMatrix(basic, idx, node_index, visited, os);
     }
     template<class Edge>
     static void serialize(const Edge& basic, const std::string& outputFilename, bool writeBinary = false) {
@@ -663,7 +694,7 @@ namespace dd {
         };
         stream << std::showpos << CTEntry::val(edge.w.r) << CTEntry::val(edge.w.i) << std::noshowpos << "i\n";
 
-        std::unordered_set<decltype(edge.p)> nodes{};
+        VisitedNodes<std::remove_reference_t<decltype(*edge.p)>> nodes{};
 
         std::priority_queue<const Edge*, std::vector<const Edge*>, priocmp> q;
         q.push(&edge);
@@ -678,8 +709,7 @@ namespace dd {
                 continue;
 
             // check if edgePtr has already been processed
-            auto ret = nodes.emplace(edgePtr->p);
-            if (!ret.second) continue;
+            if (!nodes.insert(edgePtr->p)) continue;
 
             // iterate over edges in reverse to guarantee correct proceossing order
             for (auto i = static_cast<Qubit>(edgePtr->p->e.size() - 1); i >= 0; --i) {
@@ -44,11 +44,36 @@ namespace dd {
     constexpr GateMatrix Vmat{complex_SQRT2_2, complex_miSQRT2_2, complex_miSQRT2_2, complex_SQRT2_2};
     constexpr GateMatrix Vdagmat{complex_SQRT2_2, complex_iSQRT2_2, complex_iSQRT2_2, complex_SQRT2_2};
 
+    // Two-qubit gate matrices (rows and columns are indexed by 2 * b1 + b0, where b0 and b1 are the values of the first
+    // and the second target, respectively)
+    using TwoQubitGateMatrix = std::array<std::array<ComplexValue, NEDGE>, NEDGE>;
+    constexpr TwoQubitGateMatrix SWAPmat{{{complex_one, complex_zero, complex_zero, complex_zero},
+                                          {complex_zero, complex_zero, complex_one, complex_zero},
+                                          {complex_zero, complex_one, complex_zero, complex_zero},
+                                          {complex_zero, complex_zero, complex_zero, complex_one}}};
+    constexpr TwoQubitGateMatrix iSWAPmat{{{complex_one, complex_zero, complex_zero, complex_zero},
+                                           {complex_zero, complex_zero, complex_i, complex_zero},
+                                           {complex_zero, complex_i, complex_zero, complex_zero},
+                                           {complex_zero, complex_zero, complex_zero, complex_one}}};
+    constexpr TwoQubitGateMatrix iSWAPinvmat{{{complex_one, complex_zero, complex_zero, complex_zero},
+                                              {complex_zero, complex_zero, complex_mi, complex_zero},
+                                              {complex_zero, complex_mi, complex_zero, complex_zero},
+                                              {complex_zero, complex_zero, complex_zero, complex_one}}};
+    // Peres gate: CX with control b1 and target b0, followed by X on b1
+    constexpr TwoQubitGateMatrix Peresmat{{{complex_zero, complex_zero, complex_zero, complex_one},
+                                           {complex_zero, complex_zero, complex_one, complex_zero},
+                                           {complex_one, complex_zero, complex_zero, complex_zero},
+                                           {complex_zero, complex_one, complex_zero, complex_zero}}};
+    constexpr TwoQubitGateMatrix Peresdagmat{{{complex_zero, complex_zero, complex_one, complex_zero},
+                                              {complex_zero, complex_zero, complex_zero, complex_one},
+                                              {complex_zero, complex_one, complex_zero, complex_zero},
+                                              {complex_one, complex_zero, complex_zero, complex_zero}}};
+
     inline GateMatrix U3mat(fp lambda, fp phi, fp theta) {
-        return GateMatrix{{{std::cos(theta / 2.), 0.},
-                           {-std::cos(lambda) * std::sin(theta / 2.), -std::sin(lambda) * std::sin(theta / 2.)},
-                           {std::cos(phi) * std::sin(theta / 2.), std::sin(phi) * std::sin(theta / 2.)},
-                           {std::cos(lambda + phi) * std::cos(theta / 2.), std::sin(lambda + phi) * std::cos(theta / 2.)}}};
+        return GateMatrix{{{std::cos(theta / 2), 0.},
+                           {-std::cos(lambda) * std::sin(theta / 2), -std::sin(lambda) * std::sin(theta / 2)},
+                           {std::cos(phi) * std::sin(theta / 2), std::sin(phi) * std::sin(theta / 2)},
+                           {std::cos(lambda + phi) * std::cos(theta / 2), std::sin(lambda + phi) * std::cos(theta / 2)}}};
     }
 
     inline GateMatrix U2mat(fp lambda, fp phi) {
@@ -63,24 +88,51 @@ namespace dd {
     }
 
     inline GateMatrix RXmat(fp lambda) {
-        return GateMatrix{{{std::cos(lambda / 2.), 0.},
-                           {0., -std::sin(lambda / 2.)},
-                           {0., -std::sin(lambda / 2.)},
-                           {std::cos(lambda / 2.), 0.}}};
+        return GateMatrix{{{std::cos(lambda / 2), 0.},
+                           {0., -std::sin(lambda / 2)},
+                           {0., -std::sin(lambda / 2)},
+                           {std::cos(lambda / 2), 0.}}};
     }
 
     inline GateMatrix RYmat(fp lambda) {
-        return GateMatrix{{{std::cos(lambda / 2.), 0.},
-                           {-std::sin(lambda / 2.), 0.},
-                           {std::sin(lambda / 2.), 0.},
-                           {std::cos(lambda / 2.), 0.}}};
+        return GateMatrix{{{std::cos(lambda / 2), 0.},
+                           {-std::sin(lambda / 2), 0.},
+                           {std::sin(lambda / 2), 0.},
+                           {std::cos(lambda / 2), 0.}}};
     }
 
     inline GateMatrix RZmat(fp lambda) {
-        return GateMatrix{{{-std::cos(lambda / 2.), -std::sin(lambda / 2.)},
+        return GateMatrix{{{-std::cos(lambda / 2), -std::sin(lambda / 2)},
                            complex_zero,
                            complex_zero,
-                           {std::cos(lambda / 2.), std::sin(lambda / 2.)}}};
+                           {std::cos(lambda / 2), std::sin(lambda / 2)}}};
+    }
+
+    inline TwoQubitGateMatrix RXXmat(fp theta) {
+        const ComplexValue c{std::cos(theta / 2), 0.};
+        const ComplexValue s{0., -std::sin(theta / 2)};
+        return TwoQubitGateMatrix{{{c, complex_zero, complex_zero, s},
+                                   {complex_zero, c, s, complex_zero},
+                                   {complex_zero, s, c, complex_zero},
+                                   {s, complex_zero, complex_zero, c}}};
+    }
+
+    inline TwoQubitGateMatrix RZZmat(fp theta) {
+        const ComplexValue p{std::cos(theta / 2), std::sin(theta / 2)};
+        const ComplexValue m{std::cos(theta / 2), -std::sin(theta / 2)};
+        return TwoQubitGateMatrix{{{m, complex_zero, complex_zero, complex_zero},
+                                   {complex_zero, p, complex_zero, complex_zero},
+                                   {complex_zero, complex_zero, p, complex_zero},
+                                   {complex_zero, complex_zero, complex_zero, m}}};
+    }
+
+    inline TwoQubitGateMatrix fSimmat(fp theta, fp phi) {
+        const ComplexValue c{std::cos(theta), 0.};
+        const ComplexValue s{0., -std::sin(theta)};
+        return TwoQubitGateMatrix{{{complex_one, complex_zero, complex_zero, complex_zero},
+                                   {complex_zero, c, s, complex_zero},
+                                   {complex_zero, s, c, complex_zero},
+                                   {complex_zero, complex_zero, complex_zero, {std::cos(phi), -std::sin(phi)}}}};
     }
 } // namespace dd
 #endif //DD_PACKAGE_GATEMATRIXDEFINITIONS_H
@@ -0,0 +1,137 @@
+/*
+ * This file is part of the JKQ DD Package which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_dd/ for more information.
+ */
+
+#ifndef DDpackage_GATETABLE_HPP
+#define DDpackage_GATETABLE_HPP
+
+#include "ComplexValue.hpp"
+#include "Control.hpp"
+#include "Definitions.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace dd {
+    // cache of the DDs of (controlled) one- and two-qubit gates. Entries are identified by the exact values of the gate
+    // matrix, so that gates with the same parameters (e.g., rotation angles) map to the same entry.
+    template<class Edge, std::size_t NBUCKET = 2048>
+    class GateTable {
+    public:
+        GateTable() = default;
+
+        // row-major gate matrix. One-qubit gates only use the first NEDGE values.
+        using Matrix = std::array<ComplexValue, NEDGE * NEDGE>;
+
+        struct Entry {
+            Matrix      matrix{};
+            Controls    controls{};
+            QubitCount  n       = 0;
+            std::size_t start   = 0;
+            Qubit       target0 = 0;
+            Qubit       target1 = -1; // -1 for one-qubit gates
+            Edge        e;
+        };
+
+        static constexpr std::size_t MASK = NBUCKET - 1;
+
+        // access functions
+        [[nodiscard]] const auto& getTable() const { return table; }
+
+        void insert(const Matrix& matrix, QubitCount n, std::size_t start, const Controls& controls, Qubit target0, Qubit target1, const Edge& e) {
+            const auto key = hash(matrix, n, start, controls, target0, target1);
+            table[key]     = {matrix, controls, n, start, target0, target1, e};
+            ++count;
+        }
+
+        Edge lookup(const Matrix& matrix, QubitCount n, std::size_t start, const Controls& controls, Qubit target0, Qubit target1) {
+            lookups++;
+            Edge        r{};
+            const auto  key   = hash(matrix, n, start, controls, target0, target1);
+            const auto& entry = table[key];
+            if (entry.e.p == nullptr) return r;
+            if (entry.n != n || entry.start != start) return r;
+            if (entry.target0 != target0 || entry.target1 != target1) return r;
+            if (!identical(entry.matrix, matrix)) return r;
+            if (entry.controls != controls) return r;
+            hits++;
+            return entry.e;
+        }
+
+        static std::size_t hash(const Matrix& matrix, QubitCount n, std::size_t start, const Controls& controls, Qubit target0, Qubit target1) {
+            auto key = murmur64(static_cast<std::size_t>(n) | start << 8U |
+                                static_cast<std::size_t>(static_cast<std::make_unsigned_t<Qubit>>(target0)) << 16U |
+                                static_cast<std::size_t>(static_cast<std::make_unsigned_t<Qubit>>(target1)) << 24U);
+            for (const auto& value: matrix) {
+                key = combineHash(key, murmur64(bits(value.r)));
+                key = combineHash(key, murmur64(bits(value.i)));
+            }
+            for (const auto& control: controls) {
+                key = combineHash(key, static_cast<std::size_t>(static_cast<std::make_unsigned_t<Qubit>>(control.qubit)) << 1U | (control.type == Control::Type::pos ? 1U : 0U));
+            }
+            return key & MASK;
+        }
+
+        void clear() {
+            if (count > 0) {
+                for (auto& entry: table)
+                    entry.e.p = nullptr;
+                count = 0;
+            }
+            hits    = 0;
+            lookups = 0;
+        }
+
+        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(hits) / lookups; }
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"hits", hits},
+                    {"lookups", lookups},
+                    {"count", count},
+            };
+        }
+
+        std::ostream& printStatistics(std::ostream& os = std::cout) {
+            os << "hits: " << hits << ", looks: " << lookups << ", ratio: " << hitRatio() << std::endl;
+            return os;
+        }
+
+    private:
+        std::vector<Entry> table{NBUCKET};
+
+        // compute table lookup statistics
+        std::size_t hits    = 0;
+        std::size_t lookups = 0;
+        std::size_t count   = 0;
+
+        static std::size_t bits(fp value) {
+            // identify 0. and -0.
+            if (value == 0.) {
+                return 0;
+            }
+            std::uint64_t b{};
+            std::memcpy(&b, &value, sizeof(fp) < sizeof(b) ? sizeof(fp) : sizeof(b));
+            return static_cast<std::size_t>(b);
+        }
+
+        static bool identical(const Matrix& lhs, const Matrix& rhs) {
+            for (std::size_t i = 0; i < lhs.size(); ++i) {
+                if (lhs[i].r != rhs[i].r || lhs[i].i != rhs[i].i) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+} // namespace dd
+
+#endif //DDpackage_GATETABLE_HPP
@@ -0,0 +1,92 @@
+/*
+ * This file is part of the JKQ DD Package which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_MAPPEDFILE_HPP
+#define DD_PACKAGE_MAPPEDFILE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#else
+    #include <fstream>
+    #include <iterator>
+    #include <vector>
+#endif
+
+namespace dd {
+
+    /// Read-only view of the contents of a file
+    /// On Linux, the file is mapped into memory, so that its pages are only read from disk once they are accessed and
+    /// no copy is made. Other platforms read the contents into a buffer.
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& filename) {
+#if defined(__linux__)
+            const int fd = ::open(filename.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::invalid_argument("Cannot open file: " + filename);
+            }
+            struct stat status {};
+            if (::fstat(fd, &status) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Cannot determine the size of file: " + filename);
+            }
+            length = static_cast<std::size_t>(status.st_size);
+            if (length > 0) {
+                mapping = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (mapping == MAP_FAILED) {
+                    mapping = nullptr;
+                    ::close(fd);
+                    throw std::runtime_error("Cannot map file: " + filename);
+                }
+                ::madvise(mapping, length, MADV_SEQUENTIAL);
+            }
+            ::close(fd);
+#else
+            std::ifstream ifs(filename, std::ios::binary);
+            if (!ifs.good()) {
+                throw std::invalid_argument("Cannot open file: " + filename);
+            }
+            buffer.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+#endif
+        }
+
+        ~MappedFile() {
+#if defined(__linux__)
+            if (mapping != nullptr) {
+                ::munmap(mapping, length);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile& other) = delete;
+        MappedFile& operator=(const MappedFile& other) = delete;
+
+#if defined(__linux__)
+        [[nodiscard]] const char* data() const { return static_cast<const char*>(mapping); }
+        [[nodiscard]] std::size_t size() const { return length; }
+#else
+        [[nodiscard]] const char* data() const { return buffer.data(); }
+        [[nodiscard]] std::size_t size() const { return buffer.size(); }
+#endif
+
+    private:
+#if defined(__linux__)
+        void*       mapping = nullptr;
+        std::size_t length  = 0;
+#else
+        std::vector<char> buffer{};
+#endif
+    };
+
+} // namespace dd
+
+#endif //DD_PACKAGE_MAPPEDFILE_HPP
@@ -0,0 +1,150 @@
+/*
+ * This file is part of the JKQ DD Package which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_NODEMAP_HPP
+#define DD_PACKAGE_NODEMAP_HPP
+
+#include "Definitions.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace dd {
+
+    // hash of the keys of a NodeMap. Node addresses are mixed, since their low bits are determined by the alignment.
+    template<class Key>
+    struct NodeMapHash {
+        std::size_t operator()(const Key& key) const noexcept { return std::hash<Key>{}(key); }
+    };
+    template<class Node>
+    struct NodeMapHash<Node*> {
+        std::size_t operator()(const Node* p) const noexcept { return murmur64(reinterpret_cast<std::size_t>(p)); }
+    };
+
+    /// Map from the nodes (or pairs of nodes) visited by a traversal of a decision diagram to values of type T
+    /// Values are stored in a side array in the order in which their keys are inserted, i.e., in the order of the
+    /// traversal. The position of a key is resolved by an open addressing index of 32bit positions, which grows by
+    /// doubling. In contrast to std::unordered_map, inserting a node does not allocate and looking it up does not follow
+    /// any chain. The nodes themselves are not modified, so that several maps may be used at the same time and for the
+    /// nodes of other packages. Inserting a key invalidates references to the values.
+    /// \tparam Key type of the keys (pointers to nodes or, e.g., NodePair)
+    /// \tparam T type of the values
+    template<class Key, class T, class Hash = NodeMapHash<Key>>
+    class NodeMap {
+    public:
+        explicit NodeMap(std::size_t expected = 0) {
+            reserve(expected);
+        }
+
+        // position of `key` in the side array (npos if `key` is not contained)
+        [[nodiscard]] std::size_t position(const Key& key) const {
+            if (index.empty()) {
+                return npos;
+            }
+            for (auto slot = Hash{}(key) & mask;; slot = (slot + 1) & mask) {
+                const auto pos = index[slot];
+                if (pos == EMPTY) {
+                    return npos;
+                }
+                if (keys[pos] == key) {
+                    return pos;
+                }
+            }
+        }
+
+        [[nodiscard]] bool contains(const Key& key) const { return position(key) != npos; }
+
+        // pointer to the value of `key` (nullptr if `key` is not contained)
+        [[nodiscard]] T* find(const Key& key) {
+            const auto pos = position(key);
+            return pos == npos ? nullptr : &values[pos];
+        }
+        [[nodiscard]] const T* find(const Key& key) const {
+            const auto pos = position(key);
+            return pos == npos ? nullptr : &values[pos];
+        }
+
+        // insert `key` with the value constructed from `args` unless it is already contained. Returns the position of
+        // the key and whether it has been inserted.
+        template<class... Args>
+        std::pair<std::size_t, bool> try_emplace(const Key& key, Args&&... args) {
+            if (2 * (keys.size() + 1) > index.size()) {
+                reserve(keys.size() + 1);
+            }
+            auto slot = Hash{}(key) & mask;
+            for (; index[slot] != EMPTY; slot = (slot + 1) & mask) {
+                if (keys[index[slot]] == key) {
+                    return {index[slot], false};
+                }
+            }
+            index[slot] = static_cast<std::uint32_t>(keys.size());
+            keys.push_back(key);
+            values.emplace_back(std::forward<Args>(args)...);
+            return {keys.size() - 1, true};
+        }
+
+        // value of `key`, which is value-initialized if `key` is not contained yet
+        T& operator[](const Key& key) {
+            return values[try_emplace(key).first];
+        }
+
+        T&       at(std::size_t pos) { return values[pos]; }
+        const T& at(std::size_t pos) const { return values[pos]; }
+
+        // keys and values in the order of insertion
+        [[nodiscard]] const std::vector<Key>& getKeys() const { return keys; }
+        [[nodiscard]] const std::vector<T>&   getValues() const { return values; }
+
+        [[nodiscard]] std::size_t size() const { return keys.size(); }
+        [[nodiscard]] bool        empty() const { return keys.empty(); }
+
+        // prepare the index for `n` keys, such that it is filled at most half
+        void reserve(std::size_t n) {
+            if (n == 0 || 2 * n <= index.size()) {
+                return;
+            }
+            keys.reserve(n);
+            values.reserve(n);
+            std::size_t capacity = MIN_CAPACITY;
+            while (capacity < 2 * n) {
+                capacity *= 2;
+            }
+            index.assign(capacity, EMPTY);
+            mask = capacity - 1;
+            for (std::size_t pos = 0; pos < keys.size(); ++pos) {
+                auto slot = Hash{}(keys[pos]) & mask;
+                while (index[slot] != EMPTY) {
+                    slot = (slot + 1) & mask;
+                }
+                index[slot] = static_cast<std::uint32_t>(pos);
+            }
+        }
+
+        void clear() {
+            keys.clear();
+            values.clear();
+            std::fill(index.begin(), index.end(), EMPTY);
+        }
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    private:
+        static constexpr std::uint32_t EMPTY        = std::numeric_limits<std::uint32_t>::max();
+        static constexpr std::size_t   MIN_CAPACITY = 64;
+
+        std::vector<std::uint32_t> index{};
+        std::size_t                mask = 0;
+        std::vector<Key>           keys{};
+        std::vector<T>             values{};
+    };
+
+} // namespace dd
+
+#endif //DD_PACKAGE_NODEMAP_HPP
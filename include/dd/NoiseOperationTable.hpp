@@ -11,7 +11,12 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 namespace dd {
@@ -27,6 +32,28 @@ namespace dd {
         opCount
     };
 
+    // single-qubit noise channels (see Package::applyNoiseChannel)
+    enum class NoiseChannel : std::uint_fast8_t {
+        depolarization,   // replaces the qubit by the maximally mixed state with the given probability
+        amplitudeDamping, // decays |1> to |0> with the given probability
+        phaseFlip         // applies Z with the given probability
+    };
+
+    // a noise channel applied to a specific qubit (serves as operand of the compute table of noise channels)
+    struct NoiseChannelOperation {
+        NoiseChannel channel{};
+        Qubit        target{};
+        fp           probability{};
+    };
+
+    inline bool operator==(const NoiseChannelOperation& lhs, const NoiseChannelOperation& rhs) {
+        return lhs.channel == rhs.channel && lhs.target == rhs.target && lhs.probability == rhs.probability;
+    }
+
+    inline bool operator!=(const NoiseChannelOperation& lhs, const NoiseChannelOperation& rhs) {
+        return !(lhs == rhs);
+    }
+
     template<class Edge>
     class NoiseOperationTable {
     public:
@@ -70,7 +97,16 @@ namespace dd {
         }
 
         [[nodiscard]] fp hitRatio() const { return static_cast<fp>(hits) / lookups; }
-        std::ostream&    printStatistics(std::ostream& os = std::cout) {
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"hits", hits},
+                    {"lookups", lookups},
+                    {"count", count},
+            };
+        }
+
+        std::ostream& printStatistics(std::ostream& os = std::cout) {
             os << "hits: " << hits << ", looks: " << lookups << ", ratio: " << hitRatio() << std::endl;
             return os;
         }
@@ -87,4 +123,16 @@ namespace dd {
     };
 } // namespace dd
 
+namespace std {
+    template<>
+    struct hash<dd::NoiseChannelOperation> {
+        std::size_t operator()(dd::NoiseChannelOperation const& op) const noexcept {
+            std::uint64_t bits{};
+            std::memcpy(&bits, &op.probability, sizeof(dd::fp) < sizeof(bits) ? sizeof(dd::fp) : sizeof(bits));
+            const auto kind = static_cast<std::size_t>(op.channel) | static_cast<std::size_t>(static_cast<std::make_unsigned_t<dd::Qubit>>(op.target)) << 8U;
+            return dd::combineHash(dd::murmur64(kind), dd::murmur64(static_cast<std::size_t>(bits)));
+        }
+    };
+} // namespace std
+
 #endif //DDpackage_NOISEOPERATIONTABLE_HPP
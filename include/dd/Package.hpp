@@ -16,36 +16,171 @@
 #include "Definitions.hpp"
 #include "Edge.hpp"
 #include "GateMatrixDefinitions.hpp"
+#include "GateTable.hpp"
+#include "MappedFile.hpp"
+#include "NodeMap.hpp"
 #include "NoiseOperationTable.hpp"
+#include "ThreadPool.hpp"
 #include "ToffoliTable.hpp"
 #include "UnaryComputeTable.hpp"
 #include "UniqueTable.hpp"
+#include "VisitedNodes.hpp"
 
 #include <algorithm>
 #include <array>
 #include <bitset>
 #include <cassert>
+#include <chrono>
 #include <cmath>
 #include <complex>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <memory>
+#include <numeric>
 #include <queue>
 #include <random>
 #include <regex>
-#include <set>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 namespace dd {
+    /// Runtime configuration of a package
+    /// Compute table sizes are given as number of buckets and have to be powers of two.
+    struct PackageConfig {
+        std::size_t addTableSize            = 16384;
+        std::size_t multiplicationTableSize = 16384;
+        std::size_t transposeTableSize      = 4096;
+        std::size_t innerProductTableSize   = 4096;
+        std::size_t kroneckerTableSize      = 4096;
+        std::size_t noiseChannelTableSize   = 4096;
+
+        // if enabled, compute tables whose number of insertions since the last reset exceeds `resizeFillFactor` times
+        // their number of buckets while their hit ratio is below `resizeHitRatio` are doubled in size (up to
+        // `maxComputeTableSize` buckets) whenever garbage is collected
+        bool        autoResizeComputeTables = false;
+        fp          resizeFillFactor        = 1.;
+        fp          resizeHitRatio          = 0.5;
+        std::size_t maxComputeTableSize     = 1U << 22U;
+
+        // memory (in bytes) that each node and complex number pool keeps for reuse on `Package::reset`, so that
+        // subsequent computations do not have to allocate it again. Memory beyond this limit is released.
+        std::size_t retainedMemory = 0;
+
+        // if enabled, garbage collection that is not forced only visits a bounded amount of each table per call:
+        // at most `garbageCollectionBudget` recorded candidates of each unique table and as many complex table buckets
+        bool        incrementalGarbageCollection = false;
+        std::size_t garbageCollectionBudget      = 16384;
+
+        // tolerance up to which the edge weights of the package are identified (see ComplexTable::setLookupTolerance).
+        // Packages requiring less precision may use a larger tolerance, which merges more weights and nodes. 0 follows
+        // the process-wide tolerance.
+        fp tolerance = 0;
+
+        // if non-zero, applyGates approximates every intermediate state whose DD exceeds `approximationNodeBudget`
+        // nodes by removing all edges contributing less than `approximationThreshold` to it (see Package::approximate)
+        std::size_t approximationNodeBudget = 0;
+        fp          approximationThreshold  = 1e-4;
+
+        // if non-zero, applyGates reorders the levels of intermediate states by sifting (see Package::sift) once their
+        // DD exceeds `reorderingNodeThreshold` nodes. Afterwards, the threshold is raised to twice the size of the
+        // reordered DD, so that states which cannot be reduced any further are not sifted over and over again.
+        std::size_t reorderingNodeThreshold = 0;
+    };
+
+    // outcome of a single garbage collection run (see Package::setGarbageCollectionCallback)
+    struct GarbageCollectionRun {
+        bool                     forced                  = false;
+        std::size_t              collectedVectorNodes    = 0;
+        std::size_t              collectedMatrixNodes    = 0;
+        std::size_t              collectedComplexNumbers = 0;
+        std::chrono::nanoseconds duration{};
+    };
+
+    // accumulated garbage collection statistics of a package. Calls that return immediately, since no table has
+    // reached its collection limit, are counted as calls but not as runs.
+    struct GarbageCollectionStatistics {
+        std::size_t              calls                   = 0;
+        std::size_t              runs                    = 0;
+        std::size_t              collectedVectorNodes    = 0;
+        std::size_t              collectedMatrixNodes    = 0;
+        std::size_t              collectedComplexNumbers = 0;
+        std::chrono::nanoseconds time{};
+        std::chrono::nanoseconds maxTime{};
+    };
+
+    // accumulated statistics of the approximations applied by a package's applyGates (see
+    // PackageConfig::approximationNodeBudget). The product of the fidelities of the individual approximations estimates
+    // the fidelity of the final state.
+    struct ApproximationStatistics {
+        std::size_t runs         = 0;
+        std::size_t removedEdges = 0;
+        fp          fidelity     = 1.;
+    };
+
+    // a single-qubit gate with an arbitrary number of controls (see Package::applyGates)
+    struct GateOperation {
+        GateMatrix matrix{};
+        Controls   controls{};
+        Qubit      target{};
+    };
+
+    /// Machine-readable snapshot of the statistics of a package (see Package::getStatistics)
+    /// The statistics of the individual tables are stored under the tables' names as reported by their
+    /// getStatistics methods. The snapshot can be serialized as a JSON object, in which durations are given in
+    /// nanoseconds.
+    struct PackageStatistics {
+        std::map<std::string, std::map<std::string, std::size_t>> tables{};
+        // number of active nodes for each qubit
+        std::vector<std::size_t>    activeVectorNodes{};
+        std::vector<std::size_t>    activeMatrixNodes{};
+        GarbageCollectionStatistics garbageCollection{};
+
+        [[nodiscard]] std::string toJSON() const {
+            std::ostringstream os;
+            const auto         list = [&os](const std::vector<std::size_t>& values) {
+                os << "[";
+                for (std::size_t i = 0; i < values.size(); ++i) {
+                    os << (i > 0 ? ", " : "") << values[i];
+                }
+                os << "]";
+            };
+            os << "{\"tables\": {";
+            for (auto table = tables.begin(); table != tables.end(); ++table) {
+                os << (table != tables.begin() ? ", " : "") << "\"" << table->first << "\": {";
+                for (auto entry = table->second.begin(); entry != table->second.end(); ++entry) {
+                    os << (entry != table->second.begin() ? ", " : "") << "\"" << entry->first << "\": " << entry->second;
+                }
+                os << "}";
+            }
+            os << "}, \"activeVectorNodes\": ";
+            list(activeVectorNodes);
+            os << ", \"activeMatrixNodes\": ";
+            list(activeMatrixNodes);
+            const auto& gc = garbageCollection;
+            os << ", \"garbageCollection\": {"
+               << "\"calls\": " << gc.calls
+               << ", \"runs\": " << gc.runs
+               << ", \"collectedVectorNodes\": " << gc.collectedVectorNodes
+               << ", \"collectedMatrixNodes\": " << gc.collectedMatrixNodes
+               << ", \"collectedComplexNumbers\": " << gc.collectedComplexNumbers
+               << ", \"time\": " << gc.time.count()
+               << ", \"maxTime\": " << gc.maxTime.count()
+               << "}}";
+            return os.str();
+        }
+    };
+
     class Package {
         ///
         /// Complex number handling
@@ -59,9 +194,17 @@ namespace dd {
     public:
         static constexpr std::size_t maxPossibleQubits = static_cast<std::make_unsigned_t<Qubit>>(std::numeric_limits<Qubit>::max()) + 1U;
         static constexpr std::size_t defaultQubits     = 128;
-        explicit Package(std::size_t nq = defaultQubits):
-            cn(ComplexNumbers()), nqubits(nq) {
+        explicit Package(std::size_t nq = defaultQubits, const PackageConfig& config = PackageConfig{}):
+            cn(ComplexNumbers()), nqubits(nq), config(config) {
             resize(nq);
+            cn.setRetainedMemory(config.retainedMemory);
+            vUniqueTable.setRetainedMemory(config.retainedMemory);
+            mUniqueTable.setRetainedMemory(config.retainedMemory);
+            vUniqueTable.setIncrementalCollection(config.incrementalGarbageCollection);
+            mUniqueTable.setIncrementalCollection(config.incrementalGarbageCollection);
+            if (config.tolerance > 0) {
+                cn.setLookupTolerance(config.tolerance);
+            }
         };
         ~Package()                      = default;
         Package(const Package& package) = delete;
@@ -74,6 +217,16 @@ namespace dd {
                                             std::to_string(maxPossibleQubits) + " qubits, while " +
                                             std::to_string(nq) + " were requested. Please recompile the package with a wider Qubit type!");
             }
+            if (nq < nqubits) {
+                // the unique tables of the superfluous qubits are released, so none of their nodes may be in use
+                for (auto q = nq; q < nqubits; ++q) {
+                    if (vUniqueTable.getActiveNodeCount(static_cast<Qubit>(q)) > 0 || mUniqueTable.getActiveNodeCount(static_cast<Qubit>(q)) > 0) {
+                        throw std::invalid_argument("Cannot reduce the number of qubits to " + std::to_string(nq) + ", since DDs involving qubit " + std::to_string(q) + " are still in use.");
+                    }
+                }
+                // cached results might refer to released nodes
+                clearComputeTables();
+            }
             nqubits = nq;
             vUniqueTable.resize(nqubits);
             mUniqueTable.resize(nqubits);
@@ -85,13 +238,18 @@ namespace dd {
         void reset() {
             clearUniqueTables();
             clearComputeTables();
+            gcStatistics            = {};
+            approximationStatistics = {};
         }
 
         // getter for qubits
         [[nodiscard]] auto qubits() const { return nqubits; }
 
+        [[nodiscard]] const PackageConfig& getConfig() const { return config; }
+
     private:
-        std::size_t nqubits;
+        std::size_t   nqubits;
+        PackageConfig config;
 
         ///
         /// Vector nodes, edges and quantum states
@@ -99,14 +257,24 @@ namespace dd {
     public:
         struct vNode {
             std::array<Edge<vNode>, RADIX> e{};    // edges out of this node
-            vNode*                         next{}; // used to link nodes in unique table
-            RefCount                       ref{};  // reference count
-            Qubit                          v{};    // variable index (nonterminal) value (-1 for terminal)
-
+            StoredPointer<vNode>           next{};    // used to link nodes in unique table
+            RefCount                       ref{};     // reference count
+            Qubit                          v{};       // variable index (nonterminal) value (-1 for terminal)
+            bool                           visited{}; // node is marked by a traversal (see VisitedNodes)
+
+#ifdef DD_PACKAGE_COMPACT_NODES
+            static constexpr std::uint32_t         TERMINAL_SLOT = 1;
+            static vNode&                          terminalNode;
+            constexpr static CompactPointer<vNode> terminal      = CompactPointer<vNode>::fromSlot(TERMINAL_SLOT);
+
+            static constexpr bool isTerminal(CompactPointer<vNode> p) { return p == terminal; }
+            static bool           isTerminal(const vNode* p) { return p == terminal; }
+#else
             static vNode            terminalNode;
             constexpr static vNode* terminal{&terminalNode};
 
             static constexpr bool isTerminal(const vNode* p) { return p == terminal; }
+#endif
         };
         using vEdge       = Edge<vNode>;
         using vCachedEdge = CachedEdge<vNode>;
@@ -271,16 +439,26 @@ namespace dd {
     public:
         struct mNode {
             std::array<Edge<mNode>, NEDGE> e{};           // edges out of this node
-            mNode*                         next{};        // used to link nodes in unique table
+            StoredPointer<mNode>           next{};        // used to link nodes in unique table
             RefCount                       ref{};         // reference count
             Qubit                          v{};           // variable index (nonterminal) value (-1 for terminal)
-            bool                           symm  = false; // node is symmetric
-            bool                           ident = false; // node resembles identity
-
+            bool                           symm    = false; // node is symmetric
+            bool                           ident   = false; // node resembles identity
+            bool                           visited = false; // node is marked by a traversal (see VisitedNodes)
+
+#ifdef DD_PACKAGE_COMPACT_NODES
+            static constexpr std::uint32_t         TERMINAL_SLOT = 1;
+            static mNode&                          terminalNode;
+            constexpr static CompactPointer<mNode> terminal      = CompactPointer<mNode>::fromSlot(TERMINAL_SLOT);
+
+            static constexpr bool isTerminal(CompactPointer<mNode> p) { return p == terminal; }
+            static bool           isTerminal(const mNode* p) { return p == terminal; }
+#else
             static mNode            terminalNode;
             constexpr static mNode* terminal{&terminalNode};
 
             static constexpr bool isTerminal(const mNode* p) { return p == terminal; }
+#endif
         };
         using mEdge       = Edge<mNode>;
         using mCachedEdge = CachedEdge<mNode>;
@@ -314,7 +492,7 @@ namespace dd {
                     maxc   = e.p->e[i].w;
                 } else {
                     auto mag = ComplexNumbers::mag2(e.p->e[i].w);
-                    if (mag - max > ComplexTable<>::tolerance()) {
+                    if (mag - max > cn.getLookupTolerance()) {
                         argmax = static_cast<decltype(argmax)>(i);
                         max    = mag;
                         maxc   = e.p->e[i].w;
@@ -332,7 +510,10 @@ namespace dd {
             }
 
             auto r = e;
-            // divide each entry by max
+            // divide each entry by max. The resulting weights are collected (the slot of the max holding the
+            // weight of the normalized edge) and looked up in the complex table in one batch.
+            std::array<ComplexValue, NEDGE> weights{};
+            std::array<bool, NEDGE>         pending{};
             for (auto i = 0U; i < NEDGE; ++i) {
                 if (static_cast<decltype(argmax)>(i) == argmax) {
                     if (cached) {
@@ -346,7 +527,8 @@ namespace dd {
                         } else {
                             auto c = cn.getTemporary();
                             ComplexNumbers::mul(c, r.w, maxc);
-                            r.w = cn.lookup(c);
+                            weights[i] = {CTEntry::val(c.r), CTEntry::val(c.i)};
+                            pending[i] = true;
                         }
                     }
                     r.p->e[i].w = Complex::one;
@@ -364,9 +546,28 @@ namespace dd {
                         r.p->e[i].w = Complex::one;
                     auto c = cn.getTemporary();
                     ComplexNumbers::div(c, r.p->e[i].w, maxc);
-                    r.p->e[i].w = cn.lookup(c);
+                    weights[i] = {CTEntry::val(c.r), CTEntry::val(c.i)};
+                    pending[i] = true;
                 }
             }
+
+            const auto interned = cn.lookup(weights);
+            for (auto i = 0U; i < NEDGE; ++i) {
+                if (!pending[i]) {
+                    continue;
+                }
+                if (static_cast<decltype(argmax)>(i) == argmax) {
+                    r.w = interned[i];
+                } else if (interned[i] == Complex::zero) {
+                    // weights may vanish within the lookup tolerance of the package
+                    r.p->e[i] = mEdge::zero;
+                } else {
+                    r.p->e[i].w = interned[i];
+                }
+            }
+            if (r.w == Complex::zero) {
+                return mEdge::zero;
+            }
             return r;
         }
 
@@ -377,7 +578,20 @@ namespace dd {
         mEdge makeGateDD(const std::array<ComplexValue, NEDGE>& mat, QubitCount n, const Control& control, Qubit target, std::size_t start = 0) {
             return makeGateDD(mat, n, Controls{control}, target, start);
         }
+        // gate DDs are cached in the gate table (see GateTable)
         mEdge makeGateDD(const std::array<ComplexValue, NEDGE>& mat, QubitCount n, const Controls& controls, Qubit target, std::size_t start = 0) {
+            GateTable<mEdge>::Matrix key{};
+            std::copy(mat.begin(), mat.end(), key.begin());
+            if (const auto cached = gateTable.lookup(key, n, start, controls, target, -1); cached.p != nullptr) {
+                return cached;
+            }
+            const auto e = buildGateDD(mat, n, controls, target, start);
+            gateTable.insert(key, n, start, controls, target, -1, e);
+            return e;
+        }
+
+    private:
+        mEdge buildGateDD(const std::array<ComplexValue, NEDGE>& mat, QubitCount n, const Controls& controls, Qubit target, std::size_t start) {
             if (n + start > nqubits) {
                 throw std::runtime_error("Requested gate with " +
                                          std::to_string(n + start) +
@@ -398,20 +612,23 @@ namespace dd {
             //process lines below target
             auto z = static_cast<Qubit>(start);
             for (; z < target; z++) {
+                // the nodes of all four submatrices are created at once
+                std::array<std::array<mEdge, NEDGE>, NEDGE> successors{};
                 for (auto i1 = 0U; i1 < RADIX; i1++) {
                     for (auto i2 = 0U; i2 < RADIX; i2++) {
                         auto i = i1 * RADIX + i2;
                         if (it != controls.end() && it->qubit == z) {
                             if (it->type == Control::Type::neg) { // neg. control
-                                em[i] = makeDDNode(z, std::array{em[i], mEdge::zero, mEdge::zero, (i1 == i2) ? makeIdent(static_cast<Qubit>(start), static_cast<Qubit>(z - 1)) : mEdge::zero});
+                                successors[i] = std::array{em[i], mEdge::zero, mEdge::zero, (i1 == i2) ? makeIdent(static_cast<Qubit>(start), static_cast<Qubit>(z - 1)) : mEdge::zero};
                             } else { // pos. control
-                                em[i] = makeDDNode(z, std::array{(i1 == i2) ? makeIdent(static_cast<Qubit>(start), static_cast<Qubit>(z - 1)) : mEdge::zero, mEdge::zero, mEdge::zero, em[i]});
+                                successors[i] = std::array{(i1 == i2) ? makeIdent(static_cast<Qubit>(start), static_cast<Qubit>(z - 1)) : mEdge::zero, mEdge::zero, mEdge::zero, em[i]};
                             }
                         } else { // not connected
-                            em[i] = makeDDNode(z, std::array{em[i], mEdge::zero, mEdge::zero, em[i]});
+                            successors[i] = std::array{em[i], mEdge::zero, mEdge::zero, em[i]};
                         }
                     }
                 }
+                em = makeDDNodes(z, successors);
                 if (it != controls.end() && it->qubit == z) {
                     ++it;
                 }
@@ -437,58 +654,144 @@ namespace dd {
             return e;
         }
 
-        mEdge makeSWAPDD(QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
-            auto c = controls;
-            c.insert(Control{target0});
-            mEdge e = makeGateDD(Xmat, n, c, target1, start);
-            c.erase(Control{target0});
-            c.insert(Control{target1});
-            e = multiply(e, multiply(makeGateDD(Xmat, n, c, target0, start), e));
+        // look up a two-qubit gate in the gate table and build it with `build` if it is not cached yet
+        template<class Build>
+        mEdge makeCachedTwoQubitGateDD(const TwoQubitGateMatrix& mat, QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start, Build&& build) {
+            GateTable<mEdge>::Matrix key{};
+            for (std::size_t row = 0; row < NEDGE; ++row) {
+                std::copy(mat[row].begin(), mat[row].end(), key.begin() + static_cast<std::ptrdiff_t>(row * NEDGE));
+            }
+            if (const auto cached = gateTable.lookup(key, n, start, controls, target0, target1); cached.p != nullptr) {
+                return cached;
+            }
+            const mEdge e = build();
+            gateTable.insert(key, n, start, controls, target0, target1, e);
             return e;
         }
 
-        mEdge makePeresDD(QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
-            auto c = controls;
-            c.insert(Control{target1});
-            mEdge e = makeGateDD(Xmat, n, c, target0, start);
-            e       = multiply(makeGateDD(Xmat, n, controls, target1, start), e);
+        mEdge buildTwoQubitGateDD(const TwoQubitGateMatrix& mat, QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start) {
+            if (n + start > nqubits) {
+                throw std::runtime_error("Requested gate with " +
+                                         std::to_string(n + start) +
+                                         " qubits, but current package configuration only supports up to " +
+                                         std::to_string(nqubits) +
+                                         " qubits. Please allocate a larger package instance.");
+            }
+            if (target0 == target1 || controls.count(target0) > 0 || controls.count(target1) > 0) {
+                throw std::invalid_argument("Targets " + std::to_string(target0) + " and " + std::to_string(target1) + " of a two-qubit gate must be distinct from each other and from the controls.");
+            }
+            const auto lower = std::min(target0, target1);
+            const auto upper = std::max(target0, target1);
+
+            // submatrices for all pairs of rows and columns of the targets' basis states
+            std::array<std::array<mEdge, NEDGE>, NEDGE> em{};
+            for (auto row = 0U; row < NEDGE; ++row) {
+                for (auto col = 0U; col < NEDGE; ++col) {
+                    const auto& value = mat[row][col];
+                    em[row][col]      = (value.r == 0 && value.i == 0) ? mEdge::zero : mEdge::terminal(cn.lookup(value));
+                }
+            }
+
+            // lines below a target (`diagonal` tells whether the submatrix is on the diagonal, i.e., is the identity
+            // if the controls are not satisfied)
+            auto       it      = controls.begin();
+            auto       z       = static_cast<Qubit>(start);
+            const auto extend  = [&](const mEdge& sub, bool diagonal) {
+                if (it != controls.end() && it->qubit == z) {
+                    const auto ident = diagonal ? makeIdent(static_cast<Qubit>(start), static_cast<Qubit>(z - 1)) : mEdge::zero;
+                    if (it->type == Control::Type::neg) {
+                        return std::array{sub, mEdge::zero, mEdge::zero, ident};
+                    }
+                    return std::array{ident, mEdge::zero, mEdge::zero, sub};
+                }
+                return std::array{sub, mEdge::zero, mEdge::zero, sub};
+            };
+            const auto advance = [&]() {
+                if (it != controls.end() && it->qubit == z) {
+                    ++it;
+                }
+            };
+            for (; z < lower; z++) {
+                std::array<std::array<mEdge, NEDGE>, NEDGE * NEDGE> successors{};
+                for (auto i = 0U; i < NEDGE * NEDGE; ++i) {
+                    successors[i] = extend(em[i / NEDGE][i % NEDGE], i / NEDGE == i % NEDGE);
+                }
+                const auto nodes = makeDDNodes(z, successors);
+                for (auto i = 0U; i < NEDGE * NEDGE; ++i) {
+                    em[i / NEDGE][i % NEDGE] = nodes[i];
+                }
+                advance();
+            }
+
+            // lower target line: the submatrices are combined for all pairs of row and column values of the upper target
+            const auto index = [lowerIsFirst = lower == target0](std::size_t upperValue, std::size_t lowerValue) {
+                return lowerIsFirst ? RADIX * upperValue + lowerValue : RADIX * lowerValue + upperValue;
+            };
+            std::array<std::array<mEdge, NEDGE>, NEDGE> lowerEdges{};
+            for (auto i = 0U; i < NEDGE; ++i) {
+                for (auto j = 0U; j < NEDGE; ++j) {
+                    lowerEdges[i][j] = em[index(i / RADIX, j / RADIX)][index(i % RADIX, j % RADIX)];
+                }
+            }
+            auto sub = makeDDNodes(z, lowerEdges);
+            for (z++; z < upper; z++) {
+                std::array<std::array<mEdge, NEDGE>, NEDGE> successors{};
+                for (auto i = 0U; i < NEDGE; ++i) {
+                    successors[i] = extend(sub[i], i / RADIX == i % RADIX);
+                }
+                sub = makeDDNodes(z, successors);
+                advance();
+            }
+
+            // upper target line
+            auto e = makeDDNode(z, sub);
+
+            //process lines above the targets
+            for (; z < static_cast<Qubit>(n - 1 + start); z++) {
+                auto q = static_cast<Qubit>(z + 1);
+                if (it != controls.end() && it->qubit == q) {
+                    if (it->type == Control::Type::neg) { // neg. control
+                        e = makeDDNode(q, std::array{e, mEdge::zero, mEdge::zero, makeIdent(static_cast<Qubit>(start), static_cast<Qubit>(q - 1))});
+                    } else { // pos. control
+                        e = makeDDNode(q, std::array{makeIdent(static_cast<Qubit>(start), static_cast<Qubit>(q - 1)), mEdge::zero, mEdge::zero, e});
+                    }
+                    ++it;
+                } else { // not connected
+                    e = makeDDNode(q, std::array{e, mEdge::zero, mEdge::zero, e});
+                }
+            }
             return e;
         }
 
+    public:
+        // build matrix representation for a (controlled) two-qubit gate on an n-qubit circuit. The rows and columns of
+        // `mat` are indexed by 2 * b1 + b0, where b0 and b1 are the values of `target0` and `target1`, respectively.
+        // The operator is constructed level by level as for single-qubit gates and cached in the gate table.
+        mEdge makeTwoQubitGateDD(const TwoQubitGateMatrix& mat, QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
+            return makeCachedTwoQubitGateDD(mat, n, controls, target0, target1, start, [&]() { return buildTwoQubitGateDD(mat, n, controls, target0, target1, start); });
+        }
+        mEdge makeTwoQubitGateDD(const TwoQubitGateMatrix& mat, QubitCount n, Qubit target0, Qubit target1, std::size_t start = 0) {
+            return makeTwoQubitGateDD(mat, n, Controls{}, target0, target1, start);
+        }
+
+        mEdge makeSWAPDD(QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
+            return makeTwoQubitGateDD(SWAPmat, n, controls, target0, target1, start);
+        }
+
+        mEdge makePeresDD(QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
+            return makeTwoQubitGateDD(Peresmat, n, controls, target0, target1, start);
+        }
+
         mEdge makePeresdagDD(QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
-            mEdge e = makeGateDD(Xmat, n, controls, target1, start);
-            auto  c = controls;
-            c.insert(Control{target1});
-            e = multiply(makeGateDD(Xmat, n, c, target0, start), e);
-            return e;
+            return makeTwoQubitGateDD(Peresdagmat, n, controls, target0, target1, start);
         }
 
         mEdge makeiSWAPDD(QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
-            mEdge e = makeGateDD(Smat, n, controls, target1, start);              // S q[1]
-            e       = multiply(e, makeGateDD(Smat, n, controls, target0, start)); // S q[0]
-            e       = multiply(e, makeGateDD(Hmat, n, controls, target0, start)); // H q[0]
-            auto c  = controls;
-            c.insert(Control{target0});
-            e = multiply(e, makeGateDD(Xmat, n, c, target1, start)); // CX q[0], q[1]
-            c.erase(Control{target0});
-            c.insert(Control{target1});
-            e = multiply(e, makeGateDD(Xmat, n, c, target0, start));        // CX q[1], q[0]
-            e = multiply(e, makeGateDD(Hmat, n, controls, target1, start)); // H q[1]
-            return e;
+            return makeTwoQubitGateDD(iSWAPmat, n, controls, target0, target1, start);
         }
 
         mEdge makeiSWAPinvDD(QubitCount n, const Controls& controls, Qubit target0, Qubit target1, std::size_t start = 0) {
-            mEdge e = makeGateDD(Hmat, n, controls, target1, start); // H q[1]
-            auto  c = controls;
-            c.insert(Control{target1});
-            e = multiply(e, makeGateDD(Xmat, n, c, target0, start)); // CX q[1], q[0]
-            c.erase(Control{target1});
-            c.insert(Control{target0});
-            e = multiply(e, makeGateDD(Xmat, n, c, target1, start));           // CX q[0], q[1]
-            e = multiply(e, makeGateDD(Hmat, n, controls, target0, start));    // H q[0]
-            e = multiply(e, makeGateDD(Sdagmat, n, controls, target0, start)); // Sdag q[0]
-            e = multiply(e, makeGateDD(Sdagmat, n, controls, target1, start)); // Sdag q[1]
-            return e;
+            return makeTwoQubitGateDD(iSWAPinvmat, n, controls, target0, target1, start);
         }
 
     private:
@@ -528,11 +831,17 @@ namespace dd {
         void decRef(const Edge<Node>& e) {
             getUniqueTable<Node>().decRef(e);
         }
+        // release the reference to `oldRoot` in favor of `newRoot` without touching nodes shared by both
+        template<class Node>
+        void swapRoots(const Edge<Node>& oldRoot, const Edge<Node>& newRoot) {
+            getUniqueTable<Node>().swapRoots(oldRoot, newRoot);
+        }
 
         UniqueTable<vNode> vUniqueTable{nqubits};
         UniqueTable<mNode> mUniqueTable{nqubits};
 
         bool garbageCollect(bool force = false) {
+            gcStatistics.calls++;
             // return immediately if no table needs collection
             if (!force &&
                 !vUniqueTable.possiblyNeedsCollection() &&
@@ -540,19 +849,42 @@ namespace dd {
                 !cn.complexTable.possiblyNeedsCollection()) {
                 return false;
             }
+            const auto start  = std::chrono::steady_clock::now();
+            const bool forced = force;
 
-            auto cCollect = cn.garbageCollect(force);
-            if (cCollect > 0) {
-                // Collecting garbage in the complex numbers table requires collecting the node tables as well
-                force = true;
+            if (config.autoResizeComputeTables) {
+                growComputeTables();
+            }
+
+            std::size_t cCollect = 0;
+            std::size_t mCollect = 0;
+            std::size_t vCollect = 0;
+            if (config.incrementalGarbageCollection && !force) {
+                // Unreferenced nodes may keep pointing to collected complex numbers. The unique tables only match such
+                // a node by a lookup with the very same pointers, i.e., for the number now stored there. Any cached
+                // edge or result involving such a node, however, may now refer to a different value.
+                const auto budget = config.garbageCollectionBudget;
+                cCollect          = cn.complexTable.garbageCollectIncrementally(budget);
+                mCollect          = mUniqueTable.collectCandidates(budget);
+                vCollect          = vUniqueTable.collectCandidates(budget);
+                if (cCollect > 0) {
+                    clearComputeTables();
+                }
+            } else {
+                cCollect = cn.garbageCollect(force);
+                if (cCollect > 0) {
+                    // Collecting garbage in the complex numbers table requires collecting the node tables as well
+                    force = true;
+                }
+                mCollect = mUniqueTable.garbageCollect(force);
+                vCollect = vUniqueTable.garbageCollect(force);
             }
-            auto mCollect = mUniqueTable.garbageCollect(force);
-            auto vCollect = vUniqueTable.garbageCollect(force);
 
             // invalidate all compute tables involving vectors if any vector node has been collected
             if (vCollect > 0) {
                 vectorAdd.clear();
                 vectorInnerProduct.clear();
+                expectationValues.clear();
                 vectorKronecker.clear();
                 matrixVectorMultiplication.clear();
             }
@@ -565,8 +897,11 @@ namespace dd {
                 matrixVectorMultiplication.clear();
                 matrixMatrixMultiplication.clear();
                 toffoliTable.clear();
+                gateTable.clear();
                 clearIdentityTable();
                 noiseOperationTable.clear();
+                noiseChannels.clear();
+                expectationValues.clear();
             }
             // invalidate all compute tables where any component of the entry contains numbers from the complex table if any complex numbers were collected
             if (cCollect > 0) {
@@ -577,62 +912,145 @@ namespace dd {
                 vectorInnerProduct.clear();
                 vectorKronecker.clear();
                 matrixKronecker.clear();
+                toffoliTable.clear();
+                gateTable.clear();
                 noiseOperationTable.clear();
+                noiseChannels.clear();
+            }
+
+            const GarbageCollectionRun run{forced, vCollect, mCollect, cCollect, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)};
+            gcStatistics.runs++;
+            gcStatistics.collectedVectorNodes += run.collectedVectorNodes;
+            gcStatistics.collectedMatrixNodes += run.collectedMatrixNodes;
+            gcStatistics.collectedComplexNumbers += run.collectedComplexNumbers;
+            gcStatistics.time += run.duration;
+            gcStatistics.maxTime = std::max(gcStatistics.maxTime, run.duration);
+            if (gcCallback) {
+                gcCallback(run);
             }
             return vCollect > 0 || mCollect > 0 || cCollect > 0;
         }
 
+        // invoke `callback` after every garbage collection run (an empty function removes the callback)
+        void setGarbageCollectionCallback(std::function<void(const GarbageCollectionRun&)> callback) {
+            gcCallback = std::move(callback);
+        }
+
+        [[nodiscard]] const GarbageCollectionStatistics& getGarbageCollectionStatistics() const { return gcStatistics; }
+
         void clearUniqueTables() {
             vUniqueTable.clear();
             mUniqueTable.clear();
         }
 
+    private:
+        GarbageCollectionStatistics                       gcStatistics{};
+        std::function<void(const GarbageCollectionRun&)> gcCallback{};
+
+        // double the size of all compute tables that are too small for the current workload
+        void growComputeTables() {
+            const auto grow = [this](auto& table) {
+                table.growIfThrashing(config.resizeHitRatio, config.resizeFillFactor, config.maxComputeTableSize);
+            };
+            grow(vectorAdd);
+            grow(matrixAdd);
+            grow(matrixTranspose);
+            grow(conjugateMatrixTranspose);
+            grow(matrixVectorMultiplication);
+            grow(matrixMatrixMultiplication);
+            grow(vectorInnerProduct);
+            grow(expectationValues);
+            grow(vectorKronecker);
+            grow(matrixKronecker);
+            grow(noiseChannels);
+        }
+
+    public:
         // create a normalized DD node and return an edge pointing to it. The node is not recreated if it already exists.
         template<class Node>
         Edge<Node> makeDDNode(Qubit var, const std::array<Edge<Node>, std::tuple_size_v<decltype(Node::e)>>& edges, bool cached = false) {
-            auto&      uniqueTable = getUniqueTable<Node>();
-            Edge<Node> e{uniqueTable.getNode(), Complex::one};
-            e.p->v = var;
-            e.p->e = edges;
-
-            assert(e.p->ref == 0);
-            for ([[maybe_unused]] const auto& edge: edges)
-                assert(edge.p->v == var - 1 || edge.isTerminal());
-
-            // normalize it
-            e = normalize(e, cached);
-            assert(e.p->v == var || e.isTerminal());
+            auto& uniqueTable = getUniqueTable<Node>();
+            auto  e           = makeNormalizedNode(var, edges, cached);
 
             // look it up in the unique tables
             auto l = uniqueTable.lookup(e, false);
             assert(l.p->v == var || l.isTerminal());
 
-            // set specific node properties for matrices
             if constexpr (std::tuple_size_v<decltype(Node::e)> == NEDGE) {
-                if (l.p == e.p)
+                if (l.p == e.p && !uniqueTable.isConcurrent())
                     checkSpecialMatrices(l.p);
             }
 
             return l;
         }
 
+        // create several normalized DD nodes for the same variable (see makeDDNode). All nodes are normalized and their
+        // unique table buckets are prefetched before the first one is looked up, so that the cache misses overlap.
+        template<class Node, std::size_t N>
+        std::array<Edge<Node>, N> makeDDNodes(Qubit var, const std::array<std::array<Edge<Node>, std::tuple_size_v<decltype(Node::e)>>, N>& edges, bool cached = false) {
+            auto&                      uniqueTable = getUniqueTable<Node>();
+            std::array<Edge<Node>, N>  nodes{};
+            std::array<std::size_t, N> hashes{};
+            for (std::size_t k = 0; k < N; ++k) {
+                nodes[k]  = makeNormalizedNode(var, edges[k], cached);
+                hashes[k] = uniqueTable.prefetch(nodes[k].p);
+            }
+
+            for (std::size_t k = 0; k < N; ++k) {
+                auto l = uniqueTable.lookupHashed(nodes[k], hashes[k], false);
+                assert(l.p->v == var || l.isTerminal());
+
+                if constexpr (std::tuple_size_v<decltype(Node::e)> == NEDGE) {
+                    if (l.p == nodes[k].p && !uniqueTable.isConcurrent())
+                        checkSpecialMatrices(l.p);
+                }
+                nodes[k] = l;
+            }
+            return nodes;
+        }
+
         template<class Node>
         Edge<Node> deleteEdge(const Edge<Node>& e, dd::Qubit v, std::size_t edgeIdx) {
-            std::unordered_map<Node*, Edge<Node>> nodes{};
+            NodeMap<const Node*, Edge<Node>> nodes{};
             return deleteEdge(e, v, edgeIdx, nodes);
         }
 
     private:
+        // create a node with the given successors and normalize it (without looking it up in the unique table)
         template<class Node>
-        Edge<Node> deleteEdge(const Edge<Node>& e, dd::Qubit v, std::size_t edgeIdx, std::unordered_map<Node*, Edge<Node>>& nodes) {
+        Edge<Node> makeNormalizedNode(Qubit var, const std::array<Edge<Node>, std::tuple_size_v<decltype(Node::e)>>& edges, bool cached) {
+            auto&      uniqueTable = getUniqueTable<Node>();
+            Edge<Node> e{uniqueTable.getNode(), Complex::one};
+            e.p->v = var;
+            e.p->e = edges;
+
+            assert(e.p->ref == 0);
+            for ([[maybe_unused]] const auto& edge: edges)
+                assert(edge.p->v == var - 1 || edge.isTerminal());
+
+            // normalize it
+            e = normalize(e, cached);
+            assert(e.p->v == var || e.isTerminal());
+
+            // set specific node properties for matrices
+            // in concurrent mode, this has to happen before the node may be found by other threads
+            if constexpr (std::tuple_size_v<decltype(Node::e)> == NEDGE) {
+                if (uniqueTable.isConcurrent())
+                    checkSpecialMatrices(e.p);
+            }
+            return e;
+        }
+
+        template<class Node>
+        Edge<Node> deleteEdge(const Edge<Node>& e, dd::Qubit v, std::size_t edgeIdx, NodeMap<const Node*, Edge<Node>>& nodes) {
             if (e.p == nullptr || e.isTerminal()) {
                 return e;
             }
 
-            const auto& nodeit = nodes.find(e.p);
+            const auto* node = nodes.find(e.p);
             Edge<Node>  newedge{};
-            if (nodeit != nodes.end()) {
-                newedge = nodeit->second;
+            if (node != nullptr) {
+                newedge = *node;
             } else {
                 constexpr std::size_t     N = std::tuple_size_v<decltype(e.p->e)>;
                 std::array<Edge<Node>, N> edges{};
@@ -646,8 +1064,8 @@ namespace dd {
                     }
                 }
 
-                newedge    = makeDDNode(e.p->v, edges);
-                nodes[e.p] = newedge;
+                newedge = makeDDNode(e.p->v, edges);
+                nodes.try_emplace(e.p, newedge);
             }
 
             if (newedge.w.approximatelyOne()) {
@@ -661,6 +1079,133 @@ namespace dd {
             return newedge;
         }
 
+        ///
+        /// Approximation
+        ///
+    public:
+        // outcome of approximating a state (see Package::approximate)
+        struct Approximation {
+            vEdge       state{};
+            fp          fidelity     = 1.; // fidelity of the approximated state with respect to the original one
+            std::size_t removedEdges = 0;
+        };
+
+        // approximate a state by removing all edges whose contribution to the state, i.e., the squared norm of the
+        // part of the state reached through the edge, is less than `threshold` times the squared norm of the state.
+        // The remainder is rescaled to the norm of the original state. Since the removed parts are orthogonal to the
+        // remainder, the fidelity of the approximation is the share of the squared norm that is retained. If all of
+        // the state is removed, the zero edge is returned with fidelity 0. As for multiply, the result is not referenced.
+        Approximation approximate(const vEdge& state, fp threshold) {
+            if (state.isTerminal() || state.w.approximatelyZero() || threshold <= 0.) {
+                return {state, 1., 0};
+            }
+
+            NodeMap<const vNode*, fp> norms{};
+            const auto                total = assignProbabilities(state, norms);
+
+            // determine the nodes in topological order (predecessors precede their successors)
+            std::vector<vNode*> order{};
+            VisitedNodes<vNode> visited{};
+            collectNodes(state.p, visited, order);
+            std::reverse(order.begin(), order.end());
+
+            // propagate the squared norm of the paths reaching the nodes from the root down to the successors and
+            // mark the edges whose contribution falls below the threshold
+            NodeMap<const vNode*, fp>           incoming{order.size()};
+            NodeMap<const vNode*, std::uint8_t> removed{};
+            std::size_t                         removedEdges = 0;
+            incoming[state.p] = ComplexNumbers::mag2(state.w);
+            for (auto* p: order) {
+                const auto in = incoming[p];
+                if (in == 0.) {
+                    // all paths to this node have been removed
+                    continue;
+                }
+                for (std::size_t i = 0; i < RADIX; ++i) {
+                    const auto& edge = p->e[i];
+                    if (edge.w.approximatelyZero()) {
+                        continue;
+                    }
+                    const auto reaching     = in * ComplexNumbers::mag2(edge.w);
+                    const auto contribution = reaching * *norms.find(edge.p);
+                    if (contribution < threshold * total) {
+                        removed[p] |= static_cast<std::uint8_t>(1U << i);
+                        ++removedEdges;
+                    } else if (!edge.isTerminal()) {
+                        incoming[edge.p] += reaching;
+                    }
+                }
+            }
+            if (removedEdges == 0) {
+                return {state, 1., 0};
+            }
+
+            NodeMap<const vNode*, vEdge> nodes{};
+            auto                         result = approximateRebuild(state, removed, nodes);
+            if (result.w == Complex::zero) {
+                return {vEdge::zero, 0., removedEdges};
+            }
+
+            // the rebuilt DD represents the retained part of the state, whose squared norm determines the fidelity
+            NodeMap<const vNode*, fp> retainedNorms{};
+            const auto                retained = assignProbabilities(result, retainedNorms);
+            const auto                scale    = std::sqrt(total / retained);
+            auto                      w        = cn.getTemporary(CTEntry::val(result.w.r) * scale, CTEntry::val(result.w.i) * scale);
+            result.w                           = cn.lookup(w);
+            return {result, std::min(retained / total, static_cast<fp>(1)), removedEdges};
+        }
+
+        [[nodiscard]] const ApproximationStatistics& getApproximationStatistics() const { return approximationStatistics; }
+
+    private:
+        ApproximationStatistics approximationStatistics{};
+
+        void collectNodes(vNode* p, VisitedNodes<vNode>& visited, std::vector<vNode*>& order) {
+            if (vNode::isTerminal(p) || visited.contains(p)) {
+                return;
+            }
+            visited.insert(p);
+            for (const auto& edge: p->e) {
+                if (!edge.w.approximatelyZero()) {
+                    collectNodes(edge.p, visited, order);
+                }
+            }
+            order.push_back(p);
+        }
+
+        vEdge approximateRebuild(const vEdge& e, const NodeMap<const vNode*, std::uint8_t>& removed, NodeMap<const vNode*, vEdge>& nodes) {
+            if (e.isTerminal() || e.w.approximatelyZero()) {
+                return e;
+            }
+
+            vEdge       newedge{};
+            const auto* node = nodes.find(e.p);
+            if (node != nullptr) {
+                newedge = *node;
+            } else {
+                const auto*              it   = removed.find(e.p);
+                const auto               mask = it == nullptr ? 0U : *it;
+                std::array<vEdge, RADIX> edges{};
+                for (std::size_t i = 0; i < RADIX; ++i) {
+                    edges[i] = (mask & (1U << i)) != 0U ? vEdge::zero : approximateRebuild(e.p->e[i], removed, nodes);
+                }
+                newedge = makeDDNode(e.p->v, edges);
+                nodes.try_emplace(e.p, newedge);
+            }
+
+            if (newedge.w == Complex::zero) {
+                return vEdge::zero;
+            }
+            if (newedge.w.approximatelyOne()) {
+                newedge.w = e.w;
+            } else {
+                auto w = cn.getTemporary();
+                dd::ComplexNumbers::mul(w, newedge.w, e.w);
+                newedge.w = cn.lookup(w);
+            }
+            return newedge;
+        }
+
         ///
         /// Compute table definitions
         ///
@@ -673,14 +1218,118 @@ namespace dd {
             matrixMatrixMultiplication.clear();
             matrixVectorMultiplication.clear();
             vectorInnerProduct.clear();
+            expectationValues.clear();
             vectorKronecker.clear();
             matrixKronecker.clear();
 
             toffoliTable.clear();
+            gateTable.clear();
 
             clearIdentityTable();
 
             noiseOperationTable.clear();
+            noiseChannels.clear();
+        }
+
+        ///
+        /// Parallel execution
+        ///
+    public:
+        static constexpr QubitCount defaultParallelDepth = 3;
+
+        // use `nthreads` threads (including the calling one) for additions and multiplications. The sub-computations
+        // of the topmost `depth` qubits are executed as tasks on a work-stealing thread pool, while the remaining
+        // levels are handled sequentially by the thread executing the respective task. nthreads <= 1 restores
+        // sequential execution.
+        void setParallelism(std::size_t nthreads, QubitCount depth = defaultParallelDepth) {
+            if (nthreads <= 1) {
+                pool.reset();
+            } else if (pool == nullptr || pool->size() != nthreads) {
+                pool.reset(); // join the old worker threads first
+                pool = std::make_unique<ThreadPool>(nthreads);
+            }
+            parallelDepth = depth;
+        }
+        [[nodiscard]] std::size_t getParallelism() const { return pool == nullptr ? 1 : pool->size(); }
+        [[nodiscard]] QubitCount  getParallelDepth() const { return parallelDepth; }
+
+    private:
+        std::unique_ptr<ThreadPool> pool{};
+        QubitCount                  parallelDepth  = defaultParallelDepth;
+        bool                        parallelRegion = false;
+        Qubit                       parallelCutoff = 0;
+
+        // whether an operation whose topmost variable is `var` shall be executed in parallel
+        [[nodiscard]] bool startsParallelRegion(Qubit var, Qubit start) const {
+            return pool != nullptr && !parallelRegion && start == 0 && var >= static_cast<Qubit>(parallelDepth);
+        }
+
+        // whether the sub-computations of a node with variable `var` shall be spawned as tasks
+        [[nodiscard]] bool spawnsTasks(Qubit var) const {
+            return parallelRegion && var > parallelCutoff;
+        }
+
+        // execute f() with all data structures involved in additions and multiplications switched to concurrent operation
+        template<class F>
+        auto inParallelRegion(Qubit var, const F& f) {
+            // identity DDs are stored lazily in the identity table, which cannot be done concurrently
+            for (Qubit q = 0; q <= var; ++q) {
+                makeIdent(0, q);
+            }
+
+            const auto nthreads = pool->size();
+            cn.enableConcurrency(nthreads);
+            vUniqueTable.enableConcurrency(nthreads);
+            mUniqueTable.enableConcurrency(nthreads);
+            vectorAdd.enableConcurrency(nthreads);
+            matrixAdd.enableConcurrency(nthreads);
+            matrixTranspose.enableConcurrency(nthreads);
+            matrixVectorMultiplication.enableConcurrency(nthreads);
+            matrixMatrixMultiplication.enableConcurrency(nthreads);
+            parallelCutoff = static_cast<Qubit>(var - parallelDepth);
+            parallelRegion = true;
+
+            const auto leaveParallelRegion = [this]() {
+                parallelRegion = false;
+                matrixMatrixMultiplication.disableConcurrency();
+                matrixVectorMultiplication.disableConcurrency();
+                matrixTranspose.disableConcurrency();
+                matrixAdd.disableConcurrency();
+                vectorAdd.disableConcurrency();
+                mUniqueTable.disableConcurrency();
+                vUniqueTable.disableConcurrency();
+                cn.disableConcurrency();
+            };
+
+            try {
+                auto result = f();
+                leaveParallelRegion();
+                return result;
+            } catch (...) {
+                leaveParallelRegion();
+                throw;
+            }
+        }
+
+        // evaluate f(0), ..., f(M-1) as tasks. Cached weights of the results are moved to the complex cache of the calling thread.
+        template<class Node, std::size_t M, class F>
+        void evaluateTasks(std::array<Edge<Node>, M>& results, const F& f) {
+            std::array<ComplexValue, M> weights{};
+            std::array<bool, M>         cached{};
+            pool->parallelFor<M>([&](std::size_t t) {
+                results[t] = f(t);
+                auto& w    = results[t].w;
+                if (w != Complex::zero && w != Complex::one) {
+                    weights[t] = {CTEntry::val(w.r), CTEntry::val(w.i)};
+                    cached[t]  = true;
+                    cn.returnToCache(w);
+                }
+            });
+            for (std::size_t t = 0; t < M; ++t) {
+                if (cached[t]) {
+                    results[t].w = cn.getCached(weights[t]);
+                }
+            }
         }
 
         ///
@@ -747,10 +1396,10 @@ namespace dd {
         }
 
     private:
-        double assignProbabilities(const vEdge& edge, std::unordered_map<vNode*, double>& probs) {
-            auto it = probs.find(edge.p);
-            if (it != probs.end()) {
-                return ComplexNumbers::mag2(edge.w) * it->second;
+        fp assignProbabilities(const vEdge& edge, NodeMap<const vNode*, fp>& probs) {
+            const auto* it = probs.find(edge.p);
+            if (it != nullptr) {
+                return ComplexNumbers::mag2(edge.w) * *it;
             }
             double sum;
             if (edge.isTerminal()) {
@@ -759,16 +1408,151 @@ namespace dd {
                 sum = assignProbabilities(edge.p->e.at(0), probs) + assignProbabilities(edge.p->e.at(1), probs);
             }
 
-            probs.insert({edge.p, sum});
+            probs.try_emplace(edge.p, sum);
 
             return ComplexNumbers::mag2(edge.w) * sum;
         }
 
+    public:
+        // number of chunks into which the shots of `sample` are split. Each chunk uses its own generator seeded from the
+        // generator passed to `sample`, so that the histogram does not depend on the number of threads.
+        static constexpr std::size_t SAMPLING_CHUNKS = 16;
+
+        // draw `shots` samples from measuring all qubits of the state `rootEdge` without collapsing it. The branching
+        // probabilities of all nodes are determined once, afterwards every shot is a single walk from the root to the
+        // terminal. The chunks of shots are drawn in parallel if parallel execution is enabled (see setParallelism).
+        std::map<std::string, std::size_t> sample(const vEdge& rootEdge, std::size_t shots, std::mt19937_64& mt, fp epsilon = 0.001) {
+            if (std::abs(ComplexNumbers::mag2(rootEdge.w) - 1.0L) > epsilon) {
+                if (rootEdge.w.approximatelyZero()) {
+                    throw std::runtime_error("Numerical instabilities led to a 0-vector! Abort simulation!");
+                }
+                std::cerr << "WARNING in sample: numerical instability occurred during simulation: |alpha|^2 + |beta|^2 = "
+                          << ComplexNumbers::mag2(rootEdge.w) << ", but should be 1!\n";
+            }
+            if (rootEdge.isTerminal()) {
+                return {{std::string{}, shots}};
+            }
+
+            std::vector<SamplingNode>          nodes{};
+            std::vector<fp>                    norms{};
+            NodeMap<const vNode*, std::size_t> indices{};
+            const auto                         root = assignSamplingNodes(rootEdge.p, nodes, norms, indices).first;
+
+            std::array<std::mt19937_64::result_type, SAMPLING_CHUNKS> seeds{};
+            for (auto& seed: seeds) {
+                seed = mt();
+            }
+
+            // the outcome of every shot is packed into `words` words, bit v encoding the value of qubit v
+            const auto                 numberOfQubits = static_cast<std::size_t>(rootEdge.p->v) + 1;
+            const auto                 words          = (numberOfQubits + 63) / 64;
+            std::vector<std::uint64_t> outcomes(shots * words);
+
+            const auto drawChunk = [&](std::size_t chunk) {
+                std::mt19937_64                    gen(seeds[chunk]);
+                std::uniform_real_distribution<fp> dist(0.0, 1.0L);
+                const auto                         first = chunk * (shots / SAMPLING_CHUNKS) + std::min(chunk, shots % SAMPLING_CHUNKS);
+                const auto                         count = shots / SAMPLING_CHUNKS + (chunk < shots % SAMPLING_CHUNKS ? 1 : 0);
+                for (std::size_t shot = first; shot < first + count; ++shot) {
+                    auto* outcome = &outcomes[shot * words];
+                    for (auto index = root; index != SAMPLING_TERMINAL;) {
+                        const auto& node = nodes[index];
+                        if (dist(gen) < node.p0) {
+                            index = node.next[0];
+                        } else {
+                            const auto v = static_cast<std::size_t>(node.v);
+                            index        = node.next[1];
+                            outcome[v / 64] |= std::uint64_t{1} << (v % 64);
+                        }
+                    }
+                }
+            };
+            if (pool != nullptr) {
+                pool->parallelFor<SAMPLING_CHUNKS>(drawChunk);
+            } else {
+                for (std::size_t chunk = 0; chunk < SAMPLING_CHUNKS; ++chunk) {
+                    drawChunk(chunk);
+                }
+            }
+
+            // sorting the outcomes numerically also sorts their bitstrings, so equal outcomes are counted in a single pass
+            const auto compare = [&](std::size_t lhs, std::size_t rhs) {
+                for (auto w = words; w-- > 0;) {
+                    if (outcomes[lhs * words + w] != outcomes[rhs * words + w]) {
+                        return outcomes[lhs * words + w] < outcomes[rhs * words + w];
+                    }
+                }
+                return false;
+            };
+            std::vector<std::size_t> order(shots);
+            std::iota(order.begin(), order.end(), std::size_t{0});
+            std::sort(order.begin(), order.end(), compare);
+
+            std::map<std::string, std::size_t> histogram{};
+            for (std::size_t i = 0; i < shots;) {
+                auto j = i + 1;
+                while (j < shots && !compare(order[i], order[j])) {
+                    ++j;
+                }
+                std::string bitstring(numberOfQubits, '0');
+                for (std::size_t v = 0; v < numberOfQubits; ++v) {
+                    if (((outcomes[order[i] * words + v / 64] >> (v % 64)) & 1U) != 0) {
+                        bitstring[numberOfQubits - 1 - v] = '1';
+                    }
+                }
+                histogram.emplace_hint(histogram.end(), std::move(bitstring), j - i);
+                i = j;
+            }
+            return histogram;
+        }
+
+    private:
+        static constexpr std::size_t SAMPLING_TERMINAL = std::numeric_limits<std::size_t>::max();
+
+        struct SamplingNode {
+            fp                         p0{};   // probability of continuing with the 0-successor
+            std::array<std::size_t, 2> next{}; // indices of the successors or SAMPLING_TERMINAL
+            Qubit                      v{};
+        };
+
+        // store the branching probabilities of all nodes reachable from `p` in `nodes` and return the index of `p` together
+        // with the squared norm of the vector represented by `p`
+        std::pair<std::size_t, fp> assignSamplingNodes(const vNode* p, std::vector<SamplingNode>& nodes, std::vector<fp>& norms, NodeMap<const vNode*, std::size_t>& indices) {
+            if (p == vNode::terminal) {
+                return {SAMPLING_TERMINAL, 1.0};
+            }
+            if (const auto* it = indices.find(p); it != nullptr) {
+                return {*it, norms[*it]};
+            }
+
+            SamplingNode      node{};
+            std::array<fp, 2> branch{};
+            node.v = p->v;
+            for (std::size_t i = 0; i < 2; ++i) {
+                const auto& e = p->e[i];
+                if (e.w.approximatelyZero()) {
+                    node.next[i] = SAMPLING_TERMINAL;
+                    continue;
+                }
+                const auto [index, norm] = assignSamplingNodes(e.p, nodes, norms, indices);
+                node.next[i]             = index;
+                branch[i]                = ComplexNumbers::mag2(e.w) * norm;
+            }
+            const auto norm = branch[0] + branch[1];
+            node.p0         = norm > 0 ? branch[0] / norm : 0;
+
+            const auto index = nodes.size();
+            nodes.push_back(node);
+            norms.push_back(norm);
+            indices.try_emplace(p, index);
+            return {index, norm};
+        }
+
     public:
         char measureOneCollapsing(vEdge& root_edge, const Qubit index, const bool assumeProbabilityNormalization, std::mt19937_64& mt, fp epsilon = 0.001) {
-            std::map<vNode*, fp> probsMone;
-            std::set<vNode*>     visited;
-            std::queue<vNode*>   q;
+            NodeMap<const vNode*, fp> probsMone;
+            VisitedNodes<vNode>       visited;
+            std::queue<vNode*>        q;
 
             probsMone[root_edge.p] = ComplexNumbers::mag2(root_edge.w);
             visited.insert(root_edge.p);
@@ -782,24 +1566,22 @@ namespace dd {
                 if (!ptr->e.at(0).w.approximatelyZero()) {
                     const fp tmp1 = prob * ComplexNumbers::mag2(ptr->e.at(0).w);
 
-                    if (visited.find(ptr->e.at(0).p) != visited.end()) {
-                        probsMone[ptr->e.at(0).p] = probsMone[ptr->e.at(0).p] + tmp1;
-                    } else {
+                    if (visited.insert(ptr->e.at(0).p)) {
                         probsMone[ptr->e.at(0).p] = tmp1;
-                        visited.insert(ptr->e.at(0).p);
                         q.push(ptr->e.at(0).p);
+                    } else {
+                        probsMone[ptr->e.at(0).p] += tmp1;
                     }
                 }
 
                 if (!ptr->e.at(1).w.approximatelyZero()) {
                     const fp tmp1 = prob * ComplexNumbers::mag2(ptr->e.at(1).w);
 
-                    if (visited.find(ptr->e.at(1).p) != visited.end()) {
-                        probsMone[ptr->e.at(1).p] = probsMone[ptr->e.at(1).p] + tmp1;
-                    } else {
+                    if (visited.insert(ptr->e.at(1).p)) {
                         probsMone[ptr->e.at(1).p] = tmp1;
-                        visited.insert(ptr->e.at(1).p);
                         q.push(ptr->e.at(1).p);
+                    } else {
+                        probsMone[ptr->e.at(1).p] += tmp1;
                     }
                 }
             }
@@ -820,7 +1602,7 @@ namespace dd {
                     }
                 }
             } else {
-                std::unordered_map<vNode*, fp> probs;
+                NodeMap<const vNode*, fp> probs;
                 assignProbabilities(root_edge, probs);
 
                 while (!q.empty()) {
@@ -868,8 +1650,7 @@ namespace dd {
             Complex c = cn.getTemporary(std::sqrt(1.0 / normalizationFactor), 0);
             ComplexNumbers::mul(c, e.w, c);
             e.w = cn.lookup(c);
-            incRef(e);
-            decRef(root_edge);
+            swapRoots(root_edge, e);
             root_edge = e;
 
             return result;
@@ -879,8 +1660,8 @@ namespace dd {
         /// Addition
         ///
     public:
-        ComputeTable<vCachedEdge, vCachedEdge, vCachedEdge> vectorAdd{};
-        ComputeTable<mCachedEdge, mCachedEdge, mCachedEdge> matrixAdd{};
+        ComputeTable<vCachedEdge, vCachedEdge, vCachedEdge> vectorAdd{config.addTableSize};
+        ComputeTable<mCachedEdge, mCachedEdge, mCachedEdge> matrixAdd{config.addTableSize};
 
         template<class Node>
         [[nodiscard]] ComputeTable<CachedEdge<Node>, CachedEdge<Node>, CachedEdge<Node>>& getAddComputeTable();
@@ -889,7 +1670,20 @@ namespace dd {
         Edge add(const Edge& x, const Edge& y) {
             [[maybe_unused]] const auto before = cn.cacheCount();
 
-            auto result = add2(x, y);
+            Qubit var = -1;
+            if (x.p != nullptr && !x.isTerminal()) {
+                var = x.p->v;
+            }
+            if (y.p != nullptr && !y.isTerminal() && y.p->v > var) {
+                var = y.p->v;
+            }
+
+            Edge result{};
+            if (startsParallelRegion(var, 0)) {
+                result = inParallelRegion(var, [&]() { return add2(x, y); });
+            } else {
+                result = add2(x, y);
+            }
 
             if (result.w != Complex::zero) {
                 cn.returnToCache(result.w);
@@ -949,9 +1743,7 @@ namespace dd {
                 }
             }
 
-            constexpr std::size_t     N = std::tuple_size_v<decltype(x.p->e)>;
-            std::array<Edge<Node>, N> edge{};
-            for (auto i = 0U; i < N; i++) {
+            const auto addSuccessors = [&](std::size_t i) {
                 Edge<Node> e1{};
                 if (!x.isTerminal() && x.p->v == w) {
                     e1 = x.p->e[i];
@@ -979,7 +1771,7 @@ namespace dd {
                     }
                 }
 
-                edge[i] = add2(e1, e2);
+                auto sum = add2(e1, e2);
 
                 if (!x.isTerminal() && x.p->v == w && e1.w != Complex::zero) {
                     cn.returnToCache(e1.w);
@@ -988,6 +1780,17 @@ namespace dd {
                 if (!y.isTerminal() && y.p->v == w && e2.w != Complex::zero) {
                     cn.returnToCache(e2.w);
                 }
+                return sum;
+            };
+
+            constexpr std::size_t     N = std::tuple_size_v<decltype(x.p->e)>;
+            std::array<Edge<Node>, N> edge{};
+            if (spawnsTasks(w)) {
+                evaluateTasks(edge, addSuccessors);
+            } else {
+                for (auto i = 0U; i < N; i++) {
+                    edge[i] = addSuccessors(i);
+                }
             }
 
             auto e = makeDDNode(w, edge, true);
@@ -999,8 +1802,8 @@ namespace dd {
         /// Matrix (conjugate) transpose
         ///
     public:
-        UnaryComputeTable<mEdge, mEdge, 4096> matrixTranspose{};
-        UnaryComputeTable<mEdge, mEdge, 4096> conjugateMatrixTranspose{};
+        UnaryComputeTable<mEdge, mEdge, 4096> matrixTranspose{config.transposeTableSize};
+        UnaryComputeTable<mEdge, mEdge, 4096> conjugateMatrixTranspose{config.transposeTableSize};
 
         mEdge transpose(const mEdge& a) {
             if (a.p == nullptr || a.isTerminal() || a.p->symm) {
@@ -1070,8 +1873,8 @@ namespace dd {
         /// Multiplication
         ///
     public:
-        ComputeTable<mEdge, vEdge, vCachedEdge> matrixVectorMultiplication{};
-        ComputeTable<mEdge, mEdge, mCachedEdge> matrixMatrixMultiplication{};
+        ComputeTable<mEdge, vEdge, vCachedEdge> matrixVectorMultiplication{config.multiplicationTableSize};
+        ComputeTable<mEdge, mEdge, mCachedEdge> matrixMatrixMultiplication{config.multiplicationTableSize};
 
         template<class LeftOperandNode, class RightOperandNode>
         [[nodiscard]] ComputeTable<Edge<LeftOperandNode>, Edge<RightOperandNode>, CachedEdge<RightOperandNode>>& getMultiplicationComputeTable();
@@ -1088,7 +1891,12 @@ namespace dd {
                 var = y.p->v;
             }
 
-            auto e = multiply2(x, y, var, start);
+            RightOperand e{};
+            if (startsParallelRegion(var, start)) {
+                e = inParallelRegion(var, [&]() { return multiply2(x, y, var, start); });
+            } else {
+                e = multiply2(x, y, var, start);
+            }
 
             if (e.w != Complex::zero && e.w != Complex::one) {
                 cn.returnToCache(e.w);
@@ -1101,7 +1909,320 @@ namespace dd {
             return e;
         }
 
+        // apply a sequence of gates to an n-qubit state. Consecutive gates acting on disjoint qubits are combined into
+        // a single operation before it is applied to the state, and a gate acting on the same target with the same
+        // controls as one of the combined gates is fused with it. Intermediate results are not referenced, i.e.,
+        // garbage must not be collected while the batch is applied. As for multiply, the result is not referenced.
+        vEdge applyGates(const vEdge& state, const std::vector<GateOperation>& gates, QubitCount n) {
+            std::vector<Qubit> permutation{};
+            const auto         result = applyGates(state, gates, n, permutation);
+            return restoreOrder(result, permutation);
+        }
+
+        // apply a sequence of gates to an n-qubit state whose levels are permuted as given by `permutation` (the
+        // identity if it is empty, see Package::sift). The gates address qubits, and `permutation` is updated whenever
+        // intermediate states are reordered (see PackageConfig::reorderingNodeThreshold).
+        vEdge applyGates(const vEdge& state, const std::vector<GateOperation>& gates, QubitCount n, std::vector<Qubit>& permutation) {
+            checkPermutation(permutation, n);
+            std::vector<Qubit> levels(n);
+            const auto         invert = [&]() {
+                for (std::size_t level = 0; level < n; ++level) {
+                    levels[static_cast<std::size_t>(permutation[level])] = static_cast<Qubit>(level);
+                }
+            };
+            invert();
+
+            std::vector<GateOperation> block{};
+            std::vector<bool>          used(n, false);
+            vEdge                      result         = state;
+            auto                       nextReordering = config.reorderingNodeThreshold;
+
+            const auto flush = [&]() {
+                if (block.empty()) {
+                    return;
+                }
+                // the gates act on the levels of the qubits
+                for (auto& gate: block) {
+                    Controls controls{};
+                    for (const auto& control: gate.controls) {
+                        controls.insert({levels[static_cast<std::size_t>(control.qubit)], control.type});
+                    }
+                    gate.controls = std::move(controls);
+                    gate.target   = levels[static_cast<std::size_t>(gate.target)];
+                }
+                if (block.size() == 1) {
+                    // a single gate is applied without constructing its DD
+                    result = applyGate(result, block.front().matrix, block.front().controls, block.front().target);
+                } else {
+                    auto operation = makeGateDD(block.front().matrix, n, block.front().controls, block.front().target);
+                    for (auto it = std::next(block.begin()); it != block.end(); ++it) {
+                        operation = multiply(makeGateDD(it->matrix, n, it->controls, it->target), operation);
+                    }
+                    result = multiply(operation, result);
+                }
+                // intermediate results are not referenced, so the number of (active and inactive) nodes in the table
+                // bounds the size of the state from above and saves traversing it as long as the budget is not reached
+                if (config.approximationNodeBudget > 0 && vUniqueTable.getNodeCount() > config.approximationNodeBudget &&
+                    size(result) > config.approximationNodeBudget) {
+                    const auto approximation = approximate(result, config.approximationThreshold);
+                    result                   = approximation.state;
+                    approximationStatistics.runs++;
+                    approximationStatistics.removedEdges += approximation.removedEdges;
+                    approximationStatistics.fidelity *= approximation.fidelity;
+                }
+                if (nextReordering > 0 && vUniqueTable.getNodeCount() > nextReordering && size(result) > nextReordering) {
+                    result = sift(result, permutation);
+                    invert();
+                    nextReordering = std::max<std::size_t>(nextReordering, 2U * size(result));
+                }
+                block.clear();
+                std::fill(used.begin(), used.end(), false);
+            };
+
+            for (const auto& gate: gates) {
+                if (gate.target < 0 || static_cast<std::size_t>(gate.target) >= n) {
+                    throw std::invalid_argument("Gate target " + std::to_string(gate.target) + " is out of range for " + std::to_string(n) + " qubits.");
+                }
+                for (const auto& control: gate.controls) {
+                    if (control.qubit < 0 || static_cast<std::size_t>(control.qubit) >= n || control.qubit == gate.target) {
+                        throw std::invalid_argument("Control " + std::to_string(control.qubit) + " is invalid for a gate targeting qubit " + std::to_string(gate.target) + " of " + std::to_string(n) + " qubits.");
+                    }
+                }
+                // all other combined gates act on different qubits, so the gates commute and may be fused
+                auto fused = std::find_if(block.begin(), block.end(), [&gate](const auto& op) { return op.target == gate.target && op.controls == gate.controls; });
+                if (fused != block.end()) {
+                    fused->matrix = multiplyGateMatrices(gate.matrix, fused->matrix);
+                    continue;
+                }
+
+                const auto overlaps = used[static_cast<std::size_t>(gate.target)] ||
+                                      std::any_of(gate.controls.begin(), gate.controls.end(), [&used](const auto& c) { return used[static_cast<std::size_t>(c.qubit)]; });
+                if (overlaps) {
+                    flush();
+                }
+                used[static_cast<std::size_t>(gate.target)] = true;
+                for (const auto& control: gate.controls) {
+                    used[static_cast<std::size_t>(control.qubit)] = true;
+                }
+                block.push_back(gate);
+            }
+            flush();
+            return result;
+        }
+
+        // apply a (controlled) single-qubit gate to a state without constructing the gate's DD. Nodes are only rebuilt
+        // from the root down to the target, where the matrix is applied to the successors directly. Controls below the
+        // target additionally require the successors' parts satisfying these controls. As for multiply, the result is
+        // not referenced.
+        vEdge applyGate(const vEdge& x, const GateMatrix& mat, const Controls& controls, Qubit target) {
+            if (x.w == Complex::zero) {
+                return vEdge::zero;
+            }
+            const auto top = x.isTerminal() ? Qubit{-1} : x.p->v;
+            if (target < 0 || target > top) {
+                throw std::invalid_argument("Gate target " + std::to_string(target) + " is out of range for a state with " + std::to_string(top + 1) + " qubits.");
+            }
+            for (const auto& control: controls) {
+                if (control.qubit < 0 || control.qubit > top || control.qubit == target) {
+                    throw std::invalid_argument("Control " + std::to_string(control.qubit) + " is invalid for a gate targeting qubit " + std::to_string(target) + ".");
+                }
+            }
+            [[maybe_unused]] const auto before = cn.cacheCount();
+
+            GateKernel kernel{};
+            for (auto i = 0U; i < NEDGE; ++i) {
+                kernel.matrix[i] = cn.lookup(mat[i]);
+            }
+            kernel.controls = &controls;
+            kernel.target   = target;
+            if (!controls.empty() && controls.begin()->qubit < target) {
+                kernel.lowestControl = controls.begin()->qubit;
+                kernel.diagonal      = {cn.lookup(mat[0].r - 1., mat[0].i), cn.lookup(mat[3].r - 1., mat[3].i)};
+            }
+            appliedNodes.clear();
+            projectedNodes.clear();
+
+            auto e = applyGate2(x, kernel);
+            if (e.w != Complex::zero) {
+                cn.returnToCache(e.w);
+                e.w = cn.lookup(e.w);
+            }
+
+            [[maybe_unused]] const auto after = cn.cacheCount();
+            assert(before == after);
+            return e;
+        }
+
     private:
+        // gate applied by applyGate. With controls below the target, `diagonal` holds the matrix' diagonal minus one.
+        struct GateKernel {
+            std::array<Complex, NEDGE> matrix{};
+            std::array<Complex, RADIX> diagonal{};
+            const Controls*            controls      = nullptr;
+            Qubit                      target        = 0;
+            Qubit                      lowestControl = -1;
+        };
+
+        // results of applyGate for the nodes of the current state (with unit weight)
+        NodeMap<const vNode*, vCachedEdge> appliedNodes{};
+        NodeMap<const vNode*, vCachedEdge> projectedNodes{};
+
+        // whether successor `i` of a node of the given level satisfies the gate's control on this level (if any)
+        static bool satisfiesControl(const GateKernel& kernel, Qubit v, std::size_t i) {
+            const auto control = kernel.controls->find(v);
+            return control == kernel.controls->end() || (control->type == Control::Type::pos) == (i == 1);
+        }
+
+        // copy of an edge with a cached weight (or the zero edge)
+        vEdge cachedCopy(const vEdge& e) {
+            if (e.w.approximatelyZero()) {
+                return vEdge::zero;
+            }
+            return {e.p, cn.getCached(CTEntry::val(e.w.r), CTEntry::val(e.w.i))};
+        }
+
+        // edge to the node of `r` with its weight multiplied by `factor` (as a cached number)
+        vEdge scaledCopy(const vCachedEdge& r, const Complex& factor) {
+            if (r.w.approximatelyZero()) {
+                return vEdge::zero;
+            }
+            vEdge e{r.p, cn.getCached(r.w)};
+            ComplexNumbers::mul(e.w, e.w, factor);
+            if (e.w.approximatelyZero()) {
+                cn.returnToCache(e.w);
+                return vEdge::zero;
+            }
+            return e;
+        }
+
+        // create the node for the given successors (with cached weights) and memorize it for `p`
+        vEdge makeMemorizedNode(NodeMap<const vNode*, vCachedEdge>& memo, const vNode* p, const std::array<vEdge, RADIX>& edges) {
+            auto e = makeDDNode(p->v, edges, true);
+            if (e.w == Complex::zero) {
+                memo.try_emplace(p, vCachedEdge{e.p, ComplexValue{0., 0.}});
+                return vEdge::zero;
+            }
+            memo.try_emplace(p, vCachedEdge{e.p, e.w});
+            return e;
+        }
+
+        // alpha * a + beta * b with a cached weight
+        vEdge combine(const Complex& alpha, const vEdge& a, const Complex& beta, const vEdge& b) {
+            const auto scale = [this](const Complex& factor, const vEdge& e) {
+                if (factor == Complex::zero || e.w.approximatelyZero()) {
+                    return vEdge::zero;
+                }
+                return vEdge{e.p, cn.mulCached(factor, e.w)};
+            };
+            auto s = scale(alpha, a);
+            auto t = scale(beta, b);
+            auto r = add2(s, t);
+            if (s.w != Complex::zero) {
+                cn.returnToCache(s.w);
+            }
+            if (t.w != Complex::zero) {
+                cn.returnToCache(t.w);
+            }
+            return r;
+        }
+
+        vEdge applyGate2(const vEdge& x, const GateKernel& kernel) {
+            if (x.w.approximatelyZero()) {
+                return vEdge::zero;
+            }
+            if (const auto* it = appliedNodes.find(x.p); it != nullptr) {
+                return scaledCopy(*it, x.w);
+            }
+
+            const auto               v = x.p->v;
+            std::array<vEdge, RADIX> edges{};
+            if (v == kernel.target) {
+                const auto& a = x.p->e[0];
+                const auto& b = x.p->e[1];
+                if (kernel.lowestControl < 0) {
+                    edges = {combine(kernel.matrix[0], a, kernel.matrix[1], b), combine(kernel.matrix[2], a, kernel.matrix[3], b)};
+                } else {
+                    // the matrix only acts on the parts of the successors satisfying the controls below the target:
+                    // a' = a + (m00 - 1) P(a) + m01 P(b) and b' = b + m10 P(a) + (m11 - 1) P(b)
+                    auto       pa        = project(a, kernel);
+                    auto       pb        = project(b, kernel);
+                    const auto addToEdge = [this](const vEdge& e, vEdge&& delta) {
+                        auto sum = add2(e, delta);
+                        if (delta.w != Complex::zero) {
+                            cn.returnToCache(delta.w);
+                        }
+                        return sum;
+                    };
+                    edges = {addToEdge(a, combine(kernel.diagonal[0], pa, kernel.matrix[1], pb)),
+                             addToEdge(b, combine(kernel.matrix[2], pa, kernel.diagonal[1], pb))};
+                    if (pa.w != Complex::zero) {
+                        cn.returnToCache(pa.w);
+                    }
+                    if (pb.w != Complex::zero) {
+                        cn.returnToCache(pb.w);
+                    }
+                }
+            } else {
+                // successors not satisfying a control above the target remain unchanged
+                for (auto i = 0U; i < RADIX; ++i) {
+                    edges[i] = satisfiesControl(kernel, v, i) ? applyGate2(x.p->e[i], kernel) : cachedCopy(x.p->e[i]);
+                }
+            }
+
+            auto e = makeMemorizedNode(appliedNodes, x.p, edges);
+            return multiplyCachedWeight(e, x.w);
+        }
+
+        // part of a state satisfying the controls below the target (all other amplitudes are set to zero)
+        vEdge project(const vEdge& x, const GateKernel& kernel) {
+            if (x.w.approximatelyZero()) {
+                return vEdge::zero;
+            }
+            if (x.isTerminal() || x.p->v < kernel.lowestControl) {
+                return cachedCopy(x);
+            }
+            if (const auto* it = projectedNodes.find(x.p); it != nullptr) {
+                return scaledCopy(*it, x.w);
+            }
+
+            std::array<vEdge, RADIX> edges{};
+            for (auto i = 0U; i < RADIX; ++i) {
+                edges[i] = satisfiesControl(kernel, x.p->v, i) ? project(x.p->e[i], kernel) : vEdge::zero;
+            }
+            auto e = makeMemorizedNode(projectedNodes, x.p, edges);
+            return multiplyCachedWeight(e, x.w);
+        }
+
+        // multiply the cached weight of an edge by `factor`
+        vEdge multiplyCachedWeight(vEdge e, const Complex& factor) {
+            if (e.w == Complex::zero || factor == Complex::one) {
+                return e;
+            }
+            ComplexNumbers::mul(e.w, e.w, factor);
+            if (e.w.approximatelyZero()) {
+                cn.returnToCache(e.w);
+                return vEdge::zero;
+            }
+            return e;
+        }
+
+        // product a * b of two single-qubit gate matrices (given in row-major order)
+        static GateMatrix multiplyGateMatrices(const GateMatrix& a, const GateMatrix& b) {
+            GateMatrix result{};
+            for (std::size_t row = 0; row < RADIX; ++row) {
+                for (std::size_t col = 0; col < RADIX; ++col) {
+                    auto& c = result[row * RADIX + col];
+                    for (std::size_t k = 0; k < RADIX; ++k) {
+                        const auto& x = a[row * RADIX + k];
+                        const auto& y = b[k * RADIX + col];
+                        c.r += x.r * y.r - x.i * y.i;
+                        c.i += x.r * y.i + x.i * y.r;
+                    }
+                }
+            }
+            return result;
+        }
+
         template<class LeftOperandNode, class RightOperandNode>
         Edge<RightOperandNode> multiply2(const Edge<LeftOperandNode>& x, const Edge<RightOperandNode>& y, Qubit var, Qubit start = 0) {
             using LEdge      = Edge<LeftOperandNode>;
@@ -1184,27 +2305,40 @@ namespace dd {
             constexpr std::size_t ROWS = RADIX;
             constexpr std::size_t COLS = N == NEDGE ? RADIX : 1U;
 
+            const auto multiplySuccessors = [&](std::size_t i, std::size_t j, std::size_t k) {
+                LEdge e1{};
+                if (!x.isTerminal() && x.p->v == var) {
+                    e1 = x.p->e[ROWS * i + k];
+                } else {
+                    e1 = xCopy;
+                }
+
+                REdge e2{};
+                if (!y.isTerminal() && y.p->v == var) {
+                    e2 = y.p->e[j + COLS * k];
+                } else {
+                    e2 = yCopy;
+                }
+
+                return multiply2(e1, e2, static_cast<Qubit>(var - 1), start);
+            };
+
+            // in parallel mode, all products are computed as tasks before they are summed up
+            const bool                       parallel = spawnsTasks(var);
+            std::array<ResultEdge, N * ROWS> products{};
+            if (parallel) {
+                evaluateTasks(products, [&](std::size_t t) {
+                    return multiplySuccessors(t / ROWS / COLS, t / ROWS % COLS, t % ROWS);
+                });
+            }
+
             std::array<ResultEdge, N> edge{};
             for (auto i = 0U; i < ROWS; i++) {
                 for (auto j = 0U; j < COLS; j++) {
                     auto idx  = COLS * i + j;
                     edge[idx] = ResultEdge::zero;
                     for (auto k = 0U; k < ROWS; k++) {
-                        LEdge e1{};
-                        if (!x.isTerminal() && x.p->v == var) {
-                            e1 = x.p->e[ROWS * i + k];
-                        } else {
-                            e1 = xCopy;
-                        }
-
-                        REdge e2{};
-                        if (!y.isTerminal() && y.p->v == var) {
-                            e2 = y.p->e[j + COLS * k];
-                        } else {
-                            e2 = yCopy;
-                        }
-
-                        auto m = multiply2(e1, e2, static_cast<Qubit>(var - 1), start);
+                        auto m = parallel ? products[ROWS * idx + k] : multiplySuccessors(i, j, k);
 
                         if (k == 0 || edge[idx].w == Complex::zero) {
                             edge[idx] = m;
@@ -1240,7 +2374,7 @@ namespace dd {
         /// Inner product and fidelity
         ///
     public:
-        ComputeTable<vEdge, vEdge, vCachedEdge, 4096> vectorInnerProduct{};
+        ComputeTable<vEdge, vEdge, vCachedEdge, 4096> vectorInnerProduct{config.innerProductTableSize};
 
         ComplexValue innerProduct(const vEdge& x, const vEdge& y) {
             if (x.p == nullptr || y.p == nullptr || x.w.approximatelyZero() || y.w.approximatelyZero()) { // the 0 case
@@ -1307,26 +2441,131 @@ namespace dd {
                 } else {
                     e2 = yCopy;
                 }
-                auto cv = innerProduct(e1, e2, w);
-                sum.r += cv.r;
-                sum.i += cv.i;
+                auto cv = innerProduct(e1, e2, w);
+                sum.r += cv.r;
+                sum.i += cv.i;
+            }
+            r.p = vNode::terminal;
+            r.w = sum;
+
+            vectorInnerProduct.insert(xCopy, yCopy, r);
+            auto c = cn.getTemporary(sum);
+            ComplexNumbers::mul(c, c, x.w);
+            ComplexNumbers::mul(c, c, y.w);
+            return {CTEntry::val(c.r), CTEntry::val(c.i)};
+        }
+
+        ///
+        /// Expectation values
+        ///
+    public:
+        ComputeTable<mEdge, NodePair<vNode>, vCachedEdge, 4096> expectationValues{config.innerProductTableSize};
+
+        // expectation value <psi|O|psi> of an operator O, computed in a single recursion over O, the bra and the ket
+        // (without constructing O|psi>). Results are cached for triples of nodes in the compute table
+        // `expectationValues`.
+        ComplexValue expectationValue(const mEdge& op, const vEdge& state) {
+            if (op.w == Complex::zero || state.w == Complex::zero) {
+                return {0., 0.};
+            }
+            if (op.isTerminal() != state.isTerminal() || (!op.isTerminal() && op.p->v != state.p->v)) {
+                throw std::invalid_argument("Operator and state of an expectation value have to act on the same number of qubits.");
+            }
+            const auto value = expectationValue(op, state, state);
+            return {value.real(), value.imag()};
+        }
+
+        // expectation value <psi|P|psi> of a Pauli string P, where the i-th character (I, X, Y or Z) of `pauli`
+        // describes the operator acting on qubit i. No DD of the operator is constructed.
+        fp expectationValue(const std::string& pauli, const vEdge& state) {
+            if (state.w == Complex::zero) {
+                return 0.;
+            }
+            const auto levels = state.isTerminal() ? std::size_t{0} : static_cast<std::size_t>(state.p->v) + 1;
+            if (pauli.size() < levels || pauli.find_first_not_of("IXYZ") != std::string::npos) {
+                throw std::invalid_argument("Pauli string '" + pauli + "' has to consist of (at least) " + std::to_string(levels) + " characters I, X, Y or Z.");
+            }
+            NodeMap<NodePair<vNode>, std::complex<fp>> memo{};
+            return pauliExpectationValue(pauli, state, state, memo).real();
+        }
+
+    private:
+        static std::complex<fp> valueOf(const Complex& c) {
+            return {CTEntry::val(c.r), CTEntry::val(c.i)};
+        }
+
+        // <bra|op|ket>
+        std::complex<fp> expectationValue(const mEdge& op, const vEdge& bra, const vEdge& ket) {
+            if (op.w == Complex::zero || bra.w == Complex::zero || ket.w == Complex::zero) {
+                return 0.;
+            }
+            const auto weight = valueOf(op.w) * std::conj(valueOf(bra.w)) * valueOf(ket.w);
+            if (op.isTerminal()) {
+                assert(bra.isTerminal() && ket.isTerminal());
+                return weight;
+            }
+
+            const mEdge node{op.p, Complex::one};
+            auto        r = expectationValues.lookup(node, {bra.p, ket.p});
+            if (r.p != nullptr) {
+                return std::complex<fp>{r.w.r, r.w.i} * weight;
+            }
+
+            std::complex<fp> sum{};
+            for (auto i = 0U; i < RADIX; ++i) {
+                for (auto j = 0U; j < RADIX; ++j) {
+                    sum += expectationValue(op.p->e[RADIX * i + j], bra.p->e[i], ket.p->e[j]);
+                }
             }
-            r.p = vNode::terminal;
-            r.w = sum;
+            expectationValues.insert(node, {bra.p, ket.p}, {vNode::terminal, {sum.real(), sum.imag()}});
+            return sum * weight;
+        }
 
-            vectorInnerProduct.insert(xCopy, yCopy, r);
-            auto c = cn.getTemporary(sum);
-            ComplexNumbers::mul(c, c, x.w);
-            ComplexNumbers::mul(c, c, y.w);
-            return {CTEntry::val(c.r), CTEntry::val(c.i)};
+        // <bra|P|ket> for the Pauli operators of the levels of bra and ket, memorized for pairs of nodes
+        std::complex<fp> pauliExpectationValue(const std::string& pauli, const vEdge& bra, const vEdge& ket, NodeMap<NodePair<vNode>, std::complex<fp>>& memo) {
+            if (bra.w == Complex::zero || ket.w == Complex::zero) {
+                return 0.;
+            }
+            const auto weight = std::conj(valueOf(bra.w)) * valueOf(ket.w);
+            if (ket.isTerminal()) {
+                assert(bra.isTerminal());
+                return weight;
+            }
+
+            const NodePair<vNode> key{bra.p, ket.p};
+            if (const auto* it = memo.find(key); it != nullptr) {
+                return *it * weight;
+            }
+
+            const auto& b = bra.p->e;
+            const auto& k = ket.p->e;
+            const auto  f = [&](std::size_t i, std::size_t j) { return pauliExpectationValue(pauli, b[i], k[j], memo); };
+
+            std::complex<fp> sum{};
+            switch (pauli[static_cast<std::size_t>(ket.p->v)]) {
+                case 'X':
+                    sum = f(0, 1) + f(1, 0);
+                    break;
+                case 'Y':
+                    sum = std::complex<fp>{0., -1.} * f(0, 1) + std::complex<fp>{0., 1.} * f(1, 0);
+                    break;
+                case 'Z':
+                    sum = f(0, 0) - f(1, 1);
+                    break;
+                default:
+                    sum = f(0, 0) + f(1, 1);
+                    break;
+            }
+            memo.try_emplace(key, sum);
+            return sum * weight;
         }
 
         ///
         /// Kronecker/tensor product
         ///
     public:
-        ComputeTable<vEdge, vEdge, vCachedEdge, 4096> vectorKronecker{};
-        ComputeTable<mEdge, mEdge, mCachedEdge, 4096> matrixKronecker{};
+        ComputeTable<vEdge, vEdge, vCachedEdge, 4096> vectorKronecker{config.kroneckerTableSize};
+        ComputeTable<mEdge, mEdge, mCachedEdge, 4096> matrixKronecker{config.kroneckerTableSize};
 
         template<class Node>
         [[nodiscard]] ComputeTable<Edge<Node>, Edge<Node>, CachedEdge<Node>, 4096>& getKroneckerComputeTable();
@@ -1491,6 +2730,12 @@ namespace dd {
     public:
         ToffoliTable<mEdge> toffoliTable{};
 
+        ///
+        /// Gate DDs
+        ///
+    public:
+        GateTable<mEdge> gateTable{};
+
         ///
         /// Identity matrices
         ///
@@ -1538,27 +2783,109 @@ namespace dd {
     public:
         NoiseOperationTable<mEdge> noiseOperationTable{nqubits};
 
+        ComputeTable<mEdge, NoiseChannelOperation, mEdge, 4096> noiseChannels{config.noiseChannelTableSize};
+
+        // apply a single-qubit noise channel to a density matrix in a single pass. The channel acts on the 2x2 blocks
+        // [[A, B], [C, D]] of the submatrices at the target level as follows (p being the probability):
+        //  - depolarization:    [[(1-p)A + p/2 (A+D), (1-p)B], [(1-p)C, (1-p)D + p/2 (A+D)]]
+        //  - amplitude damping: [[A + pD, sqrt(1-p)B], [sqrt(1-p)C, (1-p)D]]
+        //  - phase flip:        [[A, (1-2p)B], [(1-2p)C, D]]
+        // This equals the sum of the Kraus operators' contributions K rho K^dagger, but only requires additions at the
+        // target level. Results are cached in the compute table `noiseChannels`. As for multiply, the result is not
+        // referenced.
+        mEdge applyNoiseChannel(const mEdge& rho, NoiseChannel channel, Qubit target, fp probability) {
+            if (probability < 0. || probability > 1.) {
+                throw std::invalid_argument("Probability " + std::to_string(probability) + " of a noise channel has to be within [0, 1].");
+            }
+            if (rho.w == Complex::zero) {
+                return mEdge::zero;
+            }
+            if (target < 0 || rho.isTerminal() || target > rho.p->v) {
+                throw std::invalid_argument("Noise channel target " + std::to_string(target) + " is out of range for a density matrix with " + std::to_string(rho.isTerminal() ? 0 : rho.p->v + 1) + " qubits.");
+            }
+            [[maybe_unused]] const auto before = cn.cacheCount();
+            const auto                  result = applyNoiseChannel2(rho, {channel, target, probability});
+            [[maybe_unused]] const auto after  = cn.cacheCount();
+            assert(before == after);
+            return result;
+        }
+
+    private:
+        mEdge applyNoiseChannel2(const mEdge& rho, const NoiseChannelOperation& op) {
+            if (rho.w == Complex::zero) {
+                return mEdge::zero;
+            }
+            assert(!rho.isTerminal() && rho.p->v >= op.target);
+
+            // results are cached for the node, the weight of the edge is applied afterwards
+            const mEdge node{rho.p, Complex::one};
+            auto        r = noiseChannels.lookup(node, op);
+            if (r.p == nullptr) {
+                std::array<mEdge, NEDGE> e{};
+                if (rho.p->v > op.target) {
+                    for (auto i = 0U; i < NEDGE; ++i) {
+                        e[i] = applyNoiseChannel2(rho.p->e[i], op);
+                    }
+                } else {
+                    const auto& s = rho.p->e;
+                    const auto  p = op.probability;
+                    switch (op.channel) {
+                        case NoiseChannel::depolarization: {
+                            const auto mixed = scaled(add(s[0], s[3]), p / 2.);
+                            e                = {add(scaled(s[0], 1. - p), mixed), scaled(s[1], 1. - p), scaled(s[2], 1. - p), add(scaled(s[3], 1. - p), mixed)};
+                            break;
+                        }
+                        case NoiseChannel::amplitudeDamping:
+                            e = {add(s[0], scaled(s[3], p)), scaled(s[1], std::sqrt(1. - p)), scaled(s[2], std::sqrt(1. - p)), scaled(s[3], 1. - p)};
+                            break;
+                        case NoiseChannel::phaseFlip:
+                            e = {s[0], scaled(s[1], 1. - 2. * p), scaled(s[2], 1. - 2. * p), s[3]};
+                            break;
+                    }
+                }
+                r = makeDDNode(rho.p->v, e);
+                noiseChannels.insert(node, op, r);
+            }
+
+            if (r.w == Complex::zero || rho.w.approximatelyOne()) {
+                return r;
+            }
+            auto c = cn.getTemporary();
+            ComplexNumbers::mul(c, r.w, rho.w);
+            r.w = cn.lookup(c);
+            return r.w == Complex::zero ? mEdge::zero : r;
+        }
+
+        // edge with its weight multiplied by a real factor
+        mEdge scaled(const mEdge& e, fp factor) {
+            if (e.w == Complex::zero || factor == 0.) {
+                return mEdge::zero;
+            }
+            if (factor == 1.) {
+                return e;
+            }
+            auto w = cn.lookup(CTEntry::val(e.w.r) * factor, CTEntry::val(e.w.i) * factor);
+            return w == Complex::zero ? mEdge::zero : mEdge{e.p, w};
+        }
+
         ///
         /// Decision diagram size
         ///
     public:
         template<class Edge>
         unsigned int size(const Edge& e) {
-            static constexpr unsigned int            NODECOUNT_BUCKETS = 200000;
-            static std::unordered_set<decltype(e.p)> visited{NODECOUNT_BUCKETS}; // 2e6
-            visited.max_load_factor(10);
-            visited.clear();
+            VisitedNodes<std::remove_reference_t<decltype(*e.p)>> visited{};
             return nodeCount(e, visited);
         }
 
     private:
         template<class Edge>
-        unsigned int nodeCount(const Edge& e, std::unordered_set<decltype(e.p)>& v) const {
+        unsigned int nodeCount(const Edge& e, VisitedNodes<std::remove_reference_t<decltype(*e.p)>>& v) const {
             v.insert(e.p);
             unsigned int sum = 1;
             if (!e.isTerminal()) {
                 for (const auto& edge: e.p->e) {
-                    if (edge.p != nullptr && !v.count(edge.p)) {
+                    if (edge.p != nullptr && !v.contains(edge.p)) {
                         sum += nodeCount(edge, v);
                     }
                 }
@@ -1582,8 +2909,7 @@ namespace dd {
             }
             if (e.p->v < lowerbound) return e;
             auto f = reduceAncillaeRecursion(e, ancillary, lowerbound, regular);
-            decRef(e);
-            incRef(f);
+            swapRoots(e, f);
             return f;
         }
 
@@ -1600,8 +2926,7 @@ namespace dd {
             }
             if (e.p->v < lowerbound) return e;
             auto f = reduceGarbageRecursion(e, garbage, lowerbound);
-            decRef(e);
-            incRef(f);
+            swapRoots(e, f);
             return f;
         }
         mEdge reduceGarbage(mEdge& e, const std::vector<bool>& garbage, bool regular = true) {
@@ -1616,8 +2941,7 @@ namespace dd {
             }
             if (e.p->v < lowerbound) return e;
             auto f = reduceGarbageRecursion(e, garbage, lowerbound, regular);
-            decRef(e);
-            incRef(f);
+            swapRoots(e, f);
             return f;
         }
 
@@ -1797,6 +3121,154 @@ namespace dd {
             return f;
         }
 
+        ///
+        /// Variable reordering
+        ///
+        /// The levels of a DD are fixed to qubit indices, i.e., a node at level `v` decides qubit `v`. A reordered DD
+        /// is accompanied by a permutation mapping each level to the qubit it decides. Functions addressing qubits by
+        /// their level (e.g., measureOneCollapsing or getValueByPath) have to be used with the level of a qubit, while
+        /// restoreOrder yields the DD in the original order (e.g., for exporting it).
+        ///
+    public:
+        // exchange the qubits at levels `level` and `level + 1` of a DD. Only the nodes at and above level `level + 1`
+        // are rebuilt, the successors of the lower level are reused. As for multiply, the result is not referenced.
+        template<class Node>
+        Edge<Node> swapLevels(const Edge<Node>& e, Qubit level) {
+            if (level < 0 || (!e.isTerminal() && level >= e.p->v)) {
+                throw std::invalid_argument("Levels " + std::to_string(level) + " and " + std::to_string(level + 1) + " cannot be swapped in a DD with " + std::to_string(e.isTerminal() ? 0 : e.p->v + 1) + " levels.");
+            }
+            NodeMap<const Node*, Edge<Node>> nodes{};
+            return swapLevels(e, level, nodes);
+        }
+
+        // reorder the levels of a DD by sifting [Rudell, ICCAD 1993]: each qubit is moved through all levels by swapping
+        // adjacent levels and is placed at the level yielding the smallest DD. `permutation` maps the levels of `e` to
+        // qubits (the identity if it is empty) and is updated to the order of the result. Intermediate DDs are not
+        // referenced, i.e., garbage must not be collected while sifting. As for multiply, the result is not referenced.
+        template<class Node>
+        Edge<Node> sift(const Edge<Node>& e, std::vector<Qubit>& permutation) {
+            if (e.isTerminal()) {
+                return e;
+            }
+            const auto levels = static_cast<std::size_t>(e.p->v) + 1;
+            checkPermutation(permutation, levels);
+
+            auto       result = e;
+            const auto swap   = [&](std::size_t level) {
+                result = swapLevels(result, static_cast<Qubit>(level));
+                std::swap(permutation[level], permutation[level + 1]);
+            };
+            for (const auto q: std::vector<Qubit>(permutation)) {
+                auto level     = static_cast<std::size_t>(std::find(permutation.begin(), permutation.end(), q) - permutation.begin());
+                auto bestSize  = size(result);
+                auto bestLevel = level;
+                const auto track = [&]() {
+                    const auto nodes = size(result);
+                    if (nodes < bestSize) {
+                        bestSize  = nodes;
+                        bestLevel = level;
+                    }
+                };
+                while (level > 0) {
+                    swap(--level);
+                    track();
+                }
+                while (level + 1 < levels) {
+                    swap(level++);
+                    track();
+                }
+                while (level > bestLevel) {
+                    swap(--level);
+                }
+            }
+            return result;
+        }
+
+        // restore the original order of a DD whose levels are permuted as given by `permutation`, which is reset to
+        // the identity. As for multiply, the result is not referenced.
+        template<class Node>
+        Edge<Node> restoreOrder(const Edge<Node>& e, std::vector<Qubit>& permutation) {
+            if (e.isTerminal()) {
+                return e;
+            }
+            const auto levels = static_cast<std::size_t>(e.p->v) + 1;
+            checkPermutation(permutation, levels);
+
+            auto result = e;
+            for (std::size_t sorted = 0; sorted + 1 < levels; ++sorted) {
+                for (std::size_t level = 0; level + 1 < levels - sorted; ++level) {
+                    if (permutation[level] > permutation[level + 1]) {
+                        result = swapLevels(result, static_cast<Qubit>(level));
+                        std::swap(permutation[level], permutation[level + 1]);
+                    }
+                }
+            }
+            return result;
+        }
+
+    private:
+        static void checkPermutation(std::vector<Qubit>& permutation, std::size_t levels) {
+            if (permutation.empty()) {
+                permutation.resize(levels);
+                std::iota(permutation.begin(), permutation.end(), Qubit{0});
+            }
+            if (permutation.size() != levels) {
+                throw std::invalid_argument("Permutation of " + std::to_string(permutation.size()) + " qubits does not match a DD with " + std::to_string(levels) + " levels.");
+            }
+        }
+
+        template<class Node>
+        Edge<Node> swapLevels(const Edge<Node>& e, Qubit level, NodeMap<const Node*, Edge<Node>>& nodes) {
+            if (e.isTerminal() || e.w == Complex::zero || e.p->v <= level) {
+                return e;
+            }
+
+            constexpr std::size_t N    = std::tuple_size_v<decltype(e.p->e)>;
+            const auto*           node = nodes.find(e.p);
+            Edge<Node>            newedge{};
+            if (node != nullptr) {
+                newedge = *node;
+            } else {
+                std::array<Edge<Node>, N> edges{};
+                if (e.p->v > level + 1) {
+                    for (std::size_t i = 0; i < N; ++i) {
+                        edges[i] = swapLevels(e.p->e[i], level, nodes);
+                    }
+                } else {
+                    // the successor `y` of the successor `x` becomes the successor `x` of the successor `y`
+                    for (std::size_t y = 0; y < N; ++y) {
+                        std::array<Edge<Node>, N> lower{};
+                        for (std::size_t x = 0; x < N; ++x) {
+                            const auto& upper = e.p->e[x];
+                            if (upper.w == Complex::zero) {
+                                lower[x] = Edge<Node>::zero;
+                                continue;
+                            }
+                            assert(!upper.isTerminal() && upper.p->v == level);
+                            lower[x] = upper.p->e[y];
+                            if (lower[x].w != Complex::zero && !upper.w.approximatelyOne()) {
+                                auto w = cn.getTemporary();
+                                dd::ComplexNumbers::mul(w, lower[x].w, upper.w);
+                                lower[x].w = cn.lookup(w);
+                            }
+                        }
+                        edges[y] = makeDDNode(level, lower);
+                    }
+                }
+                newedge = makeDDNode(e.p->v, edges);
+                nodes.try_emplace(e.p, newedge);
+            }
+
+            if (newedge.w.approximatelyOne()) {
+                newedge.w = e.w;
+            } else {
+                auto w = cn.getTemporary();
+                dd::ComplexNumbers::mul(w, newedge.w, e.w);
+                newedge.w = cn.lookup(w);
+            }
+            return newedge;
+        }
+
         ///
         /// Vector and matrix extraction from DDs
         ///
@@ -1826,6 +3298,16 @@ namespace dd {
 
             return {CTEntry::val(c.r), CTEntry::val(c.i)};
         }
+        // get a single element of a DD whose levels are permuted as given by `permutation` (see Package::sift), where
+        // the i-th character of `elements` describes the outgoing edge to follow for qubit i
+        template<class Edge>
+        ComplexValue getValueByPath(const Edge& e, const std::string& elements, const std::vector<Qubit>& permutation) {
+            auto path = elements;
+            for (std::size_t level = 0; level < permutation.size(); ++level) {
+                path.at(level) = elements.at(static_cast<std::size_t>(permutation[level]));
+            }
+            return getValueByPath(e, path);
+        }
         ComplexValue getValueByPath(const vEdge& e, std::size_t i) {
             if (e.isTerminal()) {
                 return {CTEntry::val(e.w.r), CTEntry::val(e.w.i)};
@@ -1883,12 +3365,122 @@ namespace dd {
         }
 
         CVec getVector(const vEdge& e) {
-            std::size_t dim = 1 << (e.p->v + 1);
+            std::size_t dim = 1ULL << (e.p->v + 1);
             // allocate resulting vector
-            auto vec = CVec(dim, {0.0, 0.0});
-            getVector(e, Complex::one, 0, vec);
+            auto vec = CVec(dim);
+            getVector(e, vec.data(), 0, dim);
             return vec;
         }
+
+        // minimal number of amplitudes for which getVector distributes the work among the threads of the pool
+        static constexpr std::size_t PARALLEL_EXPORT_THRESHOLD = 1U << 14U;
+        static constexpr std::size_t EXPORT_TASKS              = 16;
+
+        // write the amplitudes with indices [first, first + count) of the state `e` to `amplitudes`, which has to provide
+        // space for `count` elements. Zero and terminal subtrees are written as constant runs and subtrees whose two halves
+        // coincide are copied. Large ranges are split among the threads of the pool if parallel execution is enabled.
+        void getVector(const vEdge& e, std::complex<fp>* amplitudes, std::size_t first, std::size_t count) {
+            const auto level = static_cast<QubitCount>(e.isTerminal() ? 0 : e.p->v + 1);
+            if (first + count > (std::size_t{1} << level)) {
+                throw std::invalid_argument("Amplitude range exceeds the dimension of the state.");
+            }
+            if (pool == nullptr || count < PARALLEL_EXPORT_THRESHOLD) {
+                writeAmplitudes(e, {1., 0.}, level, 0, first, first + count, amplitudes);
+                return;
+            }
+            // amplitude computations only read the DD, so the parts can be written independently
+            pool->parallelFor<EXPORT_TASKS>([&](std::size_t task) {
+                const auto begin = first + count * task / EXPORT_TASKS;
+                const auto end   = first + count * (task + 1) / EXPORT_TASKS;
+                writeAmplitudes(e, {1., 0.}, level, 0, begin, end, amplitudes + (begin - first));
+            });
+        }
+
+        // call f(first, amplitudes, count) for consecutive chunks of at most `chunkSize` amplitudes of the state `e`. Only a
+        // single chunk is materialized at any time, so that states exceeding the available memory can be streamed.
+        template<class F>
+        void forEachAmplitudeChunk(const vEdge& e, std::size_t chunkSize, const F& f) {
+            if (chunkSize == 0) {
+                throw std::invalid_argument("Chunk size must be positive.");
+            }
+            const auto                    dim = std::size_t{1} << (e.isTerminal() ? 0 : e.p->v + 1);
+            std::vector<std::complex<fp>> chunk(std::min(chunkSize, dim));
+            for (std::size_t first = 0; first < dim; first += chunk.size()) {
+                const auto count = std::min(chunk.size(), dim - first);
+                getVector(e, chunk.data(), first, count);
+                f(first, static_cast<const std::complex<fp>*>(chunk.data()), count);
+            }
+        }
+
+    private:
+        // write the amplitudes of the subtree `e` with `level` qubits, starting at index `offset`, that fall into [begin, end)
+        // to `out`, which corresponds to index `begin`. `amp` is the product of the weights on the path to the subtree.
+        void writeAmplitudes(const vEdge& e, const ComplexValue& amp, QubitCount level, std::size_t offset, std::size_t begin, std::size_t end, std::complex<fp>* out) const {
+            const auto size = std::size_t{1} << level;
+            const auto from = std::max(offset, begin);
+            const auto to   = std::min(offset + size, end);
+            if (from >= to) {
+                return;
+            }
+            if (from == offset && to == offset + size) {
+                writeAmplitudes(e, amp, level, out + (offset - begin));
+                return;
+            }
+            if (e.w.approximatelyZero() || e.isTerminal()) {
+                std::fill(out + (from - begin), out + (to - begin), amplitude(e.w, amp));
+                return;
+            }
+            const auto c     = accumulate(e.w, amp);
+            const auto lower = static_cast<QubitCount>(level - 1);
+            writeAmplitudes(e.p->e[0], c, lower, offset, begin, end, out);
+            writeAmplitudes(e.p->e[1], c, lower, offset + size / 2, begin, end, out);
+        }
+
+        // write all amplitudes of the subtree `e` with `level` qubits to `out`
+        void writeAmplitudes(const vEdge& e, const ComplexValue& amp, QubitCount level, std::complex<fp>* out) const {
+            const auto size = std::size_t{1} << level;
+            if (e.w.approximatelyZero() || e.isTerminal()) {
+                std::fill(out, out + size, amplitude(e.w, amp));
+                return;
+            }
+            const auto c = accumulate(e.w, amp);
+            if (level == 1) {
+                out[0] = amplitude(e.p->e[0].w, c);
+                out[1] = amplitude(e.p->e[1].w, c);
+                return;
+            }
+            const auto half  = size / 2;
+            const auto lower = static_cast<QubitCount>(level - 1);
+            writeAmplitudes(e.p->e[0], c, lower, out);
+            if (e.p->e[0] == e.p->e[1]) {
+                // both halves of the subtree coincide
+                std::copy_n(out, half, out + half);
+            } else {
+                writeAmplitudes(e.p->e[1], c, lower, out + half);
+            }
+        }
+
+        // product of the weight `w` and the accumulated amplitude `amp` (with the same shortcuts as ComplexNumbers::mul)
+        static ComplexValue accumulate(const Complex& w, const ComplexValue& amp) {
+            if (w.approximatelyOne()) {
+                return amp;
+            }
+            const auto wr = CTEntry::val(w.r);
+            const auto wi = CTEntry::val(w.i);
+            if (amp.approximatelyOne()) {
+                return {wr, wi};
+            }
+            return {wr * amp.r - wi * amp.i, wr * amp.i + wi * amp.r};
+        }
+        static std::complex<fp> amplitude(const Complex& w, const ComplexValue& amp) {
+            if (w.approximatelyZero()) {
+                return {0., 0.};
+            }
+            const auto c = accumulate(w, amp);
+            return {c.r, c.i};
+        }
+
+    public:
         void getVector(const vEdge& e, const Complex& amp, std::size_t i, CVec& vec) {
             // calculate new accumulated amplitude
             auto c = cn.mulCached(e.w, amp);
@@ -2036,9 +3628,7 @@ namespace dd {
                 // TODO special treatment
                 return;
             }
-            auto weight = cn.getCached(1., 0.);
-            exportAmplitudesRec(edge, amplitudes, weight, nq, 0);
-            cn.returnToCache(weight);
+            writeAmplitudes(edge, {1., 0.}, nq, 0, 0, std::size_t{1} << nq, amplitudes.data());
         }
 
         void addAmplitudesRec(const dd::Package::vEdge& edge, std::vector<std::complex<dd::fp>>& amplitudes, ComplexValue& amplitude, dd::QubitCount level, std::size_t idx) {
@@ -2075,7 +3665,7 @@ namespace dd {
             Edge              root{};
             std::stack<Edge*> stack;
 
-            std::unordered_map<decltype(original.p), decltype(original.p)> mapped_node{};
+            NodeMap<decltype(toPointer(original.p)), decltype(toPointer(original.p))> mapped_node{};
 
             Edge* currentEdge = &original;
             if (!currentEdge->isTerminal()) {
@@ -2090,7 +3680,7 @@ namespace dd {
                             if (edge.w.approximatelyZero()) {
                                 continue;
                             }
-                            if (mapped_node.find(edge.p) != mapped_node.end()) {
+                            if (mapped_node.contains(edge.p)) {
                                 continue;
                             }
 
@@ -2109,7 +3699,7 @@ namespace dd {
                         if (edge.w.approximatelyZero()) {
                             continue;
                         }
-                        if (mapped_node.find(edge.p) != mapped_node.end()) {
+                        if (mapped_node.contains(edge.p)) {
                             continue;
                         }
                         hasChild = edge.p == stack.top()->p;
@@ -2121,7 +3711,7 @@ namespace dd {
                         stack.push(currentEdge);
                         currentEdge = temp;
                     } else {
-                        if (mapped_node.find(currentEdge->p) != mapped_node.end()) {
+                        if (mapped_node.contains(currentEdge->p)) {
                             currentEdge = nullptr;
                             continue;
                         }
@@ -2171,7 +3761,22 @@ namespace dd {
             if (readBinary) {
                 std::remove_const_t<decltype(SERIALIZATION_VERSION)> version;
                 is.read(reinterpret_cast<char*>(&version), sizeof(decltype(SERIALIZATION_VERSION)));
-                if (version != SERIALIZATION_VERSION) {
+                if (version == SERIALIZATION_VERSION) {
+                    SerializationHeader header{};
+                    header.version = version;
+                    is.read(reinterpret_cast<char*>(&header) + sizeof(header.version), sizeof(header) - sizeof(header.version));
+                    if (!is) {
+                        throw std::runtime_error("Unexpected end of serialized data.");
+                    }
+                    std::vector<char> data(checkedSerializationSize<N>(header, std::numeric_limits<std::size_t>::max()));
+                    is.read(data.data(), static_cast<std::streamsize>(data.size()));
+                    if (!is) {
+                        throw std::runtime_error("Unexpected end of serialized data.");
+                    }
+                    return deserializeRecords<Node>(header, data.data(), data.data() + header.weights * sizeof(SerializedWeight));
+                }
+                // version 1 stores the index, variable and edges of every node in a separate record
+                if (version != 1) {
                     throw std::runtime_error("Wrong Version of serialization file version. version of file: " + std::to_string(version) + "; current version: " + std::to_string(SERIALIZATION_VERSION));
                 }
 
@@ -2190,7 +3795,8 @@ namespace dd {
             } else {
                 std::string version;
                 std::getline(is, version);
-                if (std::stoi(version) != SERIALIZATION_VERSION) {
+                // the text format did not change with version 2
+                if (const auto fileVersion = std::stoi(version); fileVersion < 1 || static_cast<std::uint_least64_t>(fileVersion) > SERIALIZATION_VERSION) {
                     throw std::runtime_error("Wrong Version of serialization file version. version of file: " + version + "; current version: " + std::to_string(SERIALIZATION_VERSION));
                 }
 
@@ -2254,6 +3860,18 @@ namespace dd {
 
         template<class Node, class Edge = Edge<Node>>
         Edge deserialize(const std::string& inputFilename, bool readBinary) {
+            if (readBinary) {
+                // files in the current binary format are parsed directly from memory
+                const MappedFile file(inputFilename);
+                std::remove_const_t<decltype(SERIALIZATION_VERSION)> version{};
+                if (file.size() >= sizeof(version)) {
+                    std::memcpy(&version, file.data(), sizeof(version));
+                }
+                if (version == SERIALIZATION_VERSION) {
+                    return deserializeFromMemory<Node>(file.data(), file.size());
+                }
+            }
+
             auto ifs = std::ifstream(inputFilename, std::ios::binary);
 
             if (!ifs.good()) {
@@ -2263,7 +3881,91 @@ namespace dd {
             return deserialize<Node>(ifs, readBinary);
         }
 
+        // reconstruct a DD from the binary serialization (version 2) in the buffer `data` of `size` bytes
+        template<class Node, class Edge = Edge<Node>, std::size_t N = std::tuple_size_v<decltype(Node::e)>>
+        Edge deserializeFromMemory(const char* data, std::size_t size) {
+            SerializationHeader header{};
+            if (size < sizeof(header)) {
+                throw std::runtime_error("Unexpected end of serialized data.");
+            }
+            std::memcpy(&header, data, sizeof(header));
+            if (header.version != SERIALIZATION_VERSION) {
+                throw std::runtime_error("Wrong Version of serialization file version. version of file: " + std::to_string(header.version) + "; current version: " + std::to_string(SERIALIZATION_VERSION));
+            }
+            checkedSerializationSize<N>(header, size - sizeof(header));
+            const auto* weights = data + sizeof(header);
+            return deserializeRecords<Node>(header, weights, weights + header.weights * sizeof(SerializedWeight));
+        }
+
     private:
+        // size of the weight table and the node records described by `header`, which must not exceed `available` bytes
+        template<std::size_t N>
+        static std::size_t checkedSerializationSize(const SerializationHeader& header, std::size_t available) {
+            if (header.weights > available / sizeof(SerializedWeight)) {
+                throw std::runtime_error("Unexpected end of serialized data.");
+            }
+            const auto weightBytes = header.weights * sizeof(SerializedWeight);
+            if (header.nodes > (available - weightBytes) / sizeof(SerializedNode<N>)) {
+                throw std::runtime_error("Unexpected end of serialized data.");
+            }
+            return weightBytes + header.nodes * sizeof(SerializedNode<N>);
+        }
+
+        // build the nodes of a binary serialization (version 2). Records are addressed by their position, every distinct
+        // weight is looked up in the complex table only once.
+        template<class Node, class Edge = Edge<Node>, std::size_t N = std::tuple_size_v<decltype(Node::e)>>
+        Edge deserializeRecords(const SerializationHeader& header, const char* weightData, const char* nodeData) {
+            if (header.rootWeight >= header.weights) {
+                throw std::runtime_error("Invalid weight index in serialized data.");
+            }
+            std::vector<Complex> weights(header.weights);
+            ComplexValue         rootWeight{};
+            for (std::size_t i = 0; i < weights.size(); ++i) {
+                SerializedWeight stored{};
+                std::memcpy(&stored, weightData + i * sizeof(SerializedWeight), sizeof(SerializedWeight));
+                const ComplexValue w{static_cast<fp>(stored.r), static_cast<fp>(stored.i)};
+                weights[i] = cn.lookup(w);
+                if (i == header.rootWeight) {
+                    rootWeight = w;
+                }
+            }
+
+            std::vector<Node*> nodes(header.nodes);
+            auto               result = Edge::one;
+            SerializedNode<N>  record{};
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                std::memcpy(&record, nodeData + i * sizeof(record), sizeof(record));
+                if (record.v < 0 || record.v >= static_cast<std::int64_t>(nqubits)) {
+                    throw std::runtime_error("Invalid variable in serialized data: " + std::to_string(record.v));
+                }
+                std::array<Edge, N> edges{};
+                for (std::size_t k = 0; k < N; ++k) {
+                    if (record.weights[k] >= header.weights) {
+                        throw std::runtime_error("Invalid weight index in serialized data.");
+                    }
+                    const auto& w = weights[record.weights[k]];
+                    if (w.approximatelyZero()) {
+                        edges[k] = Edge::zero;
+                        continue;
+                    }
+                    // successors precede their predecessors
+                    const auto child = record.children[k];
+                    if (child < -1 || child >= static_cast<std::int64_t>(i)) {
+                        throw std::runtime_error("Invalid successor in serialized data: " + std::to_string(child));
+                    }
+                    edges[k] = {child == -1 ? toPointer(Node::terminal) : nodes[static_cast<std::size_t>(child)], w};
+                }
+                result   = makeDDNode(static_cast<Qubit>(record.v), edges);
+                nodes[i] = result.p;
+            }
+
+            auto w = cn.getCached(rootWeight.r, rootWeight.i);
+            ComplexNumbers::mul(w, result.w, w);
+            result.w = cn.lookup(w);
+            cn.returnToCache(w);
+            return result;
+        }
+
         template<class Node, class Edge = Edge<Node>, std::size_t N = std::tuple_size_v<decltype(Node::e)>>
         Edge deserializeNode(std::int_least64_t index, Qubit v, std::array<std::int_least64_t, N>& edge_idx, std::array<ComplexValue, N>& edge_weight, std::unordered_map<std::int_least64_t, Node*>& nodes) {
             if (index == -1) {
@@ -2293,6 +3995,186 @@ namespace dd {
             return newedge;
         }
 
+        ///
+        /// Checkpoints
+        ///
+    public:
+        // root edges of the DDs stored in a checkpoint
+        struct CheckpointRoots {
+            std::vector<vEdge> vectors{};
+            std::vector<mEdge> matrices{};
+        };
+
+        // write the DDs rooted at `roots`, i.e., the records of all their nodes and the distinct weights they use, to `os`.
+        // Nodes shared by several roots are stored once.
+        void checkpoint(std::ostream& os, const CheckpointRoots& roots) {
+            static_assert(sizeof(CheckpointNode<NEDGE>) == (2 * NEDGE + 2) * sizeof(std::uint64_t), "Node records must not be padded.");
+            std::unordered_map<Complex, std::uint64_t> weightIndices{};
+            std::vector<SerializedWeight>              weights{};
+            const auto                                 weightIndex = [&](const Complex& w) {
+                const auto [it, inserted] = weightIndices.try_emplace(w, weights.size());
+                if (inserted) {
+                    weights.push_back({CTEntry::val(w.r), CTEntry::val(w.i)});
+                }
+                return it->second;
+            };
+
+            NodeMap<const vNode*, std::int64_t> vectorIndices{};
+            NodeMap<const mNode*, std::int64_t> matrixIndices{};
+            std::vector<CheckpointNode<RADIX>>  vectorNodes{};
+            std::vector<CheckpointNode<NEDGE>>  matrixNodes{};
+            std::vector<CheckpointRoot>         rootRecords{};
+            for (const auto& root: roots.vectors) {
+                rootRecords.push_back({checkpointNode(toPointer(root.p), vectorIndices, vectorNodes, weightIndex), weightIndex(root.w)});
+            }
+            for (const auto& root: roots.matrices) {
+                rootRecords.push_back({checkpointNode(toPointer(root.p), matrixIndices, matrixNodes, weightIndex), weightIndex(root.w)});
+            }
+
+            const CheckpointHeader header{CHECKPOINT_VERSION, weights.size(), vectorNodes.size(), matrixNodes.size(), roots.vectors.size(), roots.matrices.size()};
+            os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            os.write(reinterpret_cast<const char*>(weights.data()), static_cast<std::streamsize>(weights.size() * sizeof(SerializedWeight)));
+            os.write(reinterpret_cast<const char*>(vectorNodes.data()), static_cast<std::streamsize>(vectorNodes.size() * sizeof(CheckpointNode<RADIX>)));
+            os.write(reinterpret_cast<const char*>(matrixNodes.data()), static_cast<std::streamsize>(matrixNodes.size() * sizeof(CheckpointNode<NEDGE>)));
+            os.write(reinterpret_cast<const char*>(rootRecords.data()), static_cast<std::streamsize>(rootRecords.size() * sizeof(CheckpointRoot)));
+        }
+        void checkpoint(const std::string& filename, const CheckpointRoots& roots) {
+            std::ofstream ofs(filename, std::ios::binary);
+            if (!ofs.good()) {
+                throw std::invalid_argument("Cannot open file: " + filename);
+            }
+            checkpoint(ofs, roots);
+        }
+
+        // rebuild the DDs of a checkpoint in this package and return their roots, whose reference counts are incremented.
+        // Nodes are reconstructed from their records as they are, i.e., neither normalized nor checked for being
+        // symmetric or the identity, and only merged with equal nodes already present in the package.
+        CheckpointRoots restore(const std::string& filename) {
+            const MappedFile file(filename);
+            return restoreFromMemory(file.data(), file.size());
+        }
+        CheckpointRoots restoreFromMemory(const char* data, std::size_t size) {
+            CheckpointHeader header{};
+            if (size < sizeof(header)) {
+                throw std::runtime_error("Unexpected end of checkpoint.");
+            }
+            std::memcpy(&header, data, sizeof(header));
+            if (header.version != CHECKPOINT_VERSION) {
+                throw std::runtime_error("Wrong checkpoint version: " + std::to_string(header.version) + "; current version: " + std::to_string(CHECKPOINT_VERSION));
+            }
+            // each section has to fit into the remaining data
+            auto       remaining = size - sizeof(header);
+            const auto section   = [&](std::uint64_t count, std::size_t recordSize) {
+                if (count > remaining / recordSize) {
+                    throw std::runtime_error("Unexpected end of checkpoint.");
+                }
+                const auto* begin = data + (size - remaining);
+                remaining -= count * recordSize;
+                return begin;
+            };
+            const auto* weightData     = section(header.weights, sizeof(SerializedWeight));
+            const auto* vectorData     = section(header.vectorNodes, sizeof(CheckpointNode<RADIX>));
+            const auto* matrixData     = section(header.matrixNodes, sizeof(CheckpointNode<NEDGE>));
+            const auto* vectorRootData = section(header.vectorRoots, sizeof(CheckpointRoot));
+            const auto* matrixRootData = section(header.matrixRoots, sizeof(CheckpointRoot));
+
+            std::vector<Complex> weights(header.weights);
+            for (std::size_t i = 0; i < weights.size(); ++i) {
+                SerializedWeight w{};
+                std::memcpy(&w, weightData + i * sizeof(SerializedWeight), sizeof(SerializedWeight));
+                weights[i] = cn.lookup(static_cast<fp>(w.r), static_cast<fp>(w.i));
+            }
+            const auto vectorNodes = restoreNodes<vNode>(vectorData, header.vectorNodes, weights);
+            const auto matrixNodes = restoreNodes<mNode>(matrixData, header.matrixNodes, weights);
+
+            CheckpointRoots roots{};
+            restoreRoots(vectorRootData, header.vectorRoots, vectorNodes, weights, roots.vectors);
+            restoreRoots(matrixRootData, header.matrixRoots, matrixNodes, weights, roots.matrices);
+            return roots;
+        }
+
+    private:
+        // append the records of the node `p` and of all its descendants not recorded yet to `records` (in post order)
+        template<class Node, std::size_t N = std::tuple_size_v<decltype(Node::e)>, class WeightIndex>
+        std::int64_t checkpointNode(const Node* p, NodeMap<const Node*, std::int64_t>& indices, std::vector<CheckpointNode<N>>& records, const WeightIndex& weightIndex) {
+            if (Node::isTerminal(p)) {
+                return -1;
+            }
+            if (const auto* it = indices.find(p); it != nullptr) {
+                return *it;
+            }
+            CheckpointNode<N> record{};
+            for (std::size_t i = 0; i < N; ++i) {
+                const auto& edge = p->e[i];
+                if (edge.w == Complex::zero) {
+                    record.node.children[i] = -1;
+                    record.node.weights[i]  = weightIndex(Complex::zero);
+                } else {
+                    record.node.children[i] = checkpointNode(toPointer(edge.p), indices, records, weightIndex);
+                    record.node.weights[i]  = weightIndex(edge.w);
+                }
+            }
+            record.node.v = p->v;
+            if constexpr (N == NEDGE) {
+                record.flags = (p->symm ? 1U : 0U) | (p->ident ? 2U : 0U);
+            }
+            const auto index = static_cast<std::int64_t>(records.size());
+            records.push_back(record);
+            indices.try_emplace(p, index);
+            return index;
+        }
+
+        template<class Node, std::size_t N = std::tuple_size_v<decltype(Node::e)>>
+        std::vector<Node*> restoreNodes(const char* data, std::size_t count, const std::vector<Complex>& weights) {
+            auto&              uniqueTable = getUniqueTable<Node>();
+            std::vector<Node*> nodes(count);
+            CheckpointNode<N>  record{};
+            for (std::size_t i = 0; i < count; ++i) {
+                std::memcpy(&record, data + i * sizeof(record), sizeof(record));
+                const auto v = record.node.v;
+                if (v < 0 || v >= static_cast<std::int64_t>(nqubits)) {
+                    throw std::runtime_error("Invalid variable in checkpoint: " + std::to_string(v));
+                }
+
+                std::array<Edge<Node>, N> edges{};
+                for (std::size_t k = 0; k < N; ++k) {
+                    if (record.node.weights[k] >= weights.size()) {
+                        throw std::runtime_error("Invalid weight index in checkpoint.");
+                    }
+                    const auto child = record.node.children[k];
+                    if (child < -1 || child >= static_cast<std::int64_t>(i) || (child >= 0 && nodes[static_cast<std::size_t>(child)]->v != v - 1)) {
+                        throw std::runtime_error("Invalid successor in checkpoint: " + std::to_string(child));
+                    }
+                    edges[k] = {child == -1 ? toPointer(Node::terminal) : nodes[static_cast<std::size_t>(child)], weights[record.node.weights[k]]};
+                }
+
+                Edge<Node> e{uniqueTable.getNode(), Complex::one};
+                e.p->v = static_cast<Qubit>(v);
+                e.p->e = edges;
+                if constexpr (N == NEDGE) {
+                    e.p->symm  = (record.flags & 1U) != 0;
+                    e.p->ident = (record.flags & 2U) != 0;
+                }
+                nodes[i] = uniqueTable.lookup(e, false).p;
+            }
+            return nodes;
+        }
+
+        template<class Node>
+        void restoreRoots(const char* data, std::size_t count, const std::vector<Node*>& nodes, const std::vector<Complex>& weights, std::vector<Edge<Node>>& roots) {
+            roots.reserve(count);
+            for (std::size_t i = 0; i < count; ++i) {
+                CheckpointRoot record{};
+                std::memcpy(&record, data + i * sizeof(record), sizeof(record));
+                if (record.node < -1 || record.node >= static_cast<std::int64_t>(nodes.size()) || record.weight >= weights.size()) {
+                    throw std::runtime_error("Invalid root in checkpoint.");
+                }
+                Edge<Node> root{record.node == -1 ? toPointer(Node::terminal) : nodes[static_cast<std::size_t>(record.node)], weights[record.weight]};
+                incRef(root);
+                roots.push_back(root);
+            }
+        }
+
         ///
         /// Debugging
         ///
@@ -2308,11 +4190,18 @@ namespace dd {
                 std::clog << "  " << std::hexfloat
                           << std::setw(22) << CTEntry::val(edge.w.r) << " "
                           << std::setw(22) << CTEntry::val(edge.w.i) << std::defaultfloat
-                          << "i --> " << debugnode_line(edge.p) << "\n";
+                          << "i --> " << debugnode_line(toPointer(edge.p)) << "\n";
             }
             std::clog << std::flush;
         }
 
+#ifdef DD_PACKAGE_COMPACT_NODES
+        template<class Node>
+        void debugnode(const CompactPointer<Node>& p) const {
+            debugnode(toPointer(p));
+        }
+#endif
+
         template<class Node>
         std::string debugnode_line(const Node* p) const {
             if (Node::isTerminal(p)) {
@@ -2322,7 +4211,7 @@ namespace dd {
             sst << "0x" << std::hex << reinterpret_cast<std::uintptr_t>(p) << std::dec
                 << "[v=" << static_cast<std::int_fast64_t>(p->v)
                 << " ref=" << p->ref
-                << " hash=" << UniqueTable<Node>::hash(p)
+                << " hash=" << UniqueTable<Node>::fullHash(p)
                 << "]";
             return sst.str();
         }
@@ -2468,11 +4357,43 @@ namespace dd {
                       << "\n  CT Vector Kronecker size: " << sizeof(decltype(vectorKronecker)::Entry) << " bytes (aligned " << alignof(decltype(vectorKronecker)::Entry) << " bytes)"
                       << "\n  CT Matrix Kronecker size: " << sizeof(decltype(matrixKronecker)::Entry) << " bytes (aligned " << alignof(decltype(matrixKronecker)::Entry) << " bytes)"
                       << "\n  ToffoliTable::Entry size: " << sizeof(ToffoliTable<mEdge>::Entry) << " bytes (aligned " << alignof(ToffoliTable<mEdge>::Entry) << " bytes)"
+                      << "\n  GateTable::Entry size: " << sizeof(GateTable<mEdge>::Entry) << " bytes (aligned " << alignof(GateTable<mEdge>::Entry) << " bytes)"
                       << "\n  Package size: " << sizeof(Package) << " bytes (aligned " << alignof(Package) << " bytes)"
                       << "\n"
                       << std::flush;
         }
 
+        // unique, compute and complex table as well as garbage collection statistics
+        [[nodiscard]] PackageStatistics getStatistics() const {
+            PackageStatistics stats{};
+            stats.tables = {
+                    {"vUniqueTable", vUniqueTable.getStatistics()},
+                    {"mUniqueTable", mUniqueTable.getStatistics()},
+                    {"vectorAdd", vectorAdd.getStatistics()},
+                    {"matrixAdd", matrixAdd.getStatistics()},
+                    {"matrixTranspose", matrixTranspose.getStatistics()},
+                    {"conjugateMatrixTranspose", conjugateMatrixTranspose.getStatistics()},
+                    {"matrixMatrixMultiplication", matrixMatrixMultiplication.getStatistics()},
+                    {"matrixVectorMultiplication", matrixVectorMultiplication.getStatistics()},
+                    {"vectorInnerProduct", vectorInnerProduct.getStatistics()},
+                    {"expectationValues", expectationValues.getStatistics()},
+                    {"vectorKronecker", vectorKronecker.getStatistics()},
+                    {"matrixKronecker", matrixKronecker.getStatistics()},
+                    {"toffoliTable", toffoliTable.getStatistics()},
+                    {"gateTable", gateTable.getStatistics()},
+                    {"noiseOperationTable", noiseOperationTable.getStatistics()},
+                    {"noiseChannels", noiseChannels.getStatistics()},
+                    {"complexTable", cn.complexTable.getStatistics()},
+                    {"complexCache", cn.complexCache.getStatistics()},
+            };
+            for (std::size_t q = 0; q < nqubits; ++q) {
+                stats.activeVectorNodes.push_back(vUniqueTable.getActiveNodeCount(static_cast<Qubit>(q)));
+                stats.activeMatrixNodes.push_back(mUniqueTable.getActiveNodeCount(static_cast<Qubit>(q)));
+            }
+            stats.garbageCollection = gcStatistics;
+            return stats;
+        }
+
         // print unique and compute table statistics
         void statistics() {
             std::cout << "DD statistics:" << std::endl
@@ -2494,19 +4415,38 @@ namespace dd {
             matrixVectorMultiplication.printStatistics();
             std::cout << "[CT Inner Product] ";
             vectorInnerProduct.printStatistics();
+            std::cout << "[CT Expectation Values] ";
+            expectationValues.printStatistics();
             std::cout << "[CT Vector Kronecker] ";
             vectorKronecker.printStatistics();
             std::cout << "[CT Matrix Kronecker] ";
             matrixKronecker.printStatistics();
             std::cout << "[Toffoli Table] ";
             toffoliTable.printStatistics();
+            std::cout << "[Gate Table] ";
+            gateTable.printStatistics();
             std::cout << "[Operation Table] ";
             noiseOperationTable.printStatistics();
+            std::cout << "[CT Noise Channels] ";
+            noiseChannels.printStatistics();
             std::cout << "[ComplexTable] ";
             cn.complexTable.printStatistics();
         }
     };
 
+#ifdef DD_PACKAGE_COMPACT_NODES
+    inline Package::vNode& Package::vNode::terminalNode = CompactArena<vNode>::emplace(TERMINAL_SLOT, {{{{nullptr, Complex::zero}, {nullptr, Complex::zero}}},
+                                                                                                       nullptr,
+                                                                                                       0,
+                                                                                                       -1});
+
+    inline Package::mNode& Package::mNode::terminalNode = CompactArena<mNode>::emplace(TERMINAL_SLOT, {{{{nullptr, Complex::zero}, {nullptr, Complex::zero}, {nullptr, Complex::zero}, {nullptr, Complex::zero}}},
+                                                                                                       nullptr,
+                                                                                                       0,
+                                                                                                       -1,
+                                                                                                       true,
+                                                                                                       true});
+#else
     inline Package::vNode Package::vNode::terminalNode{{{{nullptr, Complex::zero}, {nullptr, Complex::zero}}},
                                                        nullptr,
                                                        0,
@@ -2519,6 +4459,7 @@ namespace dd {
             -1,
             true,
             true};
+#endif
 
     template<>
     [[nodiscard]] inline UniqueTable<Package::vNode>& Package::getUniqueTable() { return vUniqueTable; }
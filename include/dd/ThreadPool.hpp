@@ -0,0 +1,209 @@
+/*
+ * This file is part of the JKQ DD Package which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_dd/ for more information.
+ */
+
+#ifndef DDpackage_THREADPOOL_HPP
+#define DDpackage_THREADPOOL_HPP
+
+#include "Definitions.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dd {
+
+    /// Work-stealing thread pool for fork/join parallelism
+    /// Every thread (identified by dd::workerIndex, the thread creating the pool being worker 0) owns a queue of tasks.
+    /// Tasks are pushed to and taken from the back of the own queue, while idle threads steal from the front of the
+    /// queues of other threads. Threads waiting for a task to finish execute other tasks in the meantime.
+    class ThreadPool {
+    public:
+        /// Base class of all tasks executed by the pool
+        class Task {
+        public:
+            virtual ~Task() = default;
+            virtual void run() = 0;
+
+            [[nodiscard]] bool finished() const { return done.load(std::memory_order_acquire); }
+
+        private:
+            friend class ThreadPool;
+            std::atomic<bool>  done{false};
+            std::exception_ptr error{};
+        };
+
+        // create a pool with `nthreads` workers in total, i.e., `nthreads - 1` threads are spawned in addition to the calling one
+        explicit ThreadPool(std::size_t nthreads):
+            queues(std::max<std::size_t>(nthreads, 1)) {
+            for (std::size_t i = 1; i < queues.size(); ++i) {
+                threads.emplace_back([this, i]() { work(i); });
+            }
+        }
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> guard(sleepMutex);
+                stopping = true;
+            }
+            wakeup.notify_all();
+            for (auto& thread: threads) {
+                thread.join();
+            }
+        }
+
+        ThreadPool(const ThreadPool& pool) = delete;
+        ThreadPool& operator=(const ThreadPool& pool) = delete;
+
+        [[nodiscard]] std::size_t size() const { return queues.size(); }
+
+        // schedule a task for execution. The task must stay alive until it has finished.
+        void submit(Task& task) {
+            {
+                auto&                       queue = queues[workerIndex];
+                std::lock_guard<std::mutex> guard(queue.mutex);
+                queue.tasks.push_back(&task);
+            }
+            queued.fetch_add(1, std::memory_order_release);
+            {
+                // synchronize with workers that are about to fall asleep
+                std::lock_guard<std::mutex> guard(sleepMutex);
+            }
+            wakeup.notify_one();
+        }
+
+        // wait for a task to finish while executing other tasks. Exceptions raised by the task are rethrown.
+        void wait(Task& task) {
+            while (!task.finished()) {
+                if (auto* other = take(); other != nullptr) {
+                    execute(*other);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+            if (task.error) {
+                std::rethrow_exception(task.error);
+            }
+        }
+
+        // evaluate f(0), ..., f(N-1) in parallel, f(0) is evaluated by the calling thread
+        template<std::size_t N, class F>
+        void parallelFor(const F& f) {
+            static_assert(N > 0);
+            std::array<IndexedTask<F>, N - 1> tasks{};
+            for (std::size_t i = 0; i < tasks.size(); ++i) {
+                tasks[i].function = &f;
+                tasks[i].index    = i + 1;
+                submit(tasks[i]);
+            }
+
+            std::exception_ptr error{};
+            try {
+                f(0);
+            } catch (...) {
+                error = std::current_exception();
+            }
+
+            // the most recently submitted tasks are the most likely ones to still reside in the own queue
+            for (auto it = tasks.rbegin(); it != tasks.rend(); ++it) {
+                try {
+                    wait(*it);
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+
+    private:
+        template<class F>
+        class IndexedTask: public Task {
+        public:
+            const F*    function{};
+            std::size_t index{};
+
+            void run() override { (*function)(index); }
+        };
+
+        struct alignas(64) Queue {
+            std::mutex        mutex{};
+            std::deque<Task*> tasks{};
+        };
+
+        std::vector<Queue>       queues;
+        std::vector<std::thread> threads{};
+        std::atomic<std::size_t> queued{0};
+
+        std::mutex              sleepMutex{};
+        std::condition_variable wakeup{};
+        bool                    stopping = false;
+
+        // take a task from the back of the own queue or steal one from the front of another queue
+        Task* take() {
+            const auto self = workerIndex;
+            if (queued.load(std::memory_order_acquire) == 0) {
+                return nullptr;
+            }
+            {
+                auto&                       queue = queues[self];
+                std::lock_guard<std::mutex> guard(queue.mutex);
+                if (!queue.tasks.empty()) {
+                    auto* task = queue.tasks.back();
+                    queue.tasks.pop_back();
+                    queued.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            for (std::size_t offset = 1; offset < queues.size(); ++offset) {
+                auto&                       queue = queues[(self + offset) % queues.size()];
+                std::lock_guard<std::mutex> guard(queue.mutex);
+                if (!queue.tasks.empty()) {
+                    auto* task = queue.tasks.front();
+                    queue.tasks.pop_front();
+                    queued.fetch_sub(1, std::memory_order_relaxed);
+                    return task;
+                }
+            }
+            return nullptr;
+        }
+
+        static void execute(Task& task) {
+            try {
+                task.run();
+            } catch (...) {
+                task.error = std::current_exception();
+            }
+            task.done.store(true, std::memory_order_release);
+        }
+
+        void work(std::size_t index) {
+            workerIndex = index;
+            while (true) {
+                if (auto* task = take(); task != nullptr) {
+                    execute(*task);
+                    continue;
+                }
+                std::unique_lock<std::mutex> lock(sleepMutex);
+                wakeup.wait(lock, [this]() { return stopping || queued.load(std::memory_order_acquire) > 0; });
+                if (stopping) {
+                    return;
+                }
+            }
+        }
+    };
+
+} // namespace dd
+
+#endif //DDpackage_THREADPOOL_HPP
@@ -11,7 +11,9 @@
 
 #include <cstddef>
 #include <iostream>
+#include <map>
 #include <set>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -75,7 +77,16 @@ namespace dd {
         }
 
         [[nodiscard]] fp hitRatio() const { return static_cast<fp>(hits) / lookups; }
-        std::ostream&    printStatistics(std::ostream& os = std::cout) {
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"hits", hits},
+                    {"lookups", lookups},
+                    {"count", count},
+            };
+        }
+
+        std::ostream& printStatistics(std::ostream& os = std::cout) {
             os << "hits: " << hits << ", looks: " << lookups << ", ratio: " << hitRatio() << std::endl;
             return os;
         }
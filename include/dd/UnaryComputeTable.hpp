@@ -6,78 +6,175 @@
 #ifndef DDpackage_UNARYCOMPUTETABLE_HPP
 #define DDpackage_UNARYCOMPUTETABLE_HPP
 
+#include "ComputeTable.hpp"
 #include "Definitions.hpp"
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <cstddef>
 #include <iostream>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
 #include <utility>
+#include <vector>
 
 namespace dd {
 
     /// Data structure for caching computed results of unary operations
+    /// Supports the same concurrent mode as the ComputeTable (see enableConcurrency).
     /// \tparam OperandType type of the operation's operand
     /// \tparam ResultType type of the operation's result
-    /// \tparam NBUCKET number of hash buckets to use (has to be a power of two)
+    /// \tparam NBUCKET default number of hash buckets to use (has to be a power of two)
     template<class OperandType, class ResultType, std::size_t NBUCKET = 32768>
     class UnaryComputeTable {
     public:
-        UnaryComputeTable() = default;
+        explicit UnaryComputeTable(std::size_t nbuckets = NBUCKET) {
+            resize(nbuckets);
+        }
 
         struct Entry {
             OperandType operand;
             ResultType  result;
         };
 
-        static constexpr size_t MASK = NBUCKET - 1;
-
         // access functions
-        [[nodiscard]] const auto& getTable() const { return table; }
+        [[nodiscard]] Entry getEntry(std::size_t key) const { return table[key].load(); }
+
+        [[nodiscard]] std::size_t getBuckets() const { return table.size(); }
+
+        [[nodiscard]] bool isConcurrent() const { return concurrent; }
+
+        // change the number of buckets (has to be a power of two). Valid entries are rehashed into the new table and
+        // their number is returned.
+        std::size_t resize(std::size_t nbuckets) {
+            assert(!concurrent);
+            if (nbuckets == 0 || (nbuckets & (nbuckets - 1)) != 0) {
+                throw std::invalid_argument("Number of compute table buckets has to be a power of two, but is " + std::to_string(nbuckets) + ".");
+            }
+            auto old = std::move(table);
+            table    = std::vector<VersionedEntry<Entry>>(nbuckets);
+            mask     = nbuckets - 1;
+            std::size_t rehashed = 0;
+            for (const auto& slot: old) {
+                const auto entry = slot.load();
+                if (entry.result.p != nullptr) {
+                    table[hash(entry.operand)].store(entry);
+                    ++rehashed;
+                }
+            }
+            return rehashed;
+        }
 
-        static std::size_t hash(const OperandType& a) {
-            return std::hash<OperandType>{}(a)&MASK;
+        // double the number of buckets if the table has been used heavily, i.e., if at least `fillFactor` times as many
+        // results as there are buckets have been inserted, while the hit ratio stayed below `maxHitRatio`.
+        // Statistics are reset after resizing, except that the rehashed entries are counted, so that clear() still wipes
+        // them. Returns whether the table has been resized.
+        bool growIfThrashing(fp maxHitRatio, fp fillFactor, std::size_t maxBuckets) {
+            const auto buckets = getBuckets();
+            if (buckets >= maxBuckets || getLookups() == 0) {
+                return false;
+            }
+            if (static_cast<fp>(getCount()) < fillFactor * static_cast<fp>(buckets) || hitRatio() >= maxHitRatio) {
+                return false;
+            }
+            const auto rehashed = resize(2 * buckets);
+            std::fill(stats.begin(), stats.end(), Statistics{});
+            stats[0].count = rehashed;
+            return true;
+        }
+
+        // prepare the table for being accessed by `nthreads` threads at the same time
+        void enableConcurrency(std::size_t nthreads) {
+            if (stats.size() < nthreads) {
+                stats.resize(nthreads);
+            }
+            concurrent = true;
+        }
+        void disableConcurrency() { concurrent = false; }
+
+        [[nodiscard]] std::size_t hash(const OperandType& a) const {
+            return std::hash<OperandType>{}(a)&mask;
         }
 
         void insert(const OperandType& operand, const ResultType& result) {
             const auto key = hash(operand);
-            table[key]     = {operand, result};
-            ++count;
+            if (concurrent) {
+                if (table[key].tryStore({operand, result})) {
+                    ++stats[workerIndex].count;
+                }
+                return;
+            }
+            table[key].store({operand, result});
+            ++stats[0].count;
         }
 
         ResultType lookup(const OperandType& operand) {
             ResultType result{};
-            lookups++;
-            const auto key   = hash(operand);
-            auto&      entry = table[key];
+            auto&      statistics = stats[concurrent ? workerIndex : 0];
+            statistics.lookups++;
+            const auto key = hash(operand);
+            Entry      entry{};
+            if (concurrent) {
+                if (!table[key].tryLoad(entry)) return result;
+            } else {
+                entry = table[key].load();
+            }
             if (entry.result.p == nullptr) return result;
             if (entry.operand != operand) return result;
 
-            hits++;
+            statistics.hits++;
             return entry.result;
         }
 
         void clear() {
-            if (count > 0) {
+            if (getCount() > 0) {
                 for (auto& entry: table)
-                    entry.result.p = nullptr;
-                count = 0;
+                    entry.store(Entry{});
             }
-            hits    = 0;
-            lookups = 0;
+            std::fill(stats.begin(), stats.end(), Statistics{});
         }
 
-        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(hits) / lookups; }
-        std::ostream&    printStatistics(std::ostream& os = std::cout) {
-            os << "hits: " << hits << ", looks: " << lookups << ", ratio: " << hitRatio() << std::endl;
+        [[nodiscard]] std::size_t getHits() const {
+            return std::accumulate(stats.begin(), stats.end(), std::size_t{0}, [](auto sum, const auto& s) { return sum + s.hits; });
+        }
+        [[nodiscard]] std::size_t getLookups() const {
+            return std::accumulate(stats.begin(), stats.end(), std::size_t{0}, [](auto sum, const auto& s) { return sum + s.lookups; });
+        }
+        [[nodiscard]] std::size_t getCount() const {
+            return std::accumulate(stats.begin(), stats.end(), std::size_t{0}, [](auto sum, const auto& s) { return sum + s.count; });
+        }
+
+        [[nodiscard]] fp hitRatio() const { return static_cast<fp>(getHits()) / getLookups(); }
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"hits", getHits()},
+                    {"lookups", getLookups()},
+                    {"count", getCount()},
+            };
+        }
+
+        std::ostream& printStatistics(std::ostream& os = std::cout) {
+            os << "hits: " << getHits() << ", looks: " << getLookups() << ", ratio: " << hitRatio() << std::endl;
             return os;
         }
 
     private:
-        std::array<Entry, NBUCKET> table{};
-        // compute table lookup statistics
-        std::size_t hits    = 0;
-        std::size_t lookups = 0;
-        std::size_t count   = 0;
+        std::vector<VersionedEntry<Entry>> table{};
+        std::size_t                        mask = 0;
+
+        // compute table lookup statistics (one set per thread)
+        struct alignas(64) Statistics {
+            std::size_t hits    = 0;
+            std::size_t lookups = 0;
+            std::size_t count   = 0;
+        };
+        std::vector<Statistics> stats = std::vector<Statistics>(1);
+
+        bool concurrent = false;
     };
 } // namespace dd
 
@@ -6,32 +6,61 @@
 #ifndef DDpackage_UNIQUETABLE_HPP
 #define DDpackage_UNIQUETABLE_HPP
 
+#include "CompactPointer.hpp"
 #include "ComplexNumbers.hpp"
 #include "Definitions.hpp"
 #include "Edge.hpp"
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <numeric>
+#include <shared_mutex>
 #include <stdexcept>
+#include <string>
+#include <tuple>
 #include <vector>
 
 namespace dd {
 
+    // organization of the buckets of a unique table
+    enum class UniqueTableLayout {
+        Chaining,      // nodes hashing to the same bucket are chained through Node::next
+        OpenAddressing // buckets store a node and its hash, collisions are resolved by linear probing
+    };
+
     /// Data structure for providing and uniquely storing DD nodes
+    /// The table can be switched to a concurrent mode (see enableConcurrency), in which multiple threads may
+    /// simultaneously look up and create nodes. New nodes are inserted at the head of a bucket using CAS and
+    /// each thread (identified by dd::workerIndex) uses its own free list of nodes.
+    /// The buckets of every variable start small and are doubled by rehashing whenever the variable's nodes
+    /// outnumber them (for chaining) or fill half of them (for open addressing).
+    /// With the open addressing layout, every bucket holds a node pointer next to the node's full hash, which serves
+    /// as a fingerprint, so that most mismatches are rejected without accessing the node. In concurrent mode, nodes
+    /// are inserted by claiming an empty bucket using CAS, while growing the buckets of a variable excludes all other
+    /// threads from accessing them.
+    /// Garbage may also be collected incrementally (see setIncrementalCollection): nodes that are inserted or lose
+    /// their last reference are recorded on a candidate list per variable, and every call to collectCandidates only
+    /// visits a bounded number of these candidates instead of all buckets.
     /// \tparam Node class of nodes to provide/store
-    /// \tparam NBUCKET number of hash buckets to use (has to be a power of two)
+    /// \tparam NBUCKET initial number of hash buckets per variable (has to be a power of two)
     /// \tparam INITIAL_ALLOCATION_SIZE number if nodes initially allocated
     /// \tparam GROWTH_PERCENTAGE percentage that the allocations' size shall grow over time
     /// \tparam INITIAL_GC_LIMIT number of nodes initially used as garbage collection threshold
-    /// \tparam GC_INCREMENT absolute number of nodes to increase the garbage collection threshold after garbage collection has been performed
-    template<class Node, std::size_t NBUCKET = 32768, std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2, std::size_t INITIAL_GC_LIMIT = 131072>
+    /// \tparam LAYOUT organization of the hash buckets
+    /// \tparam Allocator allocator used for the chunks of nodes
+    template<class Node, std::size_t NBUCKET = 1024, std::size_t INITIAL_ALLOCATION_SIZE = 2048, std::size_t GROWTH_FACTOR = 2, std::size_t INITIAL_GC_LIMIT = 131072, UniqueTableLayout LAYOUT = UniqueTableLayout::Chaining, template<class> class Allocator = DefaultChunkAllocator>
     class UniqueTable {
+        static_assert(NBUCKET > 0 && (NBUCKET & (NBUCKET - 1)) == 0, "Number of buckets has to be a power of two");
+
     public:
         explicit UniqueTable(std::size_t nvars):
             nvars(nvars), chunkID(0), allocationSize(INITIAL_ALLOCATION_SIZE), gcLimit(INITIAL_GC_LIMIT) {
@@ -41,21 +70,58 @@ namespace dd {
             allocationSize *= GROWTH_FACTOR;
             chunkIt    = chunks[0].begin();
             chunkEndIt = chunks[0].end();
+            resize(nvars);
         }
 
         ~UniqueTable() = default;
 
-        static constexpr std::size_t MASK = NBUCKET - 1;
-
+        // change the number of variables. The buckets of superfluous variables are released together with their nodes,
+        // which must not be referenced anymore.
         void resize(std::size_t nq) {
+            assert(!concurrent);
+            for (auto v = nq; v < nvars; ++v) {
+                if (active[v] > 0) {
+                    throw std::invalid_argument("Unique table cannot be shrunk to " + std::to_string(nq) + " variables, since nodes of variable " + std::to_string(v) + " are still in use.");
+                }
+            }
+            for (auto v = nq; v < nvars; ++v) {
+                releaseNodes(v);
+            }
+
             nvars = nq;
-            tables.resize(nq);
-            // TODO: if the new size is smaller than the old one we might have to release the unique table entries for the superfluous variables
+            if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                levels.resize(nq);
+                for (auto& level: levels) {
+                    if (level == nullptr) {
+                        level = std::make_unique<Level>();
+                    }
+                }
+            } else {
+                tables.resize(nq);
+                tables.shrink_to_fit();
+                for (auto& table: tables) {
+                    if (table.empty()) {
+                        table = std::vector<Bucket>(NBUCKET);
+                    }
+                }
+                chained.resize(nq);
+            }
+            candidates.resize(nq);
+            candidateCount = countCandidates();
             active.resize(nq);
             activeNodeCount = std::accumulate(active.begin(), active.end(), 0UL);
         }
 
-        static std::size_t hash(const Node* p) {
+        // bucket of the node's variable the node belongs to
+        [[nodiscard]] std::size_t hash(const Node* p) const {
+            if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                return fullHash(p) & levels[static_cast<std::size_t>(p->v)]->mask;
+            } else {
+                return fullHash(p) & (tables[static_cast<std::size_t>(p->v)].size() - 1);
+            }
+        }
+
+        static std::size_t fullHash(const Node* p) {
             std::size_t key = 0;
             for (std::size_t i = 0; i < p->e.size(); ++i) {
                 key = dd::combineHash(key, std::hash<Edge<Node>>{}(p->e[i]));
@@ -64,7 +130,6 @@ namespace dd {
                 //             (reinterpret_cast<std::size_t>(p->e[i].w.r) >>  i) +
                 //             (reinterpret_cast<std::size_t>(p->e[i].w.i) >> (i + 1))) & MASK;
             }
-            key &= MASK;
             return key;
         }
 
@@ -77,10 +142,81 @@ namespace dd {
 
         [[nodiscard]] std::size_t getAllocations() const { return allocations; }
 
+        // amount of memory (in bytes) occupied by nodes that is kept for reuse when the table is cleared
+        [[nodiscard]] std::size_t getRetainedMemory() const { return retainedMemory; }
+        void                      setRetainedMemory(std::size_t bytes) { retainedMemory = bytes; }
+
         [[nodiscard]] float getGrowthFactor() const { return GROWTH_FACTOR; }
 
         [[nodiscard]] const auto& getTables() const { return tables; }
 
+        // number of buckets used for the nodes of a variable
+        [[nodiscard]] std::size_t getBuckets(Qubit var) const {
+            if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                return levels.at(static_cast<std::size_t>(var))->slots.size();
+            } else {
+                return tables.at(static_cast<std::size_t>(var)).size();
+            }
+        }
+
+        [[nodiscard]] bool isConcurrent() const { return concurrent; }
+
+        // prepare the table for being accessed by `nthreads` threads at the same time.
+        // Only lookup, getNode and returnNode may be used while the table is in concurrent mode.
+        void enableConcurrency(std::size_t nthreads) {
+            assert(!concurrent);
+            workers.clear();
+            workers.resize(std::max<std::size_t>(nthreads, 1));
+            for (auto& worker: workers) {
+                worker.levelInserts.assign(nvars, 0);
+                worker.candidates.clear();
+            }
+            concurrent = true;
+        }
+
+        // return to single-threaded operation. Statistics and free lists of the individual threads are merged.
+        void disableConcurrency() {
+            if (!concurrent)
+                return;
+
+            for (auto& worker: workers) {
+                while (worker.available != nullptr) {
+                    Node* p          = worker.available;
+                    worker.available = p->next;
+                    p->next          = available;
+                    available        = p;
+                }
+                lookups += worker.lookups;
+                hits += worker.hits;
+                collisions += worker.collisions;
+                nodeCount += worker.inserts;
+                for (Node* p: worker.candidates) {
+                    addCandidate(p);
+                }
+                if constexpr (LAYOUT == UniqueTableLayout::Chaining) {
+                    for (std::size_t v = 0; v < nvars; ++v) {
+                        chained[v] += worker.levelInserts[v];
+                    }
+                }
+            }
+            peakNodeCount = std::max(peakNodeCount, nodeCount);
+            workers.clear();
+            concurrent = false;
+
+            // chains may have grown beyond the load limit, since buckets are not rehashed in concurrent mode
+            if constexpr (LAYOUT == UniqueTableLayout::Chaining) {
+                for (std::size_t v = 0; v < nvars; ++v) {
+                    auto nbuckets = tables[v].size();
+                    while (chained[v] > nbuckets) {
+                        nbuckets *= 2;
+                    }
+                    if (nbuckets != tables[v].size()) {
+                        rehashChains(v, nbuckets);
+                    }
+                }
+            }
+        }
+
         // lookup a node in the unique table for the appropriate variable; insert it, if it has not been found
         // NOTE: reference counting is to be adjusted by function invoking the table lookup and only normalized nodes shall be stored.
         Edge<Node> lookup(const Edge<Node>& e, bool keepNode = false) {
@@ -88,15 +224,56 @@ namespace dd {
             if (e.isTerminal())
                 return e;
 
+            return lookupHashed(e, fullHash(e.p), keepNode);
+        }
+
+        // compute the hash of a (normalized) node and prefetch the bucket it is going to be looked up in. Preparing the
+        // lookups of several nodes this way before resolving them with lookupHashed lets their cache misses overlap.
+        // The hash does not depend on the number of buckets, i.e., it stays valid if the table is rehashed meanwhile.
+        [[nodiscard]] std::size_t prefetch(const Node* p) const {
+            if (Node::isTerminal(p))
+                return 0;
+
+            const auto nodeHash = fullHash(p);
+            if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                // in concurrent mode, the slots of a level may only be accessed while holding its lock
+                if (!concurrent) {
+                    const auto& level = *levels[static_cast<std::size_t>(p->v)];
+                    dd::prefetch(&level.slots[(nodeHash | FINGERPRINT_MARK) & level.mask]);
+                }
+            } else {
+                const auto& table = tables[static_cast<std::size_t>(p->v)];
+                dd::prefetch(&table[nodeHash & (table.size() - 1)]);
+            }
+            return nodeHash;
+        }
+
+        // lookup a node whose hash has been determined by prefetch (see lookup)
+        Edge<Node> lookupHashed(const Edge<Node>& e, std::size_t nodeHash, bool keepNode = false) {
+            // there are unique terminal nodes
+            if (e.isTerminal())
+                return e;
+
+            assert(nodeHash == fullHash(e.p));
+            if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                return concurrent ? lookupOpenAddressingConcurrent(e, nodeHash, keepNode) : lookupOpenAddressing(e, nodeHash, keepNode);
+            }
+
+            if (concurrent)
+                return lookupConcurrent(e, nodeHash, keepNode);
+
             lookups++;
-            const auto key = hash(e.p);
-            const auto v   = e.p->v;
+            const auto v = e.p->v;
+            if (chained[static_cast<std::size_t>(v)] >= tables[static_cast<std::size_t>(v)].size()) {
+                rehashChains(static_cast<std::size_t>(v), 2 * tables[static_cast<std::size_t>(v)].size());
+            }
+            const auto key = nodeHash & (tables[static_cast<std::size_t>(v)].size() - 1);
 
             // successors of a node shall either have successive variable numbers or be terminals
             for ([[maybe_unused]] const auto& edge: e.p->e)
                 assert(edge.p->v == v - 1 || edge.isTerminal());
 
-            Node* p = tables[v][key];
+            Node* p = tables[v][key].load(std::memory_order_relaxed);
             while (p != nullptr) {
                 if (e.p->e == p->e) {
                     // Match found
@@ -120,97 +297,102 @@ namespace dd {
             }
 
             // node was not found -> add it to front of unique table bucket
-            e.p->next      = tables[v][key];
-            tables[v][key] = e.p;
+            e.p->next = tables[v][key].load(std::memory_order_relaxed);
+            tables[v][key].store(e.p, std::memory_order_relaxed);
+            chained[static_cast<std::size_t>(v)]++;
             nodeCount++;
             peakNodeCount = std::max(peakNodeCount, nodeCount);
+            addCandidate(e.p);
 
             return e;
         }
 
         [[nodiscard]] Node* getNode() {
-            // a node is available on the stack
-            if (available != nullptr) {
-                Node* p   = available;
-                available = p->next;
-                // returned nodes could have a ref count != 0
-                p->ref = 0;
+            if (concurrent) {
+                auto& worker = workers[workerIndex];
+                if (worker.available == nullptr) {
+                    // refill the thread-local free list from the shared pool
+                    std::lock_guard<std::mutex> guard(poolMutex);
+                    for (std::size_t i = 0; i < CONCURRENT_BATCH_SIZE; ++i) {
+                        Node* p          = getSharedNode();
+                        p->next          = worker.available;
+                        worker.available = p;
+                    }
+                }
+                Node* p          = worker.available;
+                worker.available = p->next;
+                p->ref           = 0;
                 return p;
             }
-
-            // new chunk has to be allocated
-            if (chunkIt == chunkEndIt) {
-                chunks.emplace_back(allocationSize);
-                allocations += allocationSize;
-                allocationSize *= GROWTH_FACTOR;
-                chunkID++;
-                chunkIt    = chunks[chunkID].begin();
-                chunkEndIt = chunks[chunkID].end();
-            }
-
-            auto p = &(*chunkIt);
-            ++chunkIt;
-            return p;
+            return getSharedNode();
         }
 
         void returnNode(Node* p) {
+            if (concurrent) {
+                auto& worker     = workers[workerIndex];
+                p->next          = worker.available;
+                worker.available = p;
+                return;
+            }
             p->next   = available;
             available = p;
         }
 
         // increment reference counter for node e points to
-        // and recursively increment reference counter for
+        // and (iteratively) increment reference counter for
         // each child if this is the first reference
         void incRef(const Edge<Node>& e) {
             dd::ComplexNumbers::incRef(e.w);
-            if (e.p == nullptr || e.isTerminal())
-                return;
-
-            if (e.p->ref == std::numeric_limits<decltype(e.p->ref)>::max()) {
-                std::clog << "[WARN] MAXREFCNT reached for p=" << reinterpret_cast<std::uintptr_t>(e.p)
-                          << ". Node will never be collected." << std::endl;
+            if (e.p == nullptr || e.isTerminal() || !incRefNode(e.p))
                 return;
-            }
-
-            e.p->ref++;
 
-            if (e.p->ref == 1) {
-                for (const auto& edge: e.p->e) {
-                    if (edge.p != nullptr) {
-                        incRef(edge);
+            refStack.clear();
+            refStack.push_back(e.p);
+            while (!refStack.empty()) {
+                const Node* p = refStack.back();
+                refStack.pop_back();
+                for (const auto& edge: p->e) {
+                    if (edge.p == nullptr)
+                        continue;
+                    dd::ComplexNumbers::incRef(edge.w);
+                    if (!edge.isTerminal() && incRefNode(edge.p)) {
+                        refStack.push_back(edge.p);
                     }
                 }
-                active[e.p->v]++;
-                activeNodeCount++;
-                maxActive = std::max(maxActive, activeNodeCount);
             }
         }
 
         // decrement reference counter for node e points to
-        // and recursively decrement reference counter for
+        // and (iteratively) decrement reference counter for
         // each child if this is the last reference
         void decRef(const Edge<Node>& e) {
             dd::ComplexNumbers::decRef(e.w);
-            if (e.p == nullptr || e.isTerminal()) return;
-            if (e.p->ref == std::numeric_limits<decltype(e.p->ref)>::max()) return;
-
-            if (e.p->ref == 0) {
-                throw std::runtime_error("In decref: ref==0 before decref\n");
-            }
-
-            e.p->ref--;
+            if (e.p == nullptr || e.isTerminal() || !decRefNode(e.p))
+                return;
 
-            if (e.p->ref == 0) {
-                for (const auto& edge: e.p->e) {
-                    if (edge.p != nullptr) {
-                        decRef(edge);
+            refStack.clear();
+            refStack.push_back(e.p);
+            while (!refStack.empty()) {
+                const Node* p = refStack.back();
+                refStack.pop_back();
+                for (const auto& edge: p->e) {
+                    if (edge.p == nullptr)
+                        continue;
+                    dd::ComplexNumbers::decRef(edge.w);
+                    if (!edge.isTerminal() && decRefNode(edge.p)) {
+                        refStack.push_back(edge.p);
                     }
                 }
-                active[e.p->v]--;
-                activeNodeCount--;
             }
         }
 
+        // replace a referenced root by another one. References are added before they are removed, so that parts
+        // shared by both DDs never lose their last reference and are not traversed.
+        void swapRoots(const Edge<Node>& oldRoot, const Edge<Node>& newRoot) {
+            incRef(newRoot);
+            decRef(oldRoot);
+        }
+
         [[nodiscard]] bool possiblyNeedsCollection() const { return nodeCount >= gcLimit; }
 
         std::size_t garbageCollect(bool force = false) {
@@ -221,16 +403,39 @@ namespace dd {
             gcRuns++;
             std::size_t collected = 0;
             std::size_t remaining = 0;
-            for (auto& table: tables) {
-                for (auto& bucket: table) {
-                    Node* p     = bucket;
+            for (auto& level: levels) {
+                std::size_t alive = 0;
+                for (auto& slot: level->slots) {
+                    Node* p = slot.node.load(std::memory_order_relaxed);
+                    if (p == nullptr) {
+                        continue;
+                    }
+                    if (p->ref == 0) {
+                        assert(!Node::isTerminal(p));
+                        slot.node.store(nullptr, std::memory_order_relaxed);
+                        returnNode(p);
+                        collected++;
+                    } else {
+                        alive++;
+                    }
+                }
+                // removing nodes interrupts probe sequences, so the remaining nodes have to be rehashed
+                if (alive != level->filled.load(std::memory_order_relaxed)) {
+                    rehash(*level, level->slots.size());
+                }
+                remaining += alive;
+            }
+            for (std::size_t v = 0; v < tables.size(); ++v) {
+                std::size_t alive = 0;
+                for (auto& bucket: tables[v]) {
+                    Node* p     = bucket.load(std::memory_order_relaxed);
                     Node* lastp = nullptr;
                     while (p != nullptr) {
                         if (p->ref == 0) {
                             assert(!Node::isTerminal(p));
                             Node* next = p->next;
                             if (lastp == nullptr) {
-                                bucket = next;
+                                bucket.store(next, std::memory_order_relaxed);
                             } else {
                                 lastp->next = next;
                             }
@@ -240,10 +445,12 @@ namespace dd {
                         } else {
                             lastp = p;
                             p     = p->next;
-                            remaining++;
+                            alive++;
                         }
                     }
                 }
+                chained[v] = alive;
+                remaining += alive;
             }
             // The garbage collection limit changes dynamically depending on the number of remaining (active) nodes.
             // If it were not changed, garbage collection would run through the complete table on each successive call
@@ -257,32 +464,88 @@ namespace dd {
             //                gcLimit /= 4;
             //            }
             nodeCount = remaining;
+            clearCandidates();
             return collected;
         }
 
+        // collect garbage by visiting at most `budget` of the recorded candidates (see setIncrementalCollection).
+        // Candidates that have been referenced again or have already been collected are skipped.
+        std::size_t collectCandidates(std::size_t budget) {
+            gcCalls++;
+            if (nodeCount < gcLimit || nodeCount == 0)
+                return 0;
+
+            gcRuns++;
+            std::size_t collected = 0;
+            for (auto& list: candidates) {
+                while (!list.empty() && budget > 0) {
+                    Node* p = list.back();
+                    list.pop_back();
+                    --candidateCount;
+                    --budget;
+                    if (p->ref == 0 && unlink(p)) {
+                        returnNode(p);
+                        collected++;
+                    }
+                }
+            }
+            nodeCount -= collected;
+            // as for a full collection, the limit is raised if mostly active nodes remain once all candidates have been visited
+            if (candidateCount == 0 && nodeCount > gcLimit / 10 * 9) {
+                gcLimit = nodeCount + INITIAL_GC_LIMIT;
+            }
+            return collected;
+        }
+
+        // record garbage candidates for incremental collection. Disabling it discards all recorded candidates.
+        void setIncrementalCollection(bool enable) {
+            assert(!concurrent);
+            incremental = enable;
+            if (!enable) {
+                clearCandidates();
+            }
+        }
+        [[nodiscard]] bool        isIncrementalCollection() const { return incremental; }
+        [[nodiscard]] std::size_t getCandidateCount() const { return candidateCount; }
+
         void clear() {
-            // clear unique table buckets
+            // clear unique table buckets and restore their initial size
             for (auto& table: tables) {
-                for (auto& bucket: table) {
-                    bucket = nullptr;
+                if (table.size() == NBUCKET) {
+                    for (auto& bucket: table) {
+                        bucket.store(nullptr, std::memory_order_relaxed);
+                    }
+                } else {
+                    table = std::vector<Bucket>(NBUCKET);
                 }
             }
+            std::fill(chained.begin(), chained.end(), 0);
+            for (auto& level: levels) {
+                level = std::make_unique<Level>();
+            }
+            clearCandidates();
             // clear available stack
             available = nullptr;
 
-            // release memory of all but the first chunk TODO: it could be desirable to keep the memory
-            while (chunkID > 0) {
-                chunks.pop_back();
-                chunkID--;
+            // release memory of all but the first chunk, except for chunks fitting into the retained memory
+            std::size_t retained = chunks[0].size();
+            std::size_t keep     = 1;
+            while (keep < chunks.size() && (retained + chunks[keep].size()) * sizeof(Node) <= retainedMemory) {
+                retained += chunks[keep].size();
+                ++keep;
             }
+            chunks.erase(chunks.begin() + static_cast<std::ptrdiff_t>(keep), chunks.end());
             // restore initial chunk setting
+            chunkID        = 0;
             chunkIt        = chunks[0].begin();
             chunkEndIt     = chunks[0].end();
-            allocationSize = INITIAL_ALLOCATION_SIZE * GROWTH_FACTOR;
-            allocations    = INITIAL_ALLOCATION_SIZE;
+            allocationSize = chunks.back().size() * GROWTH_FACTOR;
+            allocations    = retained;
 
-            for (auto& node: chunks[0]) {
-                node.ref = 0;
+            for (auto& chunk: chunks) {
+                for (auto& node: chunk) {
+                    node.ref = 0;
+                }
             }
 
             nodeCount     = 0;
@@ -302,29 +565,31 @@ namespace dd {
         };
 
         void print() {
-            Qubit q = nvars - 1;
-            for (auto it = tables.rbegin(); it != tables.rend(); ++it) {
-                auto& table = *it;
+            for (auto q = static_cast<Qubit>(nvars - 1); q >= 0; --q) {
                 std::cout << "\tq" << static_cast<std::size_t>(q) << ":"
                           << "\n";
-                for (std::size_t key = 0; key < table.size(); ++key) {
-                    auto p = table[key];
-                    if (p != nullptr)
-                        std::cout << "\tkey=" << key << ": ";
+                if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                    const auto& slots = levels[static_cast<std::size_t>(q)]->slots;
+                    for (std::size_t key = 0; key < slots.size(); ++key) {
+                        const Node* p = slots[key].node.load(std::memory_order_relaxed);
+                        if (p != nullptr) {
+                            std::cout << "\tkey=" << key << ": ";
+                            printNode(p);
+                        }
+                    }
+                } else {
+                    const auto& table = tables[static_cast<std::size_t>(q)];
+                    for (std::size_t key = 0; key < table.size(); ++key) {
+                        const Node* p = table[key].load(std::memory_order_relaxed);
+                        if (p != nullptr)
+                            std::cout << "\tkey=" << key << ": ";
 
-                    while (p != nullptr) {
-                        std::cout << "\t\t" << std::hex << reinterpret_cast<std::uintptr_t>(p) << std::dec << " "
-                                  << p->ref << std::hex;
-                        for (const auto& e: p->e) {
-                            std::cout << " p" << reinterpret_cast<std::uintptr_t>(e.p) << "(r"
-                                      << reinterpret_cast<std::uintptr_t>(e.w.r) << " i"
-                                      << reinterpret_cast<std::uintptr_t>(e.w.i) << ")";
+                        while (p != nullptr) {
+                            printNode(p);
+                            p = p->next;
                         }
-                        std::cout << std::dec << "\n";
-                        p = p->next;
                     }
                 }
-                --q;
             }
         }
 
@@ -343,7 +608,24 @@ namespace dd {
             return activeNodeCount;
         }
 
-        [[nodiscard]] std::size_t getActiveNodeCount(Qubit var) { return active.at(var); }
+        [[nodiscard]] std::size_t getActiveNodeCount(Qubit var) const { return active.at(var); }
+
+        std::map<std::string, std::size_t> getStatistics() const {
+            return {
+                    {"hits", hits},
+                    {"collisions", collisions},
+                    {"lookups", lookups},
+                    {"nodeCount", nodeCount},
+                    {"peakNodeCount", peakNodeCount},
+                    {"activeNodeCount", activeNodeCount},
+                    {"maxActiveNodes", maxActive},
+                    {"allocations", allocations},
+                    {"gcCalls", gcCalls},
+                    {"gcRuns", gcRuns},
+                    {"gcLimit", gcLimit},
+                    {"gcCandidates", candidateCount},
+            };
+        }
 
         std::ostream& printStatistics(std::ostream& os = std::cout) {
             os << "hits: " << hits << ", collisions: " << collisions << ", looks: " << lookups << ", hitRatio: "
@@ -353,23 +635,45 @@ namespace dd {
         }
 
     private:
-        using NodeBucket = Node*;
-        using Table      = std::array<NodeBucket, NBUCKET>;
+        using Bucket = std::atomic<Node*>;
+        using Table  = std::vector<Bucket>;
 
-        // unique tables (one per input variable)
-        std::size_t        nvars = 0;
-        std::vector<Table> tables{nvars};
+        // bucket of the open addressing layout. The fingerprint of an occupied bucket is the node's hash with the
+        // highest bit set. In concurrent mode, it may still be zero right after the node has been inserted.
+        struct Slot {
+            std::atomic<Node*>       node{nullptr};
+            std::atomic<std::size_t> fingerprint{0};
+        };
+        static constexpr std::size_t FINGERPRINT_MARK = std::size_t{1} << (std::numeric_limits<std::size_t>::digits - 1);
 
-        Node*                                available{};
-        std::vector<std::vector<Node>>       chunks{};
-        std::size_t                          chunkID;
-        typename std::vector<Node>::iterator chunkIt;
-        typename std::vector<Node>::iterator chunkEndIt;
-        std::size_t                          allocationSize;
+        struct Level {
+            std::vector<Slot>        slots = std::vector<Slot>(NBUCKET);
+            std::size_t              mask  = NBUCKET - 1;
+            std::atomic<std::size_t> filled{0};
+            // only used in concurrent mode (shared for lookups, exclusive for growing)
+            std::shared_mutex mutex{};
+        };
 
-        std::size_t allocations   = 0;
-        std::size_t nodeCount     = 0;
-        std::size_t peakNodeCount = 0;
+        // unique tables (one per input variable) and the number of nodes stored in each of them
+        std::size_t              nvars = 0;
+        std::vector<Table>       tables{};
+        std::vector<std::size_t> chained{};
+
+        // buckets of the open addressing layout (one set per input variable)
+        std::vector<std::unique_ptr<Level>> levels{};
+
+        using Chunk = std::vector<Node, Allocator<Node>>;
+        Node*                    available{};
+        std::vector<Chunk>       chunks{};
+        std::size_t              chunkID;
+        typename Chunk::iterator chunkIt;
+        typename Chunk::iterator chunkEndIt;
+        std::size_t              allocationSize;
+
+        std::size_t allocations    = 0;
+        std::size_t nodeCount      = 0;
+        std::size_t peakNodeCount  = 0;
+        std::size_t retainedMemory = 0;
 
         // unique table lookup statistics
         std::size_t collisions = 0;
@@ -382,10 +686,404 @@ namespace dd {
         std::size_t              activeNodeCount = 0;
         std::size_t              maxActive       = 0;
 
+        // nodes whose children still have to be visited while updating reference counts
+        std::vector<Node*> refStack{};
+
+        // incremental garbage collection: nodes possibly having become garbage (one list per variable).
+        // Lists may contain nodes that have been referenced again or collected already as well as duplicates.
+        bool                            incremental = false;
+        std::vector<std::vector<Node*>> candidates{};
+        std::size_t                     candidateCount = 0;
+
         // garbage collection
         std::size_t gcCalls = 0;
         std::size_t gcRuns  = 0;
         std::size_t gcLimit = 250000;
+
+        // concurrent operation
+        static constexpr std::size_t CONCURRENT_BATCH_SIZE = 64;
+
+        struct alignas(64) Worker {
+            Node*       available  = nullptr;
+            std::size_t lookups    = 0;
+            std::size_t hits       = 0;
+            std::size_t collisions = 0;
+            std::size_t inserts    = 0;
+            // nodes inserted per variable
+            std::vector<std::size_t> levelInserts{};
+            // garbage candidates recorded in concurrent mode
+            std::vector<Node*> candidates{};
+        };
+
+        bool                concurrent = false;
+        std::vector<Worker> workers{};
+        std::mutex          poolMutex{};
+
+        // redistribute the nodes of a variable to `nbuckets` buckets
+        void rehashChains(std::size_t v, std::size_t nbuckets) {
+            auto old  = std::move(tables[v]);
+            tables[v] = Table(nbuckets);
+            for (auto& bucket: old) {
+                Node* p = bucket.load(std::memory_order_relaxed);
+                while (p != nullptr) {
+                    Node*      next = p->next;
+                    const auto key  = fullHash(p) & (nbuckets - 1);
+                    p->next         = tables[v][key].load(std::memory_order_relaxed);
+                    tables[v][key].store(p, std::memory_order_relaxed);
+                    p = next;
+                }
+            }
+        }
+
+        // return all nodes of a variable to the free list
+        void releaseNodes(std::size_t v) {
+            std::size_t released = 0;
+            if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                for (auto& slot: levels[v]->slots) {
+                    if (Node* p = slot.node.load(std::memory_order_relaxed); p != nullptr) {
+                        returnNode(p);
+                        released++;
+                    }
+                }
+            } else {
+                for (auto& bucket: tables[v]) {
+                    Node* p = bucket.load(std::memory_order_relaxed);
+                    while (p != nullptr) {
+                        Node* next = p->next;
+                        returnNode(p);
+                        released++;
+                        p = next;
+                    }
+                }
+            }
+            nodeCount -= released;
+        }
+
+        void addCandidate(Node* p) {
+            if (!incremental)
+                return;
+            candidates[static_cast<std::size_t>(p->v)].push_back(p);
+            // keep the lists proportional to the number of nodes by dropping nodes that are in use again and duplicates
+            if (++candidateCount > 2 * nodeCount + INITIAL_ALLOCATION_SIZE) {
+                for (auto& list: candidates) {
+                    list.erase(std::remove_if(list.begin(), list.end(), [](const Node* q) { return q->ref != 0; }), list.end());
+                    std::sort(list.begin(), list.end());
+                    list.erase(std::unique(list.begin(), list.end()), list.end());
+                }
+                candidateCount = countCandidates();
+            }
+        }
+
+        void clearCandidates() {
+            for (auto& list: candidates) {
+                list.clear();
+            }
+            candidateCount = 0;
+        }
+
+        [[nodiscard]] std::size_t countCandidates() const {
+            return std::accumulate(candidates.begin(), candidates.end(), std::size_t{0}, [](auto sum, const auto& list) { return sum + list.size(); });
+        }
+
+        // remove a node from the buckets of its variable. Returns false if the node is not stored in the table.
+        bool unlink(Node* p) {
+            const auto v = static_cast<std::size_t>(p->v);
+            if (v >= nvars) {
+                return false;
+            }
+            if constexpr (LAYOUT == UniqueTableLayout::OpenAddressing) {
+                auto& level = *levels[v];
+                for (auto key = fullHash(p) & level.mask;; key = (key + 1) & level.mask) {
+                    Node* q = level.slots[key].node.load(std::memory_order_relaxed);
+                    if (q == nullptr) {
+                        return false;
+                    }
+                    if (q == p) {
+                        eraseSlot(level, key);
+                        return true;
+                    }
+                }
+            } else {
+                auto& bucket = tables[v][hash(p)];
+                Node* q      = bucket.load(std::memory_order_relaxed);
+                Node* lastq  = nullptr;
+                while (q != nullptr && q != p) {
+                    lastq = q;
+                    q     = q->next;
+                }
+                if (q == nullptr) {
+                    return false;
+                }
+                if (lastq == nullptr) {
+                    bucket.store(p->next, std::memory_order_relaxed);
+                } else {
+                    lastq->next = p->next;
+                }
+                chained[v]--;
+                return true;
+            }
+        }
+
+        // empty a bucket of the open addressing layout and move subsequent nodes of the probe sequence into the gap
+        // (backward shift deletion), so that all remaining nodes stay reachable from their home buckets
+        static void eraseSlot(Level& level, std::size_t key) {
+            auto next = key;
+            while (true) {
+                level.slots[key].node.store(nullptr, std::memory_order_relaxed);
+                std::size_t home = 0;
+                do {
+                    next    = (next + 1) & level.mask;
+                    Node* q = level.slots[next].node.load(std::memory_order_relaxed);
+                    if (q == nullptr) {
+                        level.filled.fetch_sub(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    home = level.slots[next].fingerprint.load(std::memory_order_relaxed) & level.mask;
+                    // a node may stay where it is if its home bucket lies cyclically in (key, next]
+                } while (key <= next ? (key < home && home <= next) : (key < home || home <= next));
+                level.slots[key].fingerprint.store(level.slots[next].fingerprint.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                level.slots[key].node.store(level.slots[next].node.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                key = next;
+            }
+        }
+
+        static void printNode(const Node* p) {
+            std::cout << "\t\t" << std::hex << reinterpret_cast<std::uintptr_t>(p) << std::dec << " "
+                      << p->ref << std::hex;
+            for (const auto& e: p->e) {
+                std::cout << " p" << reinterpret_cast<std::uintptr_t>(toPointer(e.p)) << "(r"
+                          << reinterpret_cast<std::uintptr_t>(toPointer(e.w.r)) << " i"
+                          << reinterpret_cast<std::uintptr_t>(toPointer(e.w.i)) << ")";
+            }
+            std::cout << std::dec << "\n";
+        }
+
+        // increment the reference count of a single node. Returns whether this has been its first reference.
+        bool incRefNode(Node* p) {
+            if (p->ref == std::numeric_limits<decltype(p->ref)>::max()) {
+                std::clog << "[WARN] MAXREFCNT reached for p=" << reinterpret_cast<std::uintptr_t>(p)
+                          << ". Node will never be collected." << std::endl;
+                return false;
+            }
+
+            p->ref++;
+            if (p->ref != 1)
+                return false;
+
+            active[p->v]++;
+            activeNodeCount++;
+            maxActive = std::max(maxActive, activeNodeCount);
+            return true;
+        }
+
+        // decrement the reference count of a single node. Returns whether this has been its last reference.
+        bool decRefNode(Node* p) {
+            if (p->ref == std::numeric_limits<decltype(p->ref)>::max())
+                return false;
+
+            if (p->ref == 0) {
+                throw std::runtime_error("In decref: ref==0 before decref\n");
+            }
+
+            p->ref--;
+            if (p->ref != 0)
+                return false;
+
+            active[p->v]--;
+            activeNodeCount--;
+            addCandidate(p);
+            return true;
+        }
+
+        // obtain a node from the (shared) free list or the current chunk
+        Node* getSharedNode() {
+            // a node is available on the stack
+            if (available != nullptr) {
+                Node* p   = available;
+                available = p->next;
+                // returned nodes could have a ref count != 0
+                p->ref = 0;
+                return p;
+            }
+
+            // new chunk has to be allocated (unless a retained one is available)
+            if (chunkIt == chunkEndIt) {
+                if (chunkID + 1 == chunks.size()) {
+                    chunks.emplace_back(allocationSize);
+                    allocations += allocationSize;
+                    allocationSize *= GROWTH_FACTOR;
+                }
+                chunkID++;
+                chunkIt    = chunks[chunkID].begin();
+                chunkEndIt = chunks[chunkID].end();
+            }
+
+            auto p = &(*chunkIt);
+            ++chunkIt;
+            return p;
+        }
+
+        Edge<Node> lookupConcurrent(const Edge<Node>& e, std::size_t nodeHash, bool keepNode) {
+            auto& worker = workers[workerIndex];
+            worker.lookups++;
+            const auto v   = e.p->v;
+            const auto key = nodeHash & (tables[v].size() - 1);
+
+            auto& bucket = tables[v][key];
+            Node* head   = bucket.load(std::memory_order_acquire);
+            Node* stop   = nullptr;
+            while (true) {
+                for (Node* p = head; p != stop; p = p->next) {
+                    if (e.p->e == p->e) {
+                        if (e.p != p && !keepNode) {
+                            returnNode(e.p);
+                        }
+                        worker.hits++;
+                        assert(p->v == e.p->v);
+                        return {p, e.w};
+                    }
+                    worker.collisions++;
+                }
+
+                // node was not found -> try to add it to the front of the bucket
+                e.p->next = head;
+                if (bucket.compare_exchange_weak(head, e.p, std::memory_order_release, std::memory_order_acquire)) {
+                    worker.inserts++;
+                    worker.levelInserts[static_cast<std::size_t>(v)]++;
+                    if (incremental) {
+                        worker.candidates.push_back(e.p);
+                    }
+                    return e;
+                }
+                // the bucket has been modified in the meantime -> only the newly added nodes have to be checked
+                stop = e.p->next;
+            }
+        }
+
+        // whether a level has to grow before another node may be inserted (keeps the load factor at most 1/2)
+        [[nodiscard]] static bool isCrowded(const Level& level) {
+            return 2 * (level.filled.load(std::memory_order_relaxed) + 1) > level.slots.size();
+        }
+
+        // redistribute the nodes of a level to `nslots` buckets
+        static void rehash(Level& level, std::size_t nslots) {
+            auto old    = std::move(level.slots);
+            level.slots = std::vector<Slot>(nslots);
+            level.mask  = nslots - 1;
+
+            std::size_t filled = 0;
+            for (const auto& slot: old) {
+                Node* p = slot.node.load(std::memory_order_relaxed);
+                if (p == nullptr) {
+                    continue;
+                }
+                const auto fingerprint = slot.fingerprint.load(std::memory_order_relaxed);
+                auto       key         = fingerprint & level.mask;
+                while (level.slots[key].node.load(std::memory_order_relaxed) != nullptr) {
+                    key = (key + 1) & level.mask;
+                }
+                level.slots[key].fingerprint.store(fingerprint, std::memory_order_relaxed);
+                level.slots[key].node.store(p, std::memory_order_relaxed);
+                ++filled;
+            }
+            level.filled.store(filled, std::memory_order_relaxed);
+        }
+
+        // search the buckets of a level for a node with the same successors as `p`, starting at bucket `key`.
+        // Returns the node found (or nullptr) and the bucket the search stopped at.
+        static std::pair<Node*, std::size_t> probe(const Level& level, const Node* p, std::size_t fingerprint, std::size_t key, std::size_t& collisions) {
+            while (true) {
+                Node* q = level.slots[key].node.load(std::memory_order_acquire);
+                if (q == nullptr) {
+                    return {nullptr, key};
+                }
+                const auto f = level.slots[key].fingerprint.load(std::memory_order_acquire);
+                if ((f == fingerprint || f == 0) && q->e == p->e) {
+                    return {q, key};
+                }
+                collisions++;
+                key = (key + 1) & level.mask;
+            }
+        }
+
+        Edge<Node> lookupOpenAddressing(const Edge<Node>& e, std::size_t nodeHash, bool keepNode) {
+            lookups++;
+            const auto fingerprint = nodeHash | FINGERPRINT_MARK;
+            auto&      level       = *levels[static_cast<std::size_t>(e.p->v)];
+            if (isCrowded(level)) {
+                rehash(level, 2 * level.slots.size());
+            }
+
+            const auto [p, key] = probe(level, e.p, fingerprint, fingerprint & level.mask, collisions);
+            if (p != nullptr) {
+                if (e.p != p && !keepNode) {
+                    returnNode(e.p);
+                }
+                hits++;
+                assert(p->v == e.p->v);
+                return {p, e.w};
+            }
+
+            // node was not found -> add it to the empty bucket
+            level.slots[key].fingerprint.store(fingerprint, std::memory_order_relaxed);
+            level.slots[key].node.store(e.p, std::memory_order_relaxed);
+            level.filled.fetch_add(1, std::memory_order_relaxed);
+            nodeCount++;
+            peakNodeCount = std::max(peakNodeCount, nodeCount);
+            addCandidate(e.p);
+            return e;
+        }
+
+        Edge<Node> lookupOpenAddressingConcurrent(const Edge<Node>& e, std::size_t nodeHash, bool keepNode) {
+            auto& worker = workers[workerIndex];
+            worker.lookups++;
+            const auto fingerprint = nodeHash | FINGERPRINT_MARK;
+            auto&      level       = *levels[static_cast<std::size_t>(e.p->v)];
+
+            std::shared_lock<std::shared_mutex> lock(level.mutex);
+            while (true) {
+                auto [p, key] = probe(level, e.p, fingerprint, fingerprint & level.mask, worker.collisions);
+                if (p == nullptr) {
+                    // node was not found -> reserve space for it, which guarantees that an empty bucket remains
+                    if (2 * (level.filled.fetch_add(1, std::memory_order_relaxed) + 1) > level.slots.size()) {
+                        level.filled.fetch_sub(1, std::memory_order_relaxed);
+                        lock.unlock();
+                        {
+                            std::unique_lock<std::shared_mutex> guard(level.mutex);
+                            if (isCrowded(level)) {
+                                rehash(level, 2 * level.slots.size());
+                            }
+                        }
+                        lock.lock();
+                        continue;
+                    }
+                }
+                while (p == nullptr) {
+                    // try to claim the empty bucket
+                    Node* expected = nullptr;
+                    if (level.slots[key].node.compare_exchange_strong(expected, e.p, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        level.slots[key].fingerprint.store(fingerprint, std::memory_order_release);
+                        worker.inserts++;
+                        if (incremental) {
+                            worker.candidates.push_back(e.p);
+                        }
+                        return e;
+                    }
+                    // another thread inserted a node in the meantime -> continue the search at this bucket
+                    std::tie(p, key) = probe(level, e.p, fingerprint, key, worker.collisions);
+                    if (p != nullptr) {
+                        level.filled.fetch_sub(1, std::memory_order_relaxed);
+                    }
+                }
+
+                if (e.p != p && !keepNode) {
+                    returnNode(e.p);
+                }
+                worker.hits++;
+                assert(p->v == e.p->v);
+                return {p, e.w};
+            }
+        }
     };
 
 } // namespace dd
@@ -0,0 +1,61 @@
+/*
+ * This file is part of the JKQ DD Package which is released under the MIT license.
+ * See file README.md or go to http://iic.jku.at/eda/research/quantum_dd/ for more information.
+ */
+
+#ifndef DD_PACKAGE_VISITEDNODES_HPP
+#define DD_PACKAGE_VISITEDNODES_HPP
+
+#include <cstddef>
+#include <vector>
+
+namespace dd {
+
+    /// Set of the nodes visited by a traversal of a decision diagram
+    /// Membership is recorded in the `visited` flag of the nodes themselves, so that inserting and testing a node takes
+    /// constant time without hashing. The marked nodes are remembered in order to reset their flags on destruction.
+    /// The terminal node is shared by all packages and is never marked. Consequently, at most one set may exist for the
+    /// nodes of a package at any time, i.e., traversals of the same package must neither be nested nor run concurrently.
+    /// \tparam Node type of the nodes
+    template<class Node>
+    class VisitedNodes {
+    public:
+        VisitedNodes() = default;
+        ~VisitedNodes() {
+            for (auto* p: marked) {
+                p->visited = false;
+            }
+        }
+
+        VisitedNodes(const VisitedNodes& other) = delete;
+        VisitedNodes& operator=(const VisitedNodes& other) = delete;
+
+        // mark `p` as visited and return whether it has not been visited before
+        bool insert(Node* p) {
+            if (Node::isTerminal(p)) {
+                const auto inserted = !terminalVisited;
+                terminalVisited     = true;
+                return inserted;
+            }
+            if (p->visited) {
+                return false;
+            }
+            p->visited = true;
+            marked.push_back(p);
+            return true;
+        }
+
+        [[nodiscard]] bool contains(const Node* p) const {
+            return Node::isTerminal(p) ? terminalVisited : p->visited;
+        }
+
+        [[nodiscard]] std::size_t size() const { return marked.size() + (terminalVisited ? 1U : 0U); }
+
+    private:
+        std::vector<Node*> marked{};
+        bool               terminalVisited = false;
+    };
+
+} // namespace dd
+
+#endif //DD_PACKAGE_VISITEDNODES_HPP
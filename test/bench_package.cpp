@@ -6,8 +6,11 @@
 #include "dd/GateMatrixDefinitions.hpp"
 #include "dd/Package.hpp"
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
 #include <memory>
+#include <random>
+#include <vector>
 
 using namespace dd::literals;
 
@@ -50,6 +53,29 @@ static void BM_ComplexNumbersCreation(benchmark::State& state) {
 }
 BENCHMARK(BM_ComplexNumbersCreation)->Unit(benchmark::kMicrosecond);
 
+static void BM_ComplexTableLookup(benchmark::State& state) {
+    // the table holds state.range(0) values per bucket on average, all of which are looked up again
+    using Table = dd::ComplexTable<>;
+
+    auto                                   ct      = std::make_unique<Table>();
+    const std::size_t                      nvalues = static_cast<std::size_t>(state.range(0)) * (Table::MASK + 1);
+    std::mt19937_64                        mt(42U);
+    std::uniform_real_distribution<dd::fp> dist(0., 1.);
+    std::vector<dd::fp>                    values(nvalues);
+    for (auto& value: values) {
+        value = dist(mt);
+        ct->lookup(value);
+    }
+    std::shuffle(values.begin(), values.end(), mt);
+    for (auto _: state) {
+        for (const auto value: values) {
+            benchmark::DoNotOptimize(ct->lookup(value));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * nvalues));
+}
+BENCHMARK(BM_ComplexTableLookup)->Unit(benchmark::kMillisecond)->RangeMultiplier(4)->Range(1, 64);
+
 static void BM_PackageCreation(benchmark::State& state) {
     [[maybe_unused]] auto nqubits = state.range(0);
     for (auto _: state) {
@@ -60,6 +86,58 @@ static void BM_PackageCreation(benchmark::State& state) {
 }
 BENCHMARK(BM_PackageCreation)->Unit(benchmark::kMillisecond)->RangeMultiplier(2)->Range(2, 128);
 
+///
+/// Test normalization of nodes (the weights of the successors are known to the complex table after the first round)
+///
+
+static void BM_NormalizeVectorNode(benchmark::State& state) {
+    auto                                   dd = std::make_unique<dd::Package>(1);
+    std::mt19937_64                        mt(42U);
+    std::uniform_real_distribution<dd::fp> dist(-.5, .5);
+
+    std::vector<std::array<dd::Package::vEdge, dd::RADIX>> successors(static_cast<std::size_t>(state.range(0)));
+    for (auto& edges: successors) {
+        for (auto& edge: edges) {
+            edge = {dd::Package::vNode::terminal, dd->cn.lookup(dist(mt), dist(mt))};
+        }
+    }
+    auto* node = dd->vUniqueTable.getNode();
+    node->v    = 0;
+    for (auto _: state) {
+        for (const auto& edges: successors) {
+            node->e = edges;
+            benchmark::DoNotOptimize(dd->normalize(dd::Package::vEdge{node, dd::Complex::one}, false));
+        }
+    }
+    dd->vUniqueTable.returnNode(node);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * successors.size()));
+}
+BENCHMARK(BM_NormalizeVectorNode)->Unit(benchmark::kMicrosecond)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
+static void BM_NormalizeMatrixNode(benchmark::State& state) {
+    auto                                   dd = std::make_unique<dd::Package>(1);
+    std::mt19937_64                        mt(42U);
+    std::uniform_real_distribution<dd::fp> dist(-.5, .5);
+
+    std::vector<std::array<dd::Package::mEdge, dd::NEDGE>> successors(static_cast<std::size_t>(state.range(0)));
+    for (auto& edges: successors) {
+        for (auto& edge: edges) {
+            edge = {dd::Package::mNode::terminal, dd->cn.lookup(dist(mt), dist(mt))};
+        }
+    }
+    auto* node = dd->mUniqueTable.getNode();
+    node->v    = 0;
+    for (auto _: state) {
+        for (const auto& edges: successors) {
+            node->e = edges;
+            benchmark::DoNotOptimize(dd->normalize(dd::Package::mEdge{node, dd::Complex::one}, false));
+        }
+    }
+    dd->mUniqueTable.returnNode(node);
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * successors.size()));
+}
+BENCHMARK(BM_NormalizeMatrixNode)->Unit(benchmark::kMicrosecond)->RangeMultiplier(16)->Range(1 << 8, 1 << 16);
+
 ///
 /// Test creation of identity matrix
 ///
@@ -186,6 +264,25 @@ static void BM_MakeFullControlledToffoliDD_TargetBottom(benchmark::State& state)
 }
 BENCHMARK(BM_MakeFullControlledToffoliDD_TargetBottom)->Apply(QubitRange);
 
+static void BM_MakeRotationGateDD_Rebuilt(benchmark::State& state) {
+    auto nqubits = state.range(0);
+    auto dd      = std::make_unique<dd::Package>(nqubits);
+    for (auto _: state) {
+        dd->gateTable.clear();
+        benchmark::DoNotOptimize(dd->makeGateDD(dd::RZmat(0.3), nqubits, 0_pc, static_cast<dd::Qubit>(nqubits / 2)));
+    }
+}
+BENCHMARK(BM_MakeRotationGateDD_Rebuilt)->Apply(QubitRange);
+
+static void BM_MakeRotationGateDD_Cached(benchmark::State& state) {
+    auto nqubits = state.range(0);
+    auto dd      = std::make_unique<dd::Package>(nqubits);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dd->makeGateDD(dd::RZmat(0.3), nqubits, 0_pc, static_cast<dd::Qubit>(nqubits / 2)));
+    }
+}
+BENCHMARK(BM_MakeRotationGateDD_Cached)->Apply(QubitRange);
+
 static void BM_MakeSWAPDD(benchmark::State& state) {
     auto nqubits = state.range(0);
     auto dd      = std::make_unique<dd::Package>(nqubits);
@@ -200,6 +297,17 @@ static void BM_MakeSWAPDD(benchmark::State& state) {
 }
 BENCHMARK(BM_MakeSWAPDD)->Apply(QubitRange);
 
+static void BM_MakeiSWAPDD(benchmark::State& state) {
+    auto nqubits = state.range(0);
+    auto dd      = std::make_unique<dd::Package>(nqubits);
+
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dd->makeiSWAPDD(nqubits, {}, 0, static_cast<dd::Qubit>(nqubits - 1)));
+        dd->clearComputeTables();
+    }
+}
+BENCHMARK(BM_MakeiSWAPDD)->Apply(QubitRange);
+
 ///
 /// Test multiplication
 ///
@@ -300,6 +408,38 @@ static void BM_MxV_HadamardLayer(benchmark::State& state) {
 }
 BENCHMARK(BM_MxV_HadamardLayer)->Apply(QubitRange);
 
+static void BM_MxV_HadamardLayerKernel(benchmark::State& state) {
+    auto nqubits = state.range(0);
+    auto dd      = std::make_unique<dd::Package>(nqubits);
+    auto zero    = dd->makeZeroState(nqubits);
+
+    for (auto _: state) {
+        auto sv = zero;
+        for (int i = 0; i < nqubits; ++i) {
+            sv = dd->applyGate(sv, dd::Hmat, {}, static_cast<dd::Qubit>(i));
+        }
+        // clear compute table so the next iteration does not find the result cached
+        dd->clearComputeTables();
+    }
+}
+BENCHMARK(BM_MxV_HadamardLayerKernel)->Apply(QubitRange);
+
+static void BM_MxV_GHZKernel(benchmark::State& state) {
+    auto nqubits = state.range(0);
+    auto dd      = std::make_unique<dd::Package>(nqubits);
+    auto zero    = dd->makeZeroState(nqubits);
+
+    for (auto _: state) {
+        auto sv = dd->applyGate(zero, dd::Hmat, {}, static_cast<dd::Qubit>(nqubits - 1));
+        for (auto i = static_cast<int>(nqubits - 2); i >= 0; --i) {
+            sv = dd->applyGate(sv, dd::Xmat, {dd::Control{static_cast<dd::Qubit>(nqubits - 1)}}, static_cast<dd::Qubit>(i));
+        }
+        // clear compute table so the next iteration does not find the result cached
+        dd->clearComputeTables();
+    }
+}
+BENCHMARK(BM_MxV_GHZKernel)->Apply(QubitRange);
+
 static void BM_MxV_GHZ(benchmark::State& state) {
     auto nqubits = state.range(0);
     auto dd      = std::make_unique<dd::Package>(nqubits);
@@ -319,6 +459,109 @@ static void BM_MxV_GHZ(benchmark::State& state) {
 }
 BENCHMARK(BM_MxV_GHZ)->Apply(QubitRange);
 
+// a layer of Hadamard and T gates, a chain of CNOTs and a layer of T and S gates (the state's DD stays linear in size)
+static std::vector<dd::GateOperation> layeredCircuit(dd::QubitCount nqubits) {
+    std::vector<dd::GateOperation> gates{};
+    for (int q = 0; q < nqubits; ++q) {
+        gates.push_back({dd::Hmat, {}, static_cast<dd::Qubit>(q)});
+        gates.push_back({dd::Tmat, {}, static_cast<dd::Qubit>(q)});
+    }
+    for (int q = 1; q < nqubits; ++q) {
+        gates.push_back({dd::Xmat, {dd::Control{static_cast<dd::Qubit>(q - 1)}}, static_cast<dd::Qubit>(q)});
+    }
+    for (int q = 0; q < nqubits; ++q) {
+        gates.push_back({dd::Tmat, {}, static_cast<dd::Qubit>(q)});
+        gates.push_back({dd::Smat, {}, static_cast<dd::Qubit>(q)});
+    }
+    return gates;
+}
+
+static void BM_MxV_GateSequence(benchmark::State& state) {
+    auto       nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto       dd      = std::make_unique<dd::Package>(nqubits);
+    auto       zero    = dd->makeZeroState(nqubits);
+    const auto gates   = layeredCircuit(nqubits);
+
+    for (auto _: state) {
+        auto sv = zero;
+        for (const auto& gate: gates) {
+            sv = dd->multiply(dd->makeGateDD(gate.matrix, nqubits, gate.controls, gate.target), sv);
+        }
+        benchmark::DoNotOptimize(sv);
+        // clear compute tables so the next iteration does not find the result cached (batching also fills the
+        // matrix multiplication table, which would otherwise dominate the time of small instances)
+        state.PauseTiming();
+        dd->clearComputeTables();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_MxV_GateSequence)->Apply(QubitRange);
+
+static void BM_MxV_GateSequenceBatched(benchmark::State& state) {
+    auto       nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto       dd      = std::make_unique<dd::Package>(nqubits);
+    auto       zero    = dd->makeZeroState(nqubits);
+    const auto gates   = layeredCircuit(nqubits);
+
+    for (auto _: state) {
+        auto sv = dd->applyGates(zero, gates, nqubits);
+        benchmark::DoNotOptimize(sv);
+        // clear compute tables so the next iteration does not find the result cached (batching also fills the
+        // matrix multiplication table, which would otherwise dominate the time of small instances)
+        state.PauseTiming();
+        dd->clearComputeTables();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_MxV_GateSequenceBatched)->Apply(QubitRange);
+
+static void BM_MeasureAllShots(benchmark::State& state) {
+    constexpr dd::QubitCount nqubits = 16;
+    const auto               shots   = static_cast<std::size_t>(state.range(0));
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+    auto                     sv      = dd->applyGates(dd->makeZeroState(nqubits), layeredCircuit(nqubits), nqubits);
+    dd->incRef(sv);
+    std::mt19937_64 mt{0};
+
+    for (auto _: state) {
+        std::map<std::string, std::size_t> histogram{};
+        for (std::size_t shot = 0; shot < shots; ++shot) {
+            ++histogram[dd->measureAll(sv, false, mt)];
+        }
+        benchmark::DoNotOptimize(histogram);
+    }
+}
+BENCHMARK(BM_MeasureAllShots)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_Sample(benchmark::State& state) {
+    constexpr dd::QubitCount nqubits = 16;
+    const auto               shots   = static_cast<std::size_t>(state.range(0));
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+    auto                     sv      = dd->applyGates(dd->makeZeroState(nqubits), layeredCircuit(nqubits), nqubits);
+    dd->incRef(sv);
+    std::mt19937_64 mt{0};
+
+    for (auto _: state) {
+        auto histogram = dd->sample(sv, shots, mt);
+        benchmark::DoNotOptimize(histogram);
+    }
+}
+BENCHMARK(BM_Sample)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_GetVector(benchmark::State& state) {
+    auto nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto dd      = std::make_unique<dd::Package>(nqubits);
+    auto sv      = dd->applyGates(dd->makeZeroState(nqubits), layeredCircuit(nqubits), nqubits);
+    dd->incRef(sv);
+    dd::CVec amplitudes(std::size_t{1} << nqubits);
+
+    for (auto _: state) {
+        dd->getVector(sv, amplitudes.data(), 0, amplitudes.size());
+        benchmark::DoNotOptimize(amplitudes.data());
+    }
+}
+BENCHMARK(BM_GetVector)->Unit(benchmark::kMillisecond)->DenseRange(16, 22, 2);
+
 static void BM_MxM_Bell(benchmark::State& state) {
     auto nqubits = state.range(0);
     auto dd      = std::make_unique<dd::Package>(nqubits);
@@ -335,8 +578,9 @@ static void BM_MxM_Bell(benchmark::State& state) {
 BENCHMARK(BM_MxM_Bell)->Apply(QubitRange);
 
 static void BM_MxM_GHZ(benchmark::State& state) {
-    auto nqubits = state.range(0);
-    auto dd      = std::make_unique<dd::Package>(nqubits);
+    auto   nqubits  = state.range(0);
+    auto   dd       = std::make_unique<dd::Package>(nqubits);
+    dd::fp hitRatio = 0.;
 
     for (auto _: state) {
         auto func = dd->makeGateDD(dd::Hmat, nqubits, static_cast<dd::Qubit>(nqubits - 1));
@@ -344,12 +588,74 @@ static void BM_MxM_GHZ(benchmark::State& state) {
             auto cx = dd->makeGateDD(dd::Xmat, nqubits, dd::Control{static_cast<dd::Qubit>(nqubits - 1)}, static_cast<dd::Qubit>(i));
             func    = dd->multiply(cx, func);
         }
+        hitRatio += dd->matrixMatrixMultiplication.hitRatio();
         // clear compute table so the next iteration does not find the result cached
         dd->clearComputeTables();
     }
+    state.counters["hitRatio"] = benchmark::Counter(hitRatio, benchmark::Counter::kAvgIterations);
 }
 BENCHMARK(BM_MxM_GHZ)->Apply(QubitRange);
 
+///
+/// Compute table associativity
+///
+/// Operands are drawn from a skewed distribution over a working set larger than the table,
+/// so that frequently used results compete with a long tail of rarely used ones for buckets.
+/// Results are only computed (i.e., inserted) on a miss, as in the DD operations. As in a recursion
+/// over a DD, every level holds about half as many operands as the level below, whereas recomputing
+/// a result costs about twice as much (reported as the recomputation cost per lookup).
+///
+
+template<std::size_t WAYS, dd::ComputeTableReplacement REPLACEMENT>
+static void BM_ComputeTableSkewedAccess(benchmark::State& state) {
+    using CachedEdge                 = dd::Package::vCachedEdge;
+    constexpr dd::QubitCount nqubits = 16;
+    const auto               buckets = static_cast<std::size_t>(state.range(0));
+    auto                     table   = std::make_unique<dd::ComputeTable<CachedEdge, CachedEdge, CachedEdge, 4096, WAYS, REPLACEMENT>>(buckets);
+
+    // the nodes of the zero state provide one node per level
+    auto dd   = std::make_unique<dd::Package>(nqubits);
+    auto zero = dd->makeZeroState(nqubits);
+    dd->incRef(zero);
+    std::vector<dd::Package::vNode*> nodes(nqubits);
+    for (auto* p = dd::toPointer(zero.p); !dd::Package::vNode::isTerminal(p); p = dd::toPointer(p->e[0].p)) {
+        nodes[static_cast<std::size_t>(p->v)] = p;
+    }
+
+    std::mt19937_64                  mt(42); // NOLINT(cert-msc51-cpp)
+    std::geometric_distribution<int> dist(1. / static_cast<double>(buckets));
+    std::vector<CachedEdge>          operands(1U << 16U);
+    for (auto& op: operands) {
+        const auto  index = static_cast<std::size_t>(dist(mt));
+        std::size_t level = 0;
+        while (level + 1 < nqubits && ((index + 1) >> level & 1U) == 0) {
+            ++level;
+        }
+        op = {nodes[level], dd::ComplexValue{static_cast<dd::fp>(index), 0.}};
+    }
+
+    double cost = 0.;
+    for (auto _: state) {
+        for (const auto& op: operands) {
+            auto r = table->lookup(op, op);
+            if (r.p == nullptr) {
+                cost += static_cast<double>(std::size_t{1} << static_cast<std::size_t>(op.p->v));
+                table->insert(op, op, op);
+            }
+            benchmark::DoNotOptimize(r);
+        }
+    }
+    state.counters["hitRatio"]      = table->hitRatio();
+    state.counters["recomputeCost"] = cost / static_cast<double>(state.iterations() * operands.size());
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * operands.size()));
+    dd->decRef(zero);
+}
+BENCHMARK_TEMPLATE(BM_ComputeTableSkewedAccess, 1, dd::ComputeTableReplacement::Age)->Unit(benchmark::kMicrosecond)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_TEMPLATE(BM_ComputeTableSkewedAccess, 2, dd::ComputeTableReplacement::Age)->Unit(benchmark::kMicrosecond)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_TEMPLATE(BM_ComputeTableSkewedAccess, 4, dd::ComputeTableReplacement::Age)->Unit(benchmark::kMicrosecond)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_TEMPLATE(BM_ComputeTableSkewedAccess, 2, dd::ComputeTableReplacement::Depth)->Unit(benchmark::kMicrosecond)->RangeMultiplier(4)->Range(256, 16384);
+BENCHMARK_TEMPLATE(BM_ComputeTableSkewedAccess, 4, dd::ComputeTableReplacement::Depth)->Unit(benchmark::kMicrosecond)->RangeMultiplier(4)->Range(256, 16384);
+
 static void BM_vUniqueTableGet(benchmark::State& state) {
     auto allocs = state.range(0);
     for (auto _: state) {
@@ -406,3 +712,223 @@ static void BM_mUniqueTableGetAndReturn(benchmark::State& state) {
     }
 }
 BENCHMARK(BM_mUniqueTableGetAndReturn)->Unit(benchmark::kMillisecond)->RangeMultiplier(10)->Range(10, 10000000);
+
+///
+/// Unique table layouts
+///
+/// Distinct nodes are inserted and looked up again, the tables' collision ratios are reported alongside the time.
+///
+
+template<dd::UniqueTableLayout LAYOUT>
+static void BM_UniqueTableLookup(benchmark::State& state) {
+    const auto nodes = static_cast<std::size_t>(state.range(0));
+    auto       dd    = std::make_unique<dd::Package>(1);
+
+    std::vector<dd::Complex> weights{};
+    weights.reserve(nodes);
+    for (std::size_t i = 0; i < nodes; ++i) {
+        weights.push_back(dd->cn.lookup(static_cast<dd::fp>(i) / static_cast<dd::fp>(nodes), 0.));
+    }
+
+    dd::fp colRatio = 0.;
+    for (auto _: state) {
+        auto unique = std::make_unique<dd::UniqueTable<dd::Package::vNode, 1024, 2048, 2, 131072, LAYOUT>>(1);
+        for (std::size_t repetition = 0; repetition < 2; ++repetition) {
+            for (const auto& w: weights) {
+                dd::Package::vEdge e{unique->getNode(), dd::Complex::one};
+                e.p->v = 0;
+                e.p->e = {dd::Package::vEdge::terminal(w), dd::Package::vEdge::terminal(dd::Complex::one)};
+                benchmark::DoNotOptimize(unique->lookup(e));
+            }
+        }
+        colRatio += unique->colRatio();
+    }
+    state.counters["colRatio"] = benchmark::Counter(colRatio, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK_TEMPLATE(BM_UniqueTableLookup, dd::UniqueTableLayout::Chaining)->Unit(benchmark::kMillisecond)->RangeMultiplier(4)->Range(1024, 1U << 18U);
+BENCHMARK_TEMPLATE(BM_UniqueTableLookup, dd::UniqueTableLayout::OpenAddressing)->Unit(benchmark::kMillisecond)->RangeMultiplier(4)->Range(1024, 1U << 18U);
+
+///
+/// Prefetched unique table lookups
+///
+/// Known nodes are looked up again in random order. The buckets of state.range(1) nodes are prefetched before the
+/// first of them is resolved (the first argument being the number of nodes).
+///
+
+template<dd::UniqueTableLayout LAYOUT>
+static void BM_UniqueTablePrefetchedLookup(benchmark::State& state) {
+    const auto nodes = static_cast<std::size_t>(state.range(0));
+    const auto batch = static_cast<std::size_t>(state.range(1));
+    auto       dd    = std::make_unique<dd::Package>(1);
+
+    std::vector<dd::Complex> weights{};
+    weights.reserve(nodes);
+    for (std::size_t i = 0; i < nodes; ++i) {
+        weights.push_back(dd->cn.lookup(static_cast<dd::fp>(i) / static_cast<dd::fp>(nodes), 0.));
+    }
+    auto       unique = std::make_unique<dd::UniqueTable<dd::Package::vNode, 1024, 2048, 2, 131072, LAYOUT>>(1);
+    const auto make   = [&](const dd::Complex& w) {
+        dd::Package::vEdge e{unique->getNode(), dd::Complex::one};
+        e.p->v = 0;
+        e.p->e = {dd::Package::vEdge::terminal(w), dd::Package::vEdge::terminal(dd::Complex::one)};
+        return e;
+    };
+    for (const auto& w: weights) {
+        unique->lookup(make(w));
+    }
+    std::shuffle(weights.begin(), weights.end(), std::mt19937_64(42U));
+
+    std::vector<dd::Package::vEdge> edges(batch);
+    std::vector<std::size_t>        hashes(batch);
+    for (auto _: state) {
+        for (std::size_t start = 0; start + batch <= nodes; start += batch) {
+            for (std::size_t k = 0; k < batch; ++k) {
+                edges[k]  = make(weights[start + k]);
+                hashes[k] = unique->prefetch(edges[k].p);
+            }
+            for (std::size_t k = 0; k < batch; ++k) {
+                benchmark::DoNotOptimize(unique->lookupHashed(edges[k], hashes[k]));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * nodes));
+}
+BENCHMARK_TEMPLATE(BM_UniqueTablePrefetchedLookup, dd::UniqueTableLayout::Chaining)->Unit(benchmark::kMillisecond)->ArgsProduct({{1U << 18U}, {1, 4, 8, 16}});
+BENCHMARK_TEMPLATE(BM_UniqueTablePrefetchedLookup, dd::UniqueTableLayout::OpenAddressing)->Unit(benchmark::kMillisecond)->ArgsProduct({{1U << 18U}, {1, 4, 8, 16}});
+
+///
+/// Test noise channels
+///
+
+static dd::Package::mEdge makeNoisyBenchmarkDensityMatrix(dd::Package& dd, dd::QubitCount nqubits) {
+    auto projector = dd.makeIdent(nqubits);
+    for (dd::Qubit q = 0; q < static_cast<dd::Qubit>(nqubits); ++q) {
+        projector = dd.multiply(dd.makeGateDD({dd::complex_one, dd::complex_zero, dd::complex_zero, dd::complex_zero}, nqubits, q), projector);
+    }
+    auto u = dd.makeGateDD(dd::Hmat, nqubits, 0);
+    for (dd::Qubit q = 1; q < static_cast<dd::Qubit>(nqubits); ++q) {
+        u = dd.multiply(dd.makeGateDD(dd::RYmat(0.1 * q), nqubits, q), u);
+        u = dd.multiply(dd.makeGateDD(dd::Xmat, nqubits, dd::Control{static_cast<dd::Qubit>(q - 1)}, q), u);
+    }
+    auto rho = dd.multiply(dd.multiply(u, projector), dd.conjugateTranspose(u));
+    dd.incRef(rho);
+    return rho;
+}
+
+static void BM_NoiseChannel_Depolarization(benchmark::State& state) {
+    auto       nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto       dd      = std::make_unique<dd::Package>(nqubits);
+    const auto rho     = makeNoisyBenchmarkDensityMatrix(*dd, nqubits);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dd->applyNoiseChannel(rho, dd::NoiseChannel::depolarization, static_cast<dd::Qubit>(nqubits / 2), 0.01));
+        state.PauseTiming();
+        dd->clearComputeTables();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_NoiseChannel_Depolarization)->Apply(QubitRange);
+
+static void BM_NoiseChannel_DepolarizationKraus(benchmark::State& state) {
+    auto       nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto       dd      = std::make_unique<dd::Package>(nqubits);
+    const auto rho     = makeNoisyBenchmarkDensityMatrix(*dd, nqubits);
+    const auto target  = static_cast<dd::Qubit>(nqubits / 2);
+    const auto p       = 0.01;
+
+    // Kraus operators sqrt(1 - 3p/4) I, sqrt(p/4) X, sqrt(p/4) Y and sqrt(p/4) Z
+    std::vector<dd::GateMatrix> operators{};
+    for (const auto& [mat, weight]: std::vector<std::pair<dd::GateMatrix, dd::fp>>{{dd::Imat, 1. - 3. * p / 4.}, {dd::Xmat, p / 4.}, {dd::Ymat, p / 4.}, {dd::Zmat, p / 4.}}) {
+        dd::GateMatrix op{};
+        for (std::size_t i = 0; i < dd::NEDGE; ++i) {
+            op[i] = {mat[i].r * std::sqrt(weight), mat[i].i * std::sqrt(weight)};
+        }
+        operators.push_back(op);
+    }
+    for (auto _: state) {
+        auto result = dd::Package::mEdge::zero;
+        for (const auto& op: operators) {
+            const auto k = dd->makeGateDD(op, nqubits, target);
+            result       = dd->add(result, dd->multiply(dd->multiply(k, rho), dd->conjugateTranspose(k)));
+        }
+        benchmark::DoNotOptimize(result);
+        state.PauseTiming();
+        dd->clearComputeTables();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_NoiseChannel_DepolarizationKraus)->Apply(QubitRange);
+
+///
+/// Test expectation values
+///
+
+static dd::Package::vEdge makeExpectationBenchmarkState(dd::Package& dd, dd::QubitCount nqubits) {
+    std::vector<dd::GateOperation> gates{{dd::Hmat, {}, 0}};
+    for (dd::Qubit q = 1; q < static_cast<dd::Qubit>(nqubits); ++q) {
+        gates.push_back({dd::RYmat(0.1 * q), {}, q});
+        gates.push_back({dd::Xmat, {dd::Control{static_cast<dd::Qubit>(q - 1)}}, q});
+    }
+    auto state = dd.applyGates(dd.makeZeroState(nqubits), gates, nqubits);
+    dd.incRef(state);
+    return state;
+}
+
+static std::string makeExpectationBenchmarkPauliString(dd::QubitCount nqubits) {
+    std::string pauli(nqubits, 'I');
+    for (std::size_t q = 0; q < nqubits; q += 2) {
+        pauli[q] = "XYZ"[q % 3];
+    }
+    return pauli;
+}
+
+static dd::Package::mEdge makeExpectationBenchmarkOperator(dd::Package& dd, dd::QubitCount nqubits) {
+    const auto pauli = makeExpectationBenchmarkPauliString(nqubits);
+    auto       op    = dd.makeIdent(nqubits);
+    for (std::size_t q = 0; q < nqubits; ++q) {
+        if (pauli[q] != 'I') {
+            const auto& mat = pauli[q] == 'X' ? dd::Xmat : (pauli[q] == 'Y' ? dd::Ymat : dd::Zmat);
+            op              = dd.multiply(dd.makeGateDD(mat, nqubits, static_cast<dd::Qubit>(q)), op);
+        }
+    }
+    dd.incRef(op);
+    return op;
+}
+
+static void BM_ExpectationValue_MultiplyInnerProduct(benchmark::State& state) {
+    auto       nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto       dd      = std::make_unique<dd::Package>(nqubits);
+    const auto psi     = makeExpectationBenchmarkState(*dd, nqubits);
+    const auto op      = makeExpectationBenchmarkOperator(*dd, nqubits);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dd->innerProduct(psi, dd->multiply(op, psi)));
+        state.PauseTiming();
+        dd->clearComputeTables();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_ExpectationValue_MultiplyInnerProduct)->Apply(QubitRange);
+
+static void BM_ExpectationValue(benchmark::State& state) {
+    auto       nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto       dd      = std::make_unique<dd::Package>(nqubits);
+    const auto psi     = makeExpectationBenchmarkState(*dd, nqubits);
+    const auto op      = makeExpectationBenchmarkOperator(*dd, nqubits);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dd->expectationValue(op, psi));
+        state.PauseTiming();
+        dd->clearComputeTables();
+        state.ResumeTiming();
+    }
+}
+BENCHMARK(BM_ExpectationValue)->Apply(QubitRange);
+
+static void BM_ExpectationValue_PauliString(benchmark::State& state) {
+    auto       nqubits = static_cast<dd::QubitCount>(state.range(0));
+    auto       dd      = std::make_unique<dd::Package>(nqubits);
+    const auto psi     = makeExpectationBenchmarkState(*dd, nqubits);
+    const auto pauli   = makeExpectationBenchmarkPauliString(nqubits);
+    for (auto _: state) {
+        benchmark::DoNotOptimize(dd->expectationValue(pauli, psi));
+    }
+}
+BENCHMARK(BM_ExpectationValue_PauliString)->Apply(QubitRange);
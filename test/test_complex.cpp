@@ -6,6 +6,7 @@
 #include "dd/ComplexNumbers.hpp"
 
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <memory>
 
 using namespace dd;
@@ -116,13 +117,13 @@ TEST(DDComplexTest, SortedBuckets) {
     const fp num = 0.25;
 
     const std::array<dd::fp, 7> numbers = {
-            num + 2. * ComplexTable<>::tolerance(),
-            num - 2. * ComplexTable<>::tolerance(),
-            num + 4. * ComplexTable<>::tolerance(),
+            num + 2 * ComplexTable<>::tolerance(),
+            num - 2 * ComplexTable<>::tolerance(),
+            num + 4 * ComplexTable<>::tolerance(),
             num,
-            num - 4. * ComplexTable<>::tolerance(),
-            num + 6. * ComplexTable<>::tolerance(),
-            num + 8. * ComplexTable<>::tolerance()};
+            num - 4 * ComplexTable<>::tolerance(),
+            num + 6 * ComplexTable<>::tolerance(),
+            num + 8 * ComplexTable<>::tolerance()};
 
     const std::size_t the_bucket = ct.hash(num);
 
@@ -131,19 +132,83 @@ TEST(DDComplexTest, SortedBuckets) {
         ct.lookup(number);
     }
 
-    CTEntry* p = ct.getTable().at(the_bucket);
-    ASSERT_NE(p, nullptr);
+    const auto& bucket = ct.getTable().at(the_bucket);
+    ASSERT_FALSE(bucket.empty());
 
-    dd::fp      last    = std::numeric_limits<dd::fp>::min();
-    std::size_t counter = 0;
-    while (p != nullptr) {
-        ASSERT_LT(last, p->value);
-        p = p->next;
-        ++counter;
+    dd::fp last = std::numeric_limits<dd::fp>::min();
+    for (std::size_t i = 0; i < bucket.size(); ++i) {
+        ASSERT_LT(last, bucket.values[i]);
+        EXPECT_EQ(bucket.values[i], bucket.entries[i]->value);
+        last = bucket.values[i];
     }
     ct.printStatistics(std::cout);
     EXPECT_EQ(ct.getStatistics().at("lowerNeighbors"), 1); // default insertion of 0.5 is close to lower bucket
-    EXPECT_EQ(counter, numbers.size());
+    EXPECT_EQ(bucket.size(), numbers.size());
+}
+
+TEST(DDComplexTest, LookupInLargeBucket) {
+    // few buckets, so that the values fit into a single bucket also with the tolerance of single precision
+    using Table  = ComplexTable<64>;
+    auto     ct  = Table{};
+    const fp num = 0.25;
+    const fp tol = Table::tolerance();
+
+    // fill a single bucket with more values than fit into a vector register, in an order that requires sorting
+    std::vector<Table::Entry*> entries{};
+    for (std::size_t i = 0; i < 19; ++i) {
+        const auto offset = static_cast<fp>((i * 7) % 19);
+        entries.push_back(ct.lookup(num + 3 * offset * tol));
+    }
+    const auto& bucket = ct.getTable().at(ct.hash(num));
+    ASSERT_EQ(bucket.size(), entries.size());
+    EXPECT_TRUE(std::is_sorted(bucket.values.begin(), bucket.values.end()));
+
+    // every value (and every value within the tolerance) is found at any position in the bucket
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        const auto offset = static_cast<fp>((i * 7) % 19);
+        EXPECT_EQ(ct.lookup(num + 3 * offset * tol), entries[i]);
+        EXPECT_EQ(ct.lookup(num + 3 * offset * tol + tol / 2), entries[i]);
+        EXPECT_EQ(ct.lookup(num + 3 * offset * tol - tol / 2), entries[i]);
+    }
+    EXPECT_EQ(bucket.size(), entries.size());
+
+    // values in between are inserted at their position and do not move the existing entries
+    const auto* between = ct.lookup(num + static_cast<fp>(4.5) * tol);
+    ASSERT_EQ(bucket.size(), entries.size() + 1);
+    EXPECT_TRUE(std::is_sorted(bucket.values.begin(), bucket.values.end()));
+    EXPECT_EQ(bucket.entries[2], between);
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        EXPECT_EQ(entries[i]->value, num + 3 * static_cast<fp>((i * 7) % 19) * tol);
+    }
+}
+
+TEST(DDComplexTest, IncrementalGarbageCollection) {
+    using Table = ComplexTable<64, 2048, 2, 16>;
+    auto ct     = Table{};
+
+    std::vector<Table::Entry*> entries{};
+    for (std::size_t i = 0; i < 64; ++i) {
+        entries.push_back(ct.lookup(static_cast<fp>(2 * i + 1) / 256.));
+    }
+    for (std::size_t i = 0; i < entries.size(); i += 2) {
+        Table::incRef(entries[i]);
+    }
+    const auto count = ct.getCount();
+
+    // every call sweeps eight buckets, so that the whole table is swept after eight calls
+    std::size_t collected = ct.garbageCollectIncrementally(8);
+    EXPECT_GT(collected, 0);
+    EXPECT_LT(collected, entries.size() / 2);
+    for (std::size_t calls = 1; calls < 8; ++calls) {
+        collected += ct.garbageCollectIncrementally(8);
+    }
+    EXPECT_EQ(collected, entries.size() / 2);
+    EXPECT_EQ(ct.getCount(), count - collected);
+    for (std::size_t i = 0; i < entries.size(); i += 2) {
+        EXPECT_EQ(ct.lookup(static_cast<fp>(2 * i + 1) / 256.), entries[i]);
+    }
+    // the limit has been raised after the complete sweep
+    EXPECT_FALSE(ct.possiblyNeedsCollection());
 }
 
 TEST(DDComplexTest, GarbageCollectSomeInBucket) {
@@ -153,22 +218,22 @@ TEST(DDComplexTest, GarbageCollectSomeInBucket) {
     const fp num = 0.25;
     cn.lookup(num, 0.0);
 
-    const fp num2 = num + 2. * ComplexTable<>::tolerance();
+    const fp num2 = num + 2 * ComplexTable<>::tolerance();
     ComplexNumbers::incRef(cn.lookup(num2, 0.0)); // num2 should be placed in same bucket as num
 
     auto key  = ComplexTable<>::hash(num);
     auto key2 = ComplexTable<>::hash(num2);
     ASSERT_EQ(key, key2);
 
-    auto* p = cn.complexTable.getTable()[key];
-    EXPECT_NEAR(p->value, num, ComplexTable<>::tolerance());
-
-    ASSERT_NE(p->next, nullptr);
-    EXPECT_NEAR((p->next)->value, num2, ComplexTable<>::tolerance());
+    const auto& bucket = cn.complexTable.getTable()[key];
+    ASSERT_EQ(bucket.size(), 2);
+    EXPECT_NEAR(bucket.entries[0]->value, num, ComplexTable<>::tolerance());
+    EXPECT_NEAR(bucket.entries[1]->value, num2, ComplexTable<>::tolerance());
 
     cn.garbageCollect(true); // num should be collected
-    EXPECT_NEAR(cn.complexTable.getTable()[key]->value, num2, ComplexTable<>::tolerance());
-    EXPECT_EQ(cn.complexTable.getTable()[key]->next, nullptr);
+    ASSERT_EQ(bucket.size(), 1);
+    EXPECT_NEAR(bucket.entries[0]->value, num2, ComplexTable<>::tolerance());
+    EXPECT_EQ(bucket.values[0], bucket.entries[0]->value);
 }
 
 TEST(DDComplexTest, LookupInNeighbouringBuckets) {
@@ -218,9 +283,35 @@ TEST(DDComplexTest, LookupInNeighbouringBuckets) {
     EXPECT_NEAR(d.r->value, num5, ComplexTable<>::tolerance());
 }
 
+TEST(DDComplexTest, BatchLookup) {
+    auto     batched    = ComplexNumbers();
+    auto     individual = ComplexNumbers();
+    const fp tol        = ComplexTable<>::tolerance();
+
+    // includes special values, duplicates, values within the tolerance of each other and (negative) zeros
+    const std::array<ComplexValue, 6> values{{{0.25, -0.25},
+                                              {-1e-14, 1.},
+                                              {dd::SQRT2_2, -dd::SQRT2_2},
+                                              {static_cast<fp>(0.25) + tol / 2, 0.3},
+                                              {-0.3, -0.},
+                                              {0.25, -0.25}}};
+    const auto                        results = batched.lookup(values);
+    for (std::size_t k = 0; k < values.size(); ++k) {
+        const auto expected = individual.lookup(values[k]);
+        EXPECT_EQ(CTEntry::val(results[k].r), CTEntry::val(expected.r));
+        EXPECT_EQ(CTEntry::val(results[k].i), CTEntry::val(expected.i));
+        // subsequent individual lookups in the same table yield the same entries
+        EXPECT_EQ(batched.lookup(values[k]), results[k]);
+    }
+    EXPECT_EQ(results[0], results[5]);
+    EXPECT_EQ(results[1].r, Complex::zero.r);
+    EXPECT_EQ(results[4].i, Complex::zero.i);
+    EXPECT_EQ(batched.complexTable.getCount(), individual.complexTable.getCount());
+}
+
 TEST(DDComplexTest, ComplexValueEquals) {
     ComplexValue a{1.0, 0.0};
-    ComplexValue a_tol{1.0 + ComplexTable<>::tolerance() / 10, 0.0};
+    ComplexValue a_tol{1 + ComplexTable<>::tolerance() / 10, 0.0};
     ComplexValue b{0.0, 1.0};
     EXPECT_TRUE(a.approximatelyEquals(a_tol));
     EXPECT_FALSE(a.approximatelyEquals(b));
@@ -8,11 +8,17 @@
 #include "dd/Package.hpp"
 
 #include "gtest/gtest.h"
+#include <filesystem>
+#include <map>
 #include <memory>
 #include <random>
+#include <thread>
 
 using namespace dd::literals;
 
+// accuracy of values resulting from several floating point operations (single precision only resolves about 7 digits)
+constexpr dd::fp ACCURACY = std::is_same_v<dd::fp, float> ? static_cast<dd::fp>(1e-5) : static_cast<dd::fp>(1e-10);
+
 TEST(DDPackageTest, RequestInvalidPackageSize) {
     EXPECT_THROW(auto dd = std::make_unique<dd::Package>(std::numeric_limits<dd::Qubit>::max() + 2), std::invalid_argument);
 }
@@ -86,7 +92,7 @@ TEST(DDPackageTest, BellState) {
     auto goal_state = dd::CVec{{dd::SQRT2_2, 0.}, {0., 0.}, {0., 0.}, {dd::SQRT2_2, 0.}};
     ASSERT_EQ(dd->getVector(bell_state), goal_state);
 
-    ASSERT_DOUBLE_EQ(dd->fidelity(zero_state, bell_state), 0.5);
+    ASSERT_NEAR(dd->fidelity(zero_state, bell_state), 0.5, 4 * std::numeric_limits<dd::fp>::epsilon());
 
     export2Dot(bell_state, "bell_state_colored_labels.dot", true, true, false, false, false);
     export2Dot(bell_state, "bell_state_colored_labels_classic.dot", true, true, true, false, false);
@@ -269,13 +275,13 @@ TEST(DDPackageTest, SerializationErrors) {
 
     // test wrong version number
     std::stringstream ss{};
-    ss << 2 << std::endl;
+    ss << dd::SERIALIZATION_VERSION + 1 << std::endl;
     EXPECT_THROW(dd->deserialize<dd::Package::vNode>(ss, false), std::runtime_error);
-    ss << 2 << std::endl;
+    ss << dd::SERIALIZATION_VERSION + 1 << std::endl;
     EXPECT_THROW(dd->deserialize<dd::Package::mNode>(ss, false), std::runtime_error);
 
     ss.str("");
-    std::remove_const_t<decltype(dd::SERIALIZATION_VERSION)> version = 2;
+    std::remove_const_t<decltype(dd::SERIALIZATION_VERSION)> version = dd::SERIALIZATION_VERSION + 1;
     ss.write(reinterpret_cast<const char*>(&version), sizeof(decltype(dd::SERIALIZATION_VERSION)));
     EXPECT_THROW(dd->deserialize<dd::Package::vNode>(ss, true), std::runtime_error);
     ss.write(reinterpret_cast<const char*>(&version), sizeof(decltype(dd::SERIALIZATION_VERSION)));
@@ -301,6 +307,126 @@ TEST(DDPackageTest, SerializationErrors) {
     EXPECT_THROW(dd->deserialize<dd::Package::mNode>(ss), std::runtime_error);
 }
 
+TEST(DDPackageTest, BinarySerializationV2) {
+    constexpr dd::QubitCount nqubits = 6;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    auto state = dd->makeZeroState(nqubits);
+    for (dd::Qubit q = 0; q < static_cast<dd::Qubit>(nqubits); ++q) {
+        state = dd->applyGate(state, dd::RYmat(0.3 * (q + 1)), {}, q);
+    }
+    state = dd->applyGate(state, dd::Xmat, {0_pc}, 5);
+    state = dd->applyGate(state, dd::Tmat, {}, 3);
+    dd->incRef(state);
+    const auto matrix = dd->makeGateDD(dd::Hmat, nqubits, {1_pc, 4_nc}, 2);
+
+    const auto stateFile  = (std::filesystem::temp_directory_path() / "dd_package_state_v2.dd").string();
+    const auto matrixFile = (std::filesystem::temp_directory_path() / "dd_package_matrix_v2.dd").string();
+    serialize(state, stateFile, true);
+    EXPECT_EQ(dd->deserialize<dd::Package::vNode>(stateFile, true), state);
+    serialize(matrix, matrixFile, true);
+    EXPECT_EQ(dd->deserialize<dd::Package::mNode>(matrixFile, true), matrix);
+    std::filesystem::remove(stateFile);
+    std::filesystem::remove(matrixFile);
+
+    // the stream reader understands the same format
+    std::stringstream ss{};
+    serialize(state, ss, true);
+    const auto data = ss.str();
+    EXPECT_EQ(dd->deserialize<dd::Package::vNode>(ss, true), state);
+    EXPECT_EQ(dd->deserializeFromMemory<dd::Package::vNode>(data.data(), data.size()), state);
+
+    // header, weight table and one record per node
+    dd::SerializationHeader header{};
+    std::memcpy(&header, data.data(), sizeof(header));
+    EXPECT_EQ(header.version, dd::SERIALIZATION_VERSION);
+    EXPECT_EQ(header.nodes, dd->size(state) - 1);
+    EXPECT_EQ(data.size(), sizeof(header) + header.weights * sizeof(dd::SerializedWeight) + header.nodes * sizeof(dd::SerializedNode<dd::RADIX>));
+
+    // truncated and corrupted data
+    EXPECT_THROW(dd->deserializeFromMemory<dd::Package::vNode>(data.data(), data.size() - 1), std::runtime_error);
+    EXPECT_THROW(dd->deserializeFromMemory<dd::Package::vNode>(data.data(), sizeof(header) - 1), std::runtime_error);
+    std::string corrupted = data;
+    header.rootWeight     = header.weights;
+    std::memcpy(corrupted.data(), &header, sizeof(header));
+    EXPECT_THROW(dd->deserializeFromMemory<dd::Package::vNode>(corrupted.data(), corrupted.size()), std::runtime_error);
+
+    // files written in version 1 can still be read
+    std::stringstream legacy{};
+    const std::remove_const_t<decltype(dd::SERIALIZATION_VERSION)> version = 1;
+    legacy.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    dd::ComplexValue{1., 0.}.writeBinary(legacy);
+    const std::int_least64_t index = 0;
+    const dd::Qubit          v     = 0;
+    legacy.write(reinterpret_cast<const char*>(&index), sizeof(index));
+    legacy.write(reinterpret_cast<const char*>(&v), sizeof(v));
+    for (const dd::fp value: {dd::SQRT2_2, -dd::SQRT2_2}) {
+        const std::int_least64_t terminal = -1;
+        legacy.write(reinterpret_cast<const char*>(&terminal), sizeof(terminal));
+        dd::ComplexValue{value, 0.}.writeBinary(legacy);
+    }
+    const auto minus = dd->deserialize<dd::Package::vNode>(legacy, true);
+    EXPECT_EQ(minus, dd->makeBasisState(1, {dd::BasisStates::minus}));
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, Checkpoint) {
+    constexpr dd::QubitCount nqubits = 5;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    auto state = dd->makeZeroState(nqubits);
+    for (dd::Qubit q = 0; q < static_cast<dd::Qubit>(nqubits); ++q) {
+        state = dd->applyGate(state, dd::RXmat(0.2 * (q + 1)), {}, q);
+    }
+    state = dd->applyGate(state, dd::Xmat, {1_pc}, 3);
+    dd->incRef(state);
+    auto other = dd->makeBasisState(nqubits, {dd::BasisStates::plus, dd::BasisStates::one, dd::BasisStates::right, dd::BasisStates::zero, dd::BasisStates::minus});
+    dd->incRef(other);
+    auto gate = dd->multiply(dd->makeGateDD(dd::Hmat, nqubits, 0_pc, 3), dd->makeGateDD(dd::Zmat, nqubits, 4));
+    dd->incRef(gate);
+    auto identity = dd->makeIdent(nqubits);
+    dd->incRef(identity);
+
+    std::stringstream ss{};
+    dd->checkpoint(ss, {{state, other, dd::Package::vEdge::one}, {gate, identity}});
+    const auto data = ss.str();
+
+    // restore into a new package
+    auto       restoredPackage = std::make_unique<dd::Package>(nqubits);
+    const auto restored        = restoredPackage->restoreFromMemory(data.data(), data.size());
+    ASSERT_EQ(restored.vectors.size(), 3);
+    ASSERT_EQ(restored.matrices.size(), 2);
+    EXPECT_EQ(restoredPackage->getVector(restored.vectors[0]), dd->getVector(state));
+    EXPECT_EQ(restoredPackage->getVector(restored.vectors[1]), dd->getVector(other));
+    EXPECT_EQ(restored.vectors[2], dd::Package::vEdge::one);
+    EXPECT_EQ(restoredPackage->getMatrix(restored.matrices[0]), dd->getMatrix(gate));
+    EXPECT_EQ(restoredPackage->size(restored.vectors[0]), dd->size(state));
+    EXPECT_EQ(restoredPackage->size(restored.matrices[0]), dd->size(gate));
+    // properties of matrix nodes are preserved, so that restored DDs coincide with newly built ones
+    EXPECT_TRUE(restored.matrices[1].p->ident);
+    EXPECT_EQ(restored.matrices[1], restoredPackage->makeIdent(nqubits));
+    EXPECT_EQ(restored.vectors[1], restoredPackage->makeBasisState(nqubits, {dd::BasisStates::plus, dd::BasisStates::one, dd::BasisStates::right, dd::BasisStates::zero, dd::BasisStates::minus}));
+    EXPECT_GT(restored.vectors[0].p->ref, 0);
+
+    // restoring into the original package yields the original DDs
+    const auto checkpointFile = (std::filesystem::temp_directory_path() / "dd_package.ckpt").string();
+    dd->checkpoint(checkpointFile, {{state}, {gate}});
+    const auto same = dd->restore(checkpointFile);
+    std::filesystem::remove(checkpointFile);
+    EXPECT_EQ(same.vectors.front(), state);
+    EXPECT_EQ(same.matrices.front(), gate);
+
+    // corrupted checkpoints
+    EXPECT_THROW(restoredPackage->restoreFromMemory(data.data(), data.size() - 1), std::runtime_error);
+    std::string corrupted      = data;
+    const auto  invalidVersion = dd::CHECKPOINT_VERSION + 1;
+    std::memcpy(corrupted.data(), &invalidVersion, sizeof(invalidVersion));
+    EXPECT_THROW(restoredPackage->restoreFromMemory(corrupted.data(), corrupted.size()), std::runtime_error);
+    EXPECT_THROW(restoredPackage->restore("./path/that/does/not/exist/package.ckpt"), std::invalid_argument);
+    auto small = std::make_unique<dd::Package>(2);
+    EXPECT_THROW(small->restoreFromMemory(data.data(), data.size()), std::runtime_error);
+}
+
 TEST(DDPackageTest, TestConsistency) {
     auto dd = std::make_unique<dd::Package>(2);
 
@@ -355,6 +481,187 @@ TEST(DDPackageTest, ToffoliTable) {
     EXPECT_EQ(toffoliTableEntry.p, nullptr);
 }
 
+TEST(DDPackageTest, GateTable) {
+    auto dd = std::make_unique<dd::Package>(4);
+
+    // gates are built once and looked up afterwards
+    const auto rz = dd->makeGateDD(dd::RZmat(0.3), 3, {0_nc}, 2);
+    EXPECT_EQ(dd->gateTable.getStatistics().at("hits"), 0);
+    EXPECT_EQ(dd->makeGateDD(dd::RZmat(0.3), 3, {0_nc}, 2), rz);
+    EXPECT_EQ(dd->gateTable.getStatistics().at("hits"), 1);
+
+    // different parameters, controls, targets or numbers of qubits are different gates
+    EXPECT_NE(dd->makeGateDD(dd::RZmat(0.4), 3, {0_nc}, 2), rz);
+    EXPECT_NE(dd->makeGateDD(dd::RZmat(0.3), 3, {0_pc}, 2), rz);
+    EXPECT_NE(dd->makeGateDD(dd::RZmat(0.3), 3, {0_nc}, 1), rz);
+    EXPECT_NE(dd->makeGateDD(dd::RZmat(0.3), 4, {0_nc}, 2), rz);
+    EXPECT_EQ(dd->gateTable.getStatistics().at("hits"), 1);
+
+    // two-qubit gates are cached as a whole and match their matrices
+    const std::vector<std::pair<dd::TwoQubitGateMatrix, dd::Package::mEdge>> gates{
+            {dd::SWAPmat, dd->makeSWAPDD(2, {}, 0, 1)},
+            {dd::iSWAPmat, dd->makeiSWAPDD(2, {}, 0, 1)},
+            {dd::iSWAPinvmat, dd->makeiSWAPinvDD(2, {}, 0, 1)},
+            {dd::Peresmat, dd->makePeresDD(2, {}, 0, 1)},
+            {dd::Peresdagmat, dd->makePeresdagDD(2, {}, 0, 1)},
+    };
+    for (const auto& [mat, e]: gates) {
+        const auto matrix = dd->getMatrix(e);
+        for (std::size_t row = 0; row < dd::NEDGE; ++row) {
+            for (std::size_t col = 0; col < dd::NEDGE; ++col) {
+                EXPECT_NEAR(matrix[row][col].real(), mat[row][col].r, dd::ComplexTable<>::tolerance());
+                EXPECT_NEAR(matrix[row][col].imag(), mat[row][col].i, dd::ComplexTable<>::tolerance());
+            }
+        }
+    }
+    const auto hits = dd->gateTable.getStatistics().at("hits");
+    EXPECT_EQ(dd->makeiSWAPDD(2, {}, 0, 1), gates[1].second);
+    EXPECT_EQ(dd->gateTable.getStatistics().at("hits"), hits + 1);
+    const auto count = dd->gateTable.getStatistics().at("count");
+    EXPECT_NE(dd->makeiSWAPDD(2, {}, 1, 0).p, nullptr);
+    EXPECT_GT(dd->gateTable.getStatistics().at("count"), count);
+
+    // collecting matrix nodes invalidates the table
+    dd->garbageCollect(true);
+    EXPECT_EQ(dd->gateTable.getStatistics().at("count"), 0);
+    EXPECT_EQ(dd->gateTable.lookup(dd::GateTable<dd::Package::mEdge>::Matrix{}, 2, 0, {}, 0, 1).p, nullptr);
+    EXPECT_EQ(dd->getStatistics().tables.count("gateTable"), 1);
+
+    // the node of a cached gate may survive a collection with a different weight, while the cached one is collected
+    auto       single   = std::make_unique<dd::Package>(1);
+    const auto gate     = single->makeGateDD(dd::RZmat(0.3), 1, 0);
+    const auto expected = single->getValueByPath(gate, 0, 0);
+    const auto other    = dd::Package::mEdge{gate.p, single->cn.lookup(0.5, 0.25)};
+    single->incRef(other);
+    EXPECT_EQ(single->mUniqueTable.getActiveNodeCount(), single->mUniqueTable.getNodeCount());
+    EXPECT_TRUE(single->garbageCollect(true));
+    for (std::size_t i = 0; i < 1000; ++i) {
+        single->cn.lookup(-0.7, static_cast<dd::fp>(i) / 1000.);
+    }
+    const auto value = single->getValueByPath(single->makeGateDD(dd::RZmat(0.3), 1, 0), 0, 0);
+    EXPECT_NEAR(value.r, expected.r, dd::ComplexTable<>::tolerance());
+    EXPECT_NEAR(value.i, expected.i, dd::ComplexTable<>::tolerance());
+}
+
+TEST(DDPackageTest, TwoQubitGateDD) {
+    constexpr dd::QubitCount nqubits = 5;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    // an arbitrary matrix, so that the roles of the rows, columns and targets are distinguished
+    dd::TwoQubitGateMatrix mat{};
+    for (std::size_t row = 0; row < dd::NEDGE; ++row) {
+        for (std::size_t col = 0; col < dd::NEDGE; ++col) {
+            mat[row][col] = {static_cast<dd::fp>(row + 1) / 10, static_cast<dd::fp>(col + 1) / 100};
+        }
+    }
+
+    const dd::Controls controls{0_pc, 2_nc};
+    for (const auto& [target0, target1]: std::vector<std::pair<dd::Qubit, dd::Qubit>>{{1, 3}, {3, 1}, {3, 4}, {4, 1}}) {
+        const auto e      = dd->makeTwoQubitGateDD(mat, nqubits, controls, target0, target1);
+        const auto matrix = dd->getMatrix(e);
+        const auto bit    = [](std::size_t i, dd::Qubit q) { return (i >> static_cast<std::size_t>(q)) & 1U; };
+        for (std::size_t i = 0; i < matrix.size(); ++i) {
+            for (std::size_t j = 0; j < matrix.size(); ++j) {
+                const auto others = ~((1U << static_cast<std::size_t>(target0)) | (1U << static_cast<std::size_t>(target1)));
+                std::complex<dd::fp> expected{};
+                if ((i & others) == (j & others)) {
+                    if (bit(j, 0) == 1 && bit(j, 2) == 0) {
+                        const auto& value = mat[2 * bit(i, target1) + bit(i, target0)][2 * bit(j, target1) + bit(j, target0)];
+                        expected          = {value.r, value.i};
+                    } else if (i == j) {
+                        expected = 1.;
+                    }
+                }
+                EXPECT_NEAR(matrix[i][j].real(), expected.real(), ACCURACY);
+                EXPECT_NEAR(matrix[i][j].imag(), expected.imag(), ACCURACY);
+            }
+        }
+    }
+    EXPECT_THROW(dd->makeTwoQubitGateDD(mat, nqubits, controls, 1, 1), std::invalid_argument);
+    EXPECT_THROW(dd->makeTwoQubitGateDD(mat, nqubits, controls, 0, 1), std::invalid_argument);
+
+    // the native construction matches the composition of the individual gates
+    auto swap = dd->makeGateDD(dd::Xmat, nqubits, {0_pc, 4_pc}, 2);
+    swap      = dd->multiply(swap, dd->multiply(dd->makeGateDD(dd::Xmat, nqubits, {0_pc, 2_pc}, 4), swap));
+    EXPECT_EQ(dd->makeSWAPDD(nqubits, {0_pc}, 4, 2), swap);
+    auto zz = dd->makeGateDD(dd::Xmat, nqubits, 1_pc, 3);
+    zz      = dd->multiply(zz, dd->multiply(dd->makeGateDD(dd::RZmat(0.7), nqubits, 3), zz));
+    EXPECT_NEAR(dd->fidelity(dd->multiply(dd->makeTwoQubitGateDD(dd::RZZmat(0.7), nqubits, 1, 3), dd->makeZeroState(nqubits)), dd->multiply(zz, dd->makeZeroState(nqubits))), 1., ACCURACY);
+    const auto xx = dd->makeTwoQubitGateDD(dd::RXXmat(dd::PI), nqubits, 1, 3);
+    const auto value = dd->getValueByPath(xx, 0b01010, 0);
+    EXPECT_NEAR(value.r, 0., ACCURACY);
+    EXPECT_NEAR(value.i, -1., ACCURACY);
+}
+
+TEST(DDPackageTest, NoiseChannels) {
+    constexpr dd::QubitCount nqubits = 3;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    // rho = U |000><000| U^dagger for an entangling circuit U
+    auto projector = dd->makeIdent(nqubits);
+    for (dd::Qubit q = 0; q < nqubits; ++q) {
+        projector = dd->multiply(dd->makeGateDD({dd::complex_one, dd::complex_zero, dd::complex_zero, dd::complex_zero}, nqubits, q), projector);
+    }
+    auto u = dd->makeGateDD(dd::Hmat, nqubits, 2);
+    u      = dd->multiply(dd->makeGateDD(dd::RYmat(0.8), nqubits, 0), u);
+    u      = dd->multiply(dd->makeGateDD(dd::Xmat, nqubits, 2_pc, 1), u);
+    u      = dd->multiply(dd->makeGateDD(dd::Tmat, nqubits, 1), u);
+    u      = dd->multiply(dd->makeGateDD(dd::Xmat, nqubits, 0_pc, 1), u);
+    auto rho = dd->multiply(dd->multiply(u, projector), dd->conjugateTranspose(u));
+    dd->incRef(rho);
+
+    // reference: sum of K rho K^dagger over the Kraus operators K
+    const auto kraus = [&](const std::vector<dd::GateMatrix>& operators, dd::Qubit target) {
+        auto result = dd::Package::mEdge::zero;
+        for (const auto& op: operators) {
+            const auto k = dd->makeGateDD(op, nqubits, target);
+            result       = dd->add(result, dd->multiply(dd->multiply(k, rho), dd->conjugateTranspose(k)));
+        }
+        return result;
+    };
+    const auto scaled = [](const dd::GateMatrix& mat, dd::fp factor) {
+        dd::GateMatrix result{};
+        for (std::size_t i = 0; i < dd::NEDGE; ++i) {
+            result[i] = {mat[i].r * factor, mat[i].i * factor};
+        }
+        return result;
+    };
+    const auto compare = [&](const dd::Package::mEdge& actual, const dd::Package::mEdge& expected) {
+        const auto a = dd->getMatrix(actual);
+        const auto b = dd->getMatrix(expected);
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            for (std::size_t j = 0; j < a.size(); ++j) {
+                EXPECT_NEAR(a[i][j].real(), b[i][j].real(), ACCURACY);
+                EXPECT_NEAR(a[i][j].imag(), b[i][j].imag(), ACCURACY);
+            }
+        }
+    };
+
+    constexpr dd::fp p = 0.3;
+    for (dd::Qubit target = 0; target < nqubits; ++target) {
+        const auto depolarized = dd->applyNoiseChannel(rho, dd::NoiseChannel::depolarization, target, p);
+        compare(depolarized, kraus({scaled(dd::Imat, std::sqrt(1. - 3. * p / 4.)), scaled(dd::Xmat, std::sqrt(p / 4.)), scaled(dd::Ymat, std::sqrt(p / 4.)), scaled(dd::Zmat, std::sqrt(p / 4.))}, target));
+
+        const auto damped = dd->applyNoiseChannel(rho, dd::NoiseChannel::amplitudeDamping, target, p);
+        compare(damped, kraus({{dd::complex_one, dd::complex_zero, dd::complex_zero, {std::sqrt(1. - p), 0.}}, {dd::complex_zero, {std::sqrt(p), 0.}, dd::complex_zero, dd::complex_zero}}, target));
+
+        const auto flipped = dd->applyNoiseChannel(rho, dd::NoiseChannel::phaseFlip, target, p);
+        compare(flipped, kraus({scaled(dd::Imat, std::sqrt(1. - p)), scaled(dd::Zmat, std::sqrt(p))}, target));
+    }
+
+    // repeated applications are served from the compute table
+    const auto hits = dd->noiseChannels.getHits();
+    dd->applyNoiseChannel(rho, dd::NoiseChannel::depolarization, 1, p);
+    EXPECT_EQ(dd->noiseChannels.getHits(), hits + 1);
+
+    // a fully depolarized qubit is maximally mixed and the trace is preserved
+    const auto mixed = dd->applyNoiseChannel(rho, dd::NoiseChannel::depolarization, 0, 1.);
+    EXPECT_NEAR(dd->trace(mixed).r, 1., ACCURACY);
+    EXPECT_THROW(dd->applyNoiseChannel(rho, dd::NoiseChannel::phaseFlip, 0, 1.5), std::invalid_argument);
+    EXPECT_THROW(dd->applyNoiseChannel(rho, dd::NoiseChannel::phaseFlip, nqubits, p), std::invalid_argument);
+    dd->decRef(rho);
+}
+
 TEST(DDPackageTest, Extend) {
     auto dd = std::make_unique<dd::Package>(4);
 
@@ -544,19 +851,67 @@ TEST(DDPackageTest, PackageReset) {
     const auto& unique = dd->mUniqueTable.getTables();
     const auto& table  = unique[0];
     auto        ihash  = dd->mUniqueTable.hash(i_gate.p);
-    const auto* node   = table[ihash];
-    std::cout << ihash << ": " << reinterpret_cast<uintptr_t>(i_gate.p) << std::endl;
+    const auto* node   = table[ihash].load();
+    std::cout << ihash << ": " << reinterpret_cast<uintptr_t>(dd::toPointer(i_gate.p)) << std::endl;
     // node should be the first in this unique table bucket
     EXPECT_EQ(node, i_gate.p);
     dd->reset();
     // after clearing the tables, they should be empty
-    EXPECT_EQ(table[ihash], nullptr);
+    EXPECT_EQ(table[ihash].load(), nullptr);
     i_gate            = dd->makeIdent(1);
-    const auto* node2 = table[ihash];
+    const auto* node2 = table[ihash].load();
     // after recreating the DD, it should receive the same node
     EXPECT_EQ(node2, node);
 }
 
+TEST(DDPackageTest, NodeSize) {
+#ifdef DD_PACKAGE_COMPACT_NODES
+    // nodes and complex table entries are referred to by 32bit slots
+    EXPECT_EQ(sizeof(dd::Package::vEdge), 12U);
+    EXPECT_LE(sizeof(dd::Package::vNode), 36U);
+    EXPECT_LE(sizeof(dd::Package::mNode), 60U);
+#else
+    if constexpr (sizeof(void*) == 8) {
+        // edges, next pointer, reference count and variable of a vector node fit into a single cache line
+        EXPECT_LE(sizeof(dd::Package::vNode), 64U);
+        EXPECT_LE(sizeof(dd::Package::mNode), 112U);
+    }
+#endif
+    dd::Package::printInformation();
+}
+
+TEST(DDPackageTest, SwapRoots) {
+    auto dd = std::make_unique<dd::Package>(3);
+
+    auto state = dd->makeZeroState(3);
+    dd->incRef(state);
+    EXPECT_EQ(dd->vUniqueTable.getActiveNodeCount(), 3);
+
+    // flipping the most significant qubit keeps the remaining nodes
+    const auto x      = dd->makeGateDD(dd::Xmat, 3, 2);
+    const auto next   = dd->multiply(x, state);
+    auto*      shared = dd::toPointer(state.p->e[0].p);
+    ASSERT_EQ(next.p->e[1].p, shared);
+    EXPECT_EQ(shared->ref, 1);
+
+    dd->swapRoots(state, next);
+    EXPECT_EQ(state.p->ref, 0);
+    EXPECT_EQ(next.p->ref, 1);
+    // the shared part never lost its reference
+    EXPECT_EQ(shared->ref, 1);
+    EXPECT_EQ(dd->vUniqueTable.getActiveNodeCount(), 3);
+    EXPECT_EQ(dd->vUniqueTable.getActiveNodeCount(2), 1);
+
+    // reference counts of deep DDs are updated without recursion
+    auto other = std::make_unique<dd::Package>(127);
+    auto deep  = other->makeBasisState(127, std::vector<bool>(127, true));
+    other->incRef(deep);
+    EXPECT_EQ(other->vUniqueTable.getActiveNodeCount(), 127);
+    other->decRef(deep);
+    EXPECT_EQ(other->vUniqueTable.getActiveNodeCount(), 0);
+    EXPECT_THROW(other->decRef(deep), std::runtime_error);
+}
+
 TEST(DDPackageTest, MaxRefCount) {
     auto dd = std::make_unique<dd::Package>(1);
     auto e  = dd->makeIdent(1);
@@ -604,6 +959,1137 @@ TEST(DDPackageTest, UniqueTableAllocation) {
     EXPECT_EQ(dd->vUniqueTable.getAllocations(), allocs);
 }
 
+TEST(DDPackageTest, ConcurrentUniqueTable) {
+    auto  dd     = std::make_unique<dd::Package>(1);
+    auto& unique = dd->vUniqueTable;
+
+    // build a set of distinct weights from the static entries of the complex table
+    std::vector<dd::CTEntry*> parts{&dd::ComplexTable<>::zero, &dd::ComplexTable<>::one, &dd::ComplexTable<>::sqrt2_2,
+                                    dd::CTEntry::getNegativePointer(&dd::ComplexTable<>::one),
+                                    dd::CTEntry::getNegativePointer(&dd::ComplexTable<>::sqrt2_2)};
+    std::vector<dd::Complex>  weights{};
+    for (auto* r: parts) {
+        for (auto* i: parts) {
+            weights.push_back({r, i});
+        }
+    }
+    const auto nweights = weights.size();
+
+    constexpr std::size_t                         nthreads = 4;
+    std::vector<std::vector<dd::Package::vNode*>> results(nthreads, std::vector<dd::Package::vNode*>(nweights * nweights));
+    std::vector<std::thread>                      threads{};
+    unique.enableConcurrency(nthreads);
+    for (std::size_t t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&, t]() {
+            dd::workerIndex = t;
+            // every thread creates the same nodes, but in a different order
+            for (std::size_t k = 0; k < nweights * nweights; ++k) {
+                const auto         idx = (k * (t + 1)) % (nweights * nweights);
+                dd::Package::vEdge e{unique.getNode(), dd::Complex::one};
+                e.p->v         = 0;
+                e.p->e         = {dd::Package::vEdge::terminal(weights[idx / nweights]), dd::Package::vEdge::terminal(weights[idx % nweights])};
+                results[t][idx] = unique.lookup(e).p;
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    unique.disableConcurrency();
+
+    // all threads have to agree on the nodes
+    for (std::size_t t = 1; t < nthreads; ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    EXPECT_EQ(unique.getNodeCount(), nweights * nweights);
+
+    // sequential lookups find the nodes created concurrently
+    dd::Package::vEdge e{unique.getNode(), dd::Complex::one};
+    e.p->v = 0;
+    e.p->e = {dd::Package::vEdge::terminal(weights[3]), dd::Package::vEdge::terminal(weights[7])};
+    EXPECT_EQ(unique.lookup(e).p, results[0][3 * nweights + 7]);
+    EXPECT_EQ(unique.getNodeCount(), nweights * nweights);
+}
+
+TEST(DDPackageTest, OpenAddressingUniqueTable) {
+    auto dd = std::make_unique<dd::Package>(1);
+    // start with few buckets, so that they have to grow
+    auto unique = std::make_unique<dd::UniqueTable<dd::Package::vNode, 4, 2048, 2, 131072, dd::UniqueTableLayout::OpenAddressing>>(1);
+    EXPECT_EQ(unique->getBuckets(0), 4);
+
+    std::vector<dd::Complex> weights{};
+    for (std::size_t i = 0; i < 64; ++i) {
+        weights.push_back(dd->cn.lookup(static_cast<dd::fp>(i) / 64., 0.));
+    }
+    const auto make = [&](std::size_t i) {
+        dd::Package::vEdge e{unique->getNode(), dd::Complex::one};
+        e.p->v = 0;
+        e.p->e = {dd::Package::vEdge::terminal(weights[i]), dd::Package::vEdge::terminal(dd::Complex::one)};
+        return unique->lookup(e);
+    };
+
+    std::vector<dd::Package::vNode*> nodes{};
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        nodes.push_back(make(i).p);
+    }
+    EXPECT_EQ(unique->getNodeCount(), weights.size());
+    EXPECT_GE(unique->getBuckets(0), 2 * weights.size());
+
+    // nodes are found again
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_EQ(make(i).p, nodes[i]);
+    }
+    EXPECT_EQ(unique->getNodeCount(), weights.size());
+    unique->printStatistics();
+
+    // only unreferenced nodes are collected and the remaining ones are still found afterwards
+    for (std::size_t i = 0; i < weights.size(); i += 2) {
+        unique->incRef({nodes[i], dd::Complex::one});
+    }
+    EXPECT_EQ(unique->garbageCollect(true), weights.size() / 2);
+    EXPECT_EQ(unique->getNodeCount(), weights.size() / 2);
+    for (std::size_t i = 0; i < weights.size(); i += 2) {
+        EXPECT_EQ(make(i).p, nodes[i]);
+    }
+
+    // nodes created concurrently are unique
+    constexpr std::size_t                         nthreads = 4;
+    std::vector<std::vector<dd::Package::vNode*>> results(nthreads, std::vector<dd::Package::vNode*>(weights.size()));
+    std::vector<std::thread>                      threads{};
+    unique->enableConcurrency(nthreads);
+    for (std::size_t t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&, t]() {
+            dd::workerIndex = t;
+            for (std::size_t k = 0; k < weights.size(); ++k) {
+                const auto idx  = (k * (2 * t + 1)) % weights.size();
+                results[t][idx] = make(idx).p;
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    unique->disableConcurrency();
+    for (std::size_t t = 1; t < nthreads; ++t) {
+        EXPECT_EQ(results[t], results[0]);
+    }
+    for (std::size_t i = 0; i < weights.size(); i += 2) {
+        EXPECT_EQ(results[0][i], nodes[i]);
+    }
+    EXPECT_EQ(unique->getNodeCount(), weights.size());
+}
+
+template<dd::UniqueTableLayout LAYOUT>
+void checkIncrementalCollection() {
+    auto dd = std::make_unique<dd::Package>(1);
+    // a low collection limit, so that collection starts right away
+    auto unique = std::make_unique<dd::UniqueTable<dd::Package::vNode, 4, 2048, 2, 16, LAYOUT>>(1);
+    unique->setIncrementalCollection(true);
+
+    std::vector<dd::Complex> weights{};
+    for (std::size_t i = 0; i < 64; ++i) {
+        weights.push_back(dd->cn.lookup(static_cast<dd::fp>(i) / 64., 0.));
+    }
+    const auto make = [&](std::size_t i) {
+        dd::Package::vEdge e{unique->getNode(), dd::Complex::one};
+        e.p->v = 0;
+        e.p->e = {dd::Package::vEdge::terminal(weights[i]), dd::Package::vEdge::terminal(dd::Complex::one)};
+        return unique->lookup(e);
+    };
+
+    std::vector<dd::Package::vNode*> nodes{};
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        nodes.push_back(make(i).p);
+    }
+    for (std::size_t i = 0; i < weights.size(); i += 2) {
+        unique->incRef({nodes[i], dd::Complex::one});
+    }
+    EXPECT_EQ(unique->getCandidateCount(), weights.size());
+
+    // every call only visits a bounded number of candidates
+    std::size_t collected = 0;
+    while (unique->getCandidateCount() > 0) {
+        const auto before = unique->getNodeCount();
+        const auto step   = unique->collectCandidates(10);
+        EXPECT_LE(step, 5);
+        EXPECT_EQ(unique->getNodeCount(), before - step);
+        collected += step;
+    }
+    EXPECT_EQ(collected, weights.size() / 2);
+    EXPECT_EQ(unique->getNodeCount(), weights.size() / 2);
+    for (std::size_t i = 0; i < weights.size(); i += 2) {
+        EXPECT_EQ(make(i).p, nodes[i]);
+    }
+
+    // mostly active nodes remain, so the limit has been raised
+    EXPECT_FALSE(unique->possiblyNeedsCollection());
+
+    // nodes losing their last reference become candidates
+    unique->decRef({nodes[0], dd::Complex::one});
+    EXPECT_EQ(unique->getCandidateCount(), 1);
+    for (std::size_t i = 1; i < weights.size(); i += 2) {
+        make(i);
+    }
+    ASSERT_TRUE(unique->possiblyNeedsCollection());
+    EXPECT_EQ(unique->collectCandidates(weights.size()), weights.size() / 2 + 1);
+    EXPECT_EQ(unique->getNodeCount(), weights.size() / 2 - 1);
+    for (std::size_t i = 2; i < weights.size(); i += 2) {
+        EXPECT_EQ(make(i).p, nodes[i]);
+    }
+    EXPECT_EQ(unique->getNodeCount(), weights.size() / 2 - 1);
+
+    // a full collection discards the candidates
+    make(0);
+    EXPECT_EQ(unique->garbageCollect(true), 1);
+    EXPECT_EQ(unique->getCandidateCount(), 0);
+}
+
+TEST(DDPackageTest, IncrementalGarbageCollection) {
+    checkIncrementalCollection<dd::UniqueTableLayout::Chaining>();
+    checkIncrementalCollection<dd::UniqueTableLayout::OpenAddressing>();
+
+    dd::PackageConfig config{};
+    config.incrementalGarbageCollection = true;
+    auto dd                             = std::make_unique<dd::Package>(2, config);
+    EXPECT_TRUE(dd->vUniqueTable.isIncrementalCollection());
+    EXPECT_TRUE(dd->mUniqueTable.isIncrementalCollection());
+    auto bell = dd->makeBasisState(2, {false, false});
+    bell      = dd->multiply(dd->makeGateDD(dd::Hmat, 2, 1), bell);
+    dd->incRef(bell);
+    EXPECT_FALSE(dd->garbageCollect());
+    EXPECT_TRUE(dd->garbageCollect(true));
+    EXPECT_EQ(dd->vUniqueTable.getCandidateCount(), 0);
+    EXPECT_EQ(dd->getValueByPath(bell, "00").r, dd::SQRT2_2);
+}
+
+TEST(DDPackageTest, IncrementalGarbageCollectionCaches) {
+    dd::PackageConfig config{};
+    config.incrementalGarbageCollection = true;
+    config.garbageCollectionBudget      = dd::ComplexTable<>::MASK + 1;
+    auto dd                             = std::make_unique<dd::Package>(1, config);
+
+    const auto expected = dd->getValueByPath(dd->makeGateDD(dd::RZmat(0.3), 1, 0), 0, 0);
+
+    // fill the complex table with unreferenced numbers, such that the weights of the cached gate are collected and
+    // their entries are recycled by subsequent lookups
+    for (std::size_t i = 0; i < 70000; ++i) {
+        dd->cn.lookup(static_cast<dd::fp>(i) / 70000., 0.5);
+    }
+    EXPECT_TRUE(dd->garbageCollect());
+    for (std::size_t i = 0; i < 1000; ++i) {
+        dd->cn.lookup(-0.7, static_cast<dd::fp>(i) / 1000.);
+    }
+
+    const auto value = dd->getValueByPath(dd->makeGateDD(dd::RZmat(0.3), 1, 0), 0, 0);
+    EXPECT_NEAR(value.r, expected.r, dd::ComplexTable<>::tolerance());
+    EXPECT_NEAR(value.i, expected.i, dd::ComplexTable<>::tolerance());
+}
+
+TEST(DDPackageTest, PackageStatistics) {
+    auto dd = std::make_unique<dd::Package>(2);
+
+    std::vector<dd::GarbageCollectionRun> runs{};
+    dd->setGarbageCollectionCallback([&runs](const dd::GarbageCollectionRun& run) { runs.push_back(run); });
+
+    auto bell = dd->multiply(dd->makeGateDD(dd::Xmat, 2, 1_pc, 0), dd->multiply(dd->makeGateDD(dd::Hmat, 2, 1), dd->makeZeroState(2)));
+    dd->incRef(bell);
+    EXPECT_GT(dd->getStatistics().tables.at("matrixVectorMultiplication").at("lookups"), 0);
+
+    // calls without any table reaching its limit do not run the collection
+    EXPECT_FALSE(dd->garbageCollect());
+    EXPECT_TRUE(runs.empty());
+    EXPECT_TRUE(dd->garbageCollect(true));
+    ASSERT_EQ(runs.size(), 1);
+    EXPECT_TRUE(runs[0].forced);
+    EXPECT_GT(runs[0].collectedMatrixNodes, 0);
+
+    const auto stats = dd->getStatistics();
+    EXPECT_EQ(stats.garbageCollection.calls, 2);
+    EXPECT_EQ(stats.garbageCollection.runs, 1);
+    EXPECT_EQ(stats.garbageCollection.collectedMatrixNodes, runs[0].collectedMatrixNodes);
+    EXPECT_EQ(stats.garbageCollection.time, runs[0].duration);
+    EXPECT_EQ(stats.activeVectorNodes, (std::vector<std::size_t>{2, 1}));
+    EXPECT_EQ(stats.activeMatrixNodes, (std::vector<std::size_t>{0, 0}));
+    EXPECT_EQ(stats.tables.at("vUniqueTable").at("activeNodeCount"), 3);
+    EXPECT_GT(stats.tables.at("complexTable").at("count"), 0);
+
+    const auto json = stats.toJSON();
+    EXPECT_EQ(json.front(), '{');
+    EXPECT_EQ(json.back(), '}');
+    EXPECT_NE(json.find("\"activeVectorNodes\": [2, 1]"), std::string::npos);
+    EXPECT_NE(json.find("\"garbageCollection\": {\"calls\": 2, \"runs\": 1"), std::string::npos);
+
+    // removing the callback
+    dd->setGarbageCollectionCallback({});
+    dd->garbageCollect(true);
+    EXPECT_EQ(runs.size(), 1);
+}
+
+TEST(DDPackageTest, ApplyGates) {
+    constexpr dd::QubitCount nqubits = 4;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    // layers of disjoint gates, repeated gates on the same target and overlapping controlled gates
+    const std::vector<dd::GateOperation> gates{
+            {dd::Hmat, {}, 0},
+            {dd::Hmat, {}, 1},
+            {dd::Tmat, {}, 0},
+            {dd::Xmat, {2_pc}, 3},
+            {dd::Smat, {}, 0},
+            {dd::Xmat, {0_pc}, 1},
+            {dd::Ymat, {}, 2},
+            {dd::Zmat, {1_nc}, 3},
+            {dd::Zmat, {1_nc}, 3},
+            {dd::Hmat, {}, 3},
+            {dd::Xmat, {1_pc, 3_pc}, 0},
+            {dd::Sdagmat, {}, 2},
+    };
+
+    auto expected = dd->makeZeroState(nqubits);
+    for (const auto& gate: gates) {
+        expected = dd->multiply(dd->makeGateDD(gate.matrix, nqubits, gate.controls, gate.target), expected);
+    }
+    const auto batched = dd->applyGates(dd->makeZeroState(nqubits), gates, nqubits);
+    EXPECT_NEAR(dd->fidelity(expected, batched), 1., dd::ComplexTable<>::tolerance());
+
+    const auto expectedVector = dd->getVector(expected);
+    const auto batchedVector  = dd->getVector(batched);
+    for (std::size_t i = 0; i < expectedVector.size(); ++i) {
+        EXPECT_NEAR(expectedVector[i].real(), batchedVector[i].real(), ACCURACY);
+        EXPECT_NEAR(expectedVector[i].imag(), batchedVector[i].imag(), ACCURACY);
+    }
+
+    EXPECT_EQ(dd->applyGates(expected, {}, nqubits), expected);
+    EXPECT_THROW(dd->applyGates(expected, {{dd::Xmat, {}, nqubits}}, nqubits), std::invalid_argument);
+    EXPECT_THROW(dd->applyGates(expected, {{dd::Xmat, {dd::Control{nqubits}}, 0}}, nqubits), std::invalid_argument);
+    EXPECT_THROW(dd->applyGates(expected, {{dd::Xmat, {dd::Control{-1}}, 0}}, nqubits), std::invalid_argument);
+    EXPECT_THROW(dd->applyGates(expected, {{dd::Xmat, {0_pc}, 0}}, nqubits), std::invalid_argument);
+}
+
+TEST(DDPackageTest, ApplyGateKernel) {
+    constexpr dd::QubitCount nqubits = 4;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    // an entangled state with non-trivial amplitudes
+    auto state = dd->makeZeroState(nqubits);
+    for (dd::Qubit q = 0; q < static_cast<dd::Qubit>(nqubits); ++q) {
+        state = dd->multiply(dd->makeGateDD(dd::Hmat, nqubits, q), state);
+        state = dd->multiply(dd->makeGateDD(dd::Tmat, nqubits, q), state);
+    }
+    state = dd->multiply(dd->makeGateDD(dd::Xmat, nqubits, 0_pc, 2), state);
+    state = dd->multiply(dd->makeGateDD(dd::RYmat(0.3), nqubits, 3_nc, 1), state);
+    dd->incRef(state);
+
+    const std::vector<std::pair<dd::Controls, dd::Qubit>> cases{
+            {{}, 0},
+            {{}, 3},
+            {{3_pc}, 0},
+            {{0_pc}, 3},
+            {{0_nc, 3_pc}, 2},
+            {{0_pc, 1_nc}, 2},
+            {{1_pc, 2_pc, 3_nc}, 0},
+    };
+    for (const auto& matrix: {dd::Hmat, dd::Xmat, dd::Ymat, dd::Tmat, dd::RXmat(0.7)}) {
+        for (const auto& [controls, target]: cases) {
+            const auto expected = dd->multiply(dd->makeGateDD(matrix, nqubits, controls, target), state);
+            const auto result   = dd->applyGate(state, matrix, controls, target);
+            // canonical DDs of equal states coincide
+            EXPECT_EQ(result.p, expected.p);
+            EXPECT_TRUE(result.w.approximatelyEquals(expected.w));
+        }
+    }
+
+    EXPECT_THROW(dd->applyGate(state, dd::Xmat, {}, 4), std::invalid_argument);
+    EXPECT_THROW(dd->applyGate(state, dd::Xmat, {1_pc}, 1), std::invalid_argument);
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, Sample) {
+    constexpr dd::QubitCount nqubits = 3;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    auto state = dd->makeZeroState(nqubits);
+    state      = dd->applyGate(state, dd::RYmat(1.1), {}, 0);
+    state      = dd->applyGate(state, dd::Hmat, {}, 1);
+    state      = dd->applyGate(state, dd::Xmat, {1_pc}, 2);
+    dd->incRef(state);
+
+    constexpr std::size_t shots = 100000;
+    std::mt19937_64       mt{42};
+    const auto            histogram = dd->sample(state, shots, mt);
+
+    const auto  amplitudes = dd->getVector(state);
+    std::size_t total      = 0;
+    for (const auto& [bitstring, count]: histogram) {
+        ASSERT_EQ(bitstring.size(), nqubits);
+        const auto probability = std::norm(amplitudes[std::stoul(bitstring, nullptr, 2)]);
+        EXPECT_GT(probability, 0.);
+        EXPECT_NEAR(static_cast<double>(count) / shots, probability, 0.01);
+        total += count;
+    }
+    EXPECT_EQ(histogram.size(), 4);
+    EXPECT_EQ(total, shots);
+
+    // the histogram only depends on the state of the generator, not on the number of threads
+    std::mt19937_64 sequential{7};
+    std::mt19937_64 parallel{7};
+    const auto      expected = dd->sample(state, 1001, sequential);
+    dd->setParallelism(2);
+    EXPECT_EQ(dd->sample(state, 1001, parallel), expected);
+    EXPECT_EQ(sequential(), parallel());
+    dd->setParallelism(1);
+
+    EXPECT_EQ(dd->sample(dd::Package::vEdge::one, 5, mt), (std::map<std::string, std::size_t>{{"", 5}}));
+    EXPECT_THROW(dd->sample(dd::Package::vEdge::zero, 5, mt), std::runtime_error);
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, VisitedNodes) {
+    auto dd = std::make_unique<dd::Package>(3);
+
+    auto state = dd->makeZeroState(3);
+    state      = dd->applyGate(state, dd::Hmat, {}, 2);
+    state      = dd->applyGate(state, dd::Xmat, {2_pc}, 0);
+    dd->incRef(state);
+
+    {
+        dd::VisitedNodes<dd::Package::vNode> visited{};
+        EXPECT_TRUE(visited.insert(state.p));
+        EXPECT_FALSE(visited.insert(state.p));
+        EXPECT_TRUE(visited.contains(state.p));
+        EXPECT_FALSE(visited.contains(state.p->e[0].p));
+        EXPECT_TRUE(visited.insert(dd::Package::vNode::terminal));
+        EXPECT_FALSE(visited.insert(dd::Package::vNode::terminal));
+        EXPECT_EQ(visited.size(), 2);
+        // the terminal node is shared by all packages and is never marked itself
+        EXPECT_FALSE(dd::Package::vNode::terminal->visited);
+    }
+    // marks are released together with the set
+    EXPECT_FALSE(state.p->visited);
+
+    // repeated traversals are not affected by earlier ones
+    EXPECT_EQ(dd->size(state), 6);
+    EXPECT_EQ(dd->size(state), 6);
+    std::ostringstream oss{};
+    dd::toDot(state, oss);
+    EXPECT_FALSE(state.p->visited);
+    EXPECT_FALSE(state.p->e[0].p->visited);
+
+    const auto matrix = dd->makeGateDD(dd::Xmat, 3, 0_pc, 2);
+    EXPECT_EQ(dd->size(matrix), 6);
+    EXPECT_FALSE(matrix.p->visited);
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, NodeMap) {
+    auto dd = std::make_unique<dd::Package>(3);
+
+    auto state = dd->makeZeroState(3);
+    state      = dd->applyGate(state, dd::Hmat, {}, 2);
+    state      = dd->applyGate(state, dd::Xmat, {2_pc}, 0);
+    dd->incRef(state);
+
+    dd::NodeMap<const dd::Package::vNode*, int> nodes{};
+    EXPECT_TRUE(nodes.empty());
+    EXPECT_EQ(nodes.find(state.p), nullptr);
+    EXPECT_EQ(nodes.position(state.p), decltype(nodes)::npos);
+    EXPECT_EQ(nodes.try_emplace(state.p, 1), std::make_pair(std::size_t{0}, true));
+    EXPECT_EQ(nodes.try_emplace(state.p, 2), std::make_pair(std::size_t{0}, false));
+    nodes[state.p->e[0].p] += 3;
+    nodes[dd::Package::vNode::terminal] = 4;
+    EXPECT_EQ(nodes.size(), 3);
+    EXPECT_TRUE(nodes.contains(state.p->e[0].p));
+    EXPECT_FALSE(nodes.contains(state.p->e[1].p));
+    EXPECT_EQ(*nodes.find(state.p), 1);
+    EXPECT_EQ(nodes.at(1), 3);
+    EXPECT_EQ(nodes.getValues(), (std::vector<int>{1, 3, 4}));
+    // the nodes themselves are not marked
+    EXPECT_FALSE(state.p->visited);
+
+    // growing the index retains all entries in the order of their insertion
+    std::vector<std::unique_ptr<dd::Package::vNode>> others{};
+    for (int i = 0; i < 1000; ++i) {
+        others.push_back(std::make_unique<dd::Package::vNode>());
+        EXPECT_TRUE(nodes.try_emplace(others.back().get(), i).second);
+    }
+    EXPECT_EQ(nodes.size(), 1003);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(nodes.position(others[static_cast<std::size_t>(i)].get()), static_cast<std::size_t>(i) + 3);
+    }
+    EXPECT_EQ(*nodes.find(state.p), 1);
+
+    nodes.clear();
+    EXPECT_TRUE(nodes.empty());
+    EXPECT_FALSE(nodes.contains(state.p));
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, VectorExport) {
+    constexpr dd::QubitCount nqubits = 15;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    // uniform superposition on the upper qubits, an entangled part on the lower ones
+    auto state = dd->makeZeroState(nqubits);
+    for (dd::Qubit q = 4; q < static_cast<dd::Qubit>(nqubits); ++q) {
+        state = dd->applyGate(state, dd::Hmat, {}, q);
+    }
+    state = dd->applyGate(state, dd::RYmat(0.4), {}, 0);
+    state = dd->applyGate(state, dd::Xmat, {0_pc}, 2);
+    state = dd->applyGate(state, dd::Tmat, {}, 2);
+    dd->incRef(state);
+
+    const auto dim       = std::size_t{1} << nqubits;
+    const auto reference = dd->getVector(state);
+    ASSERT_EQ(reference.size(), dim);
+    for (std::size_t i = 0; i < dim; ++i) {
+        EXPECT_EQ(reference[i], static_cast<std::complex<dd::fp>>(dd->getValueByPath(state, i)));
+    }
+
+    dd::CVec range(1000);
+    dd->getVector(state, range.data(), 12345, range.size());
+    EXPECT_TRUE(std::equal(range.begin(), range.end(), reference.begin() + 12345));
+    EXPECT_THROW(dd->getVector(state, range.data(), dim - 10, range.size()), std::invalid_argument);
+
+    std::size_t next = 0;
+    dd->forEachAmplitudeChunk(state, 3000, [&](std::size_t first, const std::complex<dd::fp>* amplitudes, std::size_t count) {
+        EXPECT_EQ(first, next);
+        EXPECT_TRUE(std::equal(amplitudes, amplitudes + count, reference.begin() + static_cast<std::ptrdiff_t>(first)));
+        next += count;
+    });
+    EXPECT_EQ(next, dim);
+
+    dd->setParallelism(2);
+    EXPECT_EQ(dd->getVector(state), reference);
+    dd->setParallelism(1);
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, PrefetchedLookup) {
+    auto dd = std::make_unique<dd::Package>(2);
+
+    // siblings may coincide or vanish entirely
+    const auto w        = dd->cn.lookup(0.5, 0.5);
+    const auto siblings = std::array<std::array<dd::Package::mEdge, dd::NEDGE>, 4>{{{dd::Package::mEdge::one, dd::Package::mEdge::zero, dd::Package::mEdge::zero, dd::Package::mEdge::one},
+                                                                                    {dd::Package::mEdge::zero, dd::Package::mEdge::terminal(w), dd::Package::mEdge::one, dd::Package::mEdge::zero},
+                                                                                    {dd::Package::mEdge::one, dd::Package::mEdge::zero, dd::Package::mEdge::zero, dd::Package::mEdge::one},
+                                                                                    {dd::Package::mEdge::zero, dd::Package::mEdge::zero, dd::Package::mEdge::zero, dd::Package::mEdge::zero}}};
+    const auto nodes    = dd->makeDDNodes(0, siblings);
+    for (std::size_t k = 0; k < siblings.size(); ++k) {
+        EXPECT_EQ(dd->makeDDNode(0, siblings[k]), nodes[k]);
+    }
+    EXPECT_EQ(nodes[0], nodes[2]);
+    EXPECT_TRUE(nodes[0].p->ident);
+    EXPECT_EQ(nodes[3], dd::Package::mEdge::zero);
+    EXPECT_EQ(dd->mUniqueTable.getNodeCount(), 2);
+
+    // hashes of prepared lookups remain valid while the table grows
+    std::vector<dd::Complex> weights{};
+    for (std::size_t i = 0; i < 64; ++i) {
+        weights.push_back(dd->cn.lookup(static_cast<dd::fp>(i) / 64., 0.));
+    }
+    const auto prepareAndResolve = [&](auto& unique) {
+        std::vector<dd::Package::vEdge> edges{};
+        std::vector<std::size_t>        hashes{};
+        for (const auto& weight: weights) {
+            dd::Package::vEdge e{unique.getNode(), dd::Complex::one};
+            e.p->v = 0;
+            e.p->e = {dd::Package::vEdge::terminal(weight), dd::Package::vEdge::one};
+            edges.push_back(e);
+            hashes.push_back(unique.prefetch(e.p));
+        }
+        for (std::size_t i = 0; i < edges.size(); ++i) {
+            EXPECT_EQ(unique.lookupHashed(edges[i], hashes[i]).p, edges[i].p);
+        }
+        EXPECT_GE(unique.getBuckets(0), edges.size());
+        for (const auto& edge: edges) {
+            EXPECT_EQ(unique.lookup(edge, true).p, edge.p);
+        }
+        EXPECT_EQ(unique.getNodeCount(), edges.size());
+    };
+    auto chaining = std::make_unique<dd::UniqueTable<dd::Package::vNode, 4>>(1);
+    prepareAndResolve(*chaining);
+    auto openAddressing = std::make_unique<dd::UniqueTable<dd::Package::vNode, 4, 2048, 2, 131072, dd::UniqueTableLayout::OpenAddressing>>(1);
+    prepareAndResolve(*openAddressing);
+}
+
+TEST(DDPackageTest, LookupTolerance) {
+    // tolerances and offsets are relative to the process-wide tolerance, which depends on the precision
+    const auto        tol = dd::ComplexTable<>::tolerance();
+    dd::PackageConfig config{};
+    config.tolerance = 10 * tol;
+    auto coarse      = std::make_unique<dd::Package>(1, config);
+    auto fine        = std::make_unique<dd::Package>(1);
+    EXPECT_EQ(coarse->cn.getLookupTolerance(), 10 * tol);
+    EXPECT_EQ(fine->cn.getLookupTolerance(), tol);
+
+    // numbers are only identified within the tolerance of the respective package
+    const dd::fp half = 0.5;
+    EXPECT_EQ(coarse->cn.lookup(half + 3 * tol, 0.), coarse->cn.lookup(half, 0.));
+    EXPECT_NE(fine->cn.lookup(half + 3 * tol, 0.), fine->cn.lookup(half, 0.));
+    EXPECT_EQ(coarse->cn.lookup(1 - tol, -tol), dd::Complex::one);
+
+    // small rotations vanish in the coarse package only
+    const auto rotation = dd::RYmat(6 * tol);
+    const auto state    = coarse->multiply(coarse->makeGateDD(rotation, 1, 0), coarse->makeZeroState(1));
+    EXPECT_EQ(state, coarse->makeZeroState(1));
+    EXPECT_EQ(coarse->makeGateDD(rotation, 1, 0), coarse->makeIdent(1));
+    EXPECT_NE(fine->multiply(fine->makeGateDD(rotation, 1, 0), fine->makeZeroState(1)), fine->makeZeroState(1));
+    EXPECT_NE(fine->makeGateDD(rotation, 1, 0), fine->makeIdent(1));
+
+    EXPECT_THROW(coarse->cn.setLookupTolerance(0.), std::invalid_argument);
+    EXPECT_THROW(coarse->cn.setLookupTolerance(0.5), std::invalid_argument);
+    EXPECT_THROW(coarse->cn.setLookupTolerance(tol / 2), std::invalid_argument);
+    EXPECT_EQ(coarse->cn.getLookupTolerance(), 10 * tol);
+
+    // packages without a tolerance of their own follow changes of the process-wide tolerance
+    const dd::fp quarter = 0.25;
+    dd::ComplexNumbers::setTolerance(5 * tol);
+    EXPECT_EQ(fine->cn.getLookupTolerance(), 5 * tol);
+    EXPECT_EQ(fine->cn.lookup(quarter + 2 * tol, 0.), fine->cn.lookup(quarter, 0.));
+    EXPECT_EQ(coarse->cn.getLookupTolerance(), 10 * tol);
+    dd::ComplexNumbers::setTolerance(20 * tol);
+    EXPECT_EQ(coarse->cn.getLookupTolerance(), 20 * tol);
+    dd::ComplexNumbers::setTolerance(tol);
+    coarse->cn.resetLookupTolerance();
+    EXPECT_EQ(coarse->cn.getLookupTolerance(), tol);
+}
+
+TEST(DDPackageTest, Approximation) {
+    constexpr dd::QubitCount nqubits = 3;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    // (|00> + |11>)/sqrt(2) on qubits 2 and 1, qubit 0 measures |1> with probability 0.01
+    const auto                           theta = 2. * std::asin(0.1);
+    const std::vector<dd::GateOperation> gates{
+            {dd::Hmat, {}, 2},
+            {dd::RYmat(theta), {}, 0},
+            {dd::Xmat, {2_pc}, 1},
+    };
+    auto state = dd->applyGates(dd->makeZeroState(nqubits), gates, nqubits);
+    dd->incRef(state);
+
+    // no edge contributes less than 0.001
+    const auto exact = dd->approximate(state, 1e-3);
+    EXPECT_EQ(exact.state, state);
+    EXPECT_EQ(exact.removedEdges, 0);
+    EXPECT_EQ(exact.fidelity, 1.);
+
+    const auto approximation = dd->approximate(state, 0.05);
+    EXPECT_EQ(approximation.removedEdges, 1);
+    EXPECT_NEAR(approximation.fidelity, 0.99, ACCURACY);
+    EXPECT_NEAR(dd->fidelity(state, approximation.state), 0.99, ACCURACY);
+    const auto vector = dd->getVector(approximation.state);
+    for (std::size_t i = 0; i < vector.size(); ++i) {
+        const auto expected = (i == 0 || i == 6) ? dd::SQRT2_2 : 0.;
+        EXPECT_NEAR(vector[i].real(), expected, ACCURACY);
+        EXPECT_NEAR(vector[i].imag(), 0., ACCURACY);
+    }
+
+    // everything is removed
+    const auto removed = dd->approximate(state, 1.);
+    EXPECT_EQ(removed.state, dd::Package::vEdge::zero);
+    EXPECT_EQ(removed.fidelity, 0.);
+    dd->decRef(state);
+
+    // applyGates approximates all intermediate states exceeding the budget
+    dd::PackageConfig config{};
+    config.approximationNodeBudget = 1;
+    config.approximationThreshold  = 0.05;
+    auto approximating             = std::make_unique<dd::Package>(nqubits, config);
+    const auto result              = approximating->getVector(approximating->applyGates(approximating->makeZeroState(nqubits), gates, nqubits));
+    for (std::size_t i = 0; i < vector.size(); ++i) {
+        EXPECT_NEAR(result[i].real(), vector[i].real(), ACCURACY);
+        EXPECT_NEAR(result[i].imag(), vector[i].imag(), ACCURACY);
+    }
+    const auto& stats = approximating->getApproximationStatistics();
+    EXPECT_EQ(stats.runs, 2);
+    EXPECT_EQ(stats.removedEdges, 1);
+    EXPECT_NEAR(stats.fidelity, 0.99, ACCURACY);
+
+    approximating->reset();
+    EXPECT_EQ(approximating->getApproximationStatistics().runs, 0);
+}
+
+TEST(DDPackageTest, VariableReordering) {
+    constexpr dd::QubitCount nqubits = 6;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    // Bell pairs of qubits i and i + 3 are entangled across all levels in between
+    std::vector<dd::GateOperation> gates{};
+    for (dd::Qubit q = 0; q < 3; ++q) {
+        gates.push_back({dd::Hmat, {}, q});
+        gates.push_back({dd::Xmat, {dd::Control{q}}, static_cast<dd::Qubit>(q + 3)});
+    }
+    gates.push_back({dd::Tmat, {}, 1});
+    auto state = dd->applyGates(dd->makeZeroState(nqubits), gates, nqubits);
+    dd->incRef(state);
+
+    // swapping twice yields the original DD
+    const auto swapped = dd->swapLevels(state, 2);
+    EXPECT_EQ(dd->swapLevels(swapped, 2), state);
+    EXPECT_THROW(dd->swapLevels(state, nqubits - 1), std::invalid_argument);
+
+    std::vector<dd::Qubit> permutation{};
+    const auto             sifted = dd->sift(state, permutation);
+    EXPECT_LT(dd->size(sifted), dd->size(state));
+    EXPECT_EQ(permutation.size(), nqubits);
+    EXPECT_TRUE(std::is_permutation(permutation.begin(), permutation.end(), std::vector<dd::Qubit>{0, 1, 2, 3, 4, 5}.begin()));
+    for (std::size_t i = 0; i < (1U << nqubits); ++i) {
+        std::string path(nqubits, '0');
+        for (std::size_t q = 0; q < nqubits; ++q) {
+            path[q] = ((i >> q) & 1U) != 0U ? '1' : '0';
+        }
+        const auto expected = dd->getValueByPath(state, path);
+        const auto actual   = dd->getValueByPath(sifted, path, permutation);
+        EXPECT_NEAR(expected.r, actual.r, ACCURACY);
+        EXPECT_NEAR(expected.i, actual.i, ACCURACY);
+    }
+
+    const auto restored = dd->restoreOrder(sifted, permutation);
+    EXPECT_EQ(restored, state);
+    EXPECT_EQ(permutation, (std::vector<dd::Qubit>{0, 1, 2, 3, 4, 5}));
+    dd->decRef(state);
+
+    // swapping the levels of a CNOT exchanges its control and target
+    const auto cx = dd->makeGateDD(dd::Xmat, 2, 0_pc, 1);
+    EXPECT_EQ(dd->swapLevels(cx, 0), dd->makeGateDD(dd::Xmat, 2, 1_pc, 0));
+
+    // applyGates reorders intermediate states, but yields the state in the original order
+    dd::PackageConfig config{};
+    config.reorderingNodeThreshold = 4;
+    auto reordering                = std::make_unique<dd::Package>(nqubits, config);
+    const auto result              = reordering->getVector(reordering->applyGates(reordering->makeZeroState(nqubits), gates, nqubits));
+    const auto expected            = dd->getVector(state);
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_NEAR(result[i].real(), expected[i].real(), ACCURACY);
+        EXPECT_NEAR(result[i].imag(), expected[i].imag(), ACCURACY);
+    }
+}
+
+TEST(DDPackageTest, ExpectationValue) {
+    constexpr dd::QubitCount nqubits = 4;
+    auto                     dd      = std::make_unique<dd::Package>(nqubits);
+
+    const std::vector<dd::GateOperation> gates{
+            {dd::Hmat, {}, 0},
+            {dd::RYmat(0.4), {}, 1},
+            {dd::Xmat, {0_pc}, 2},
+            {dd::Tmat, {}, 2},
+            {dd::RXmat(1.1), {2_nc}, 3},
+            {dd::Hmat, {}, 1},
+    };
+    auto state = dd->applyGates(dd->makeZeroState(nqubits), gates, nqubits);
+    dd->incRef(state);
+    const auto vector = dd->getVector(state);
+
+    // <psi|O|psi> for a non-Hermitian operator
+    auto op = dd->makeGateDD(dd::Smat, nqubits, 3_pc, 0);
+    op      = dd->multiply(dd->makeGateDD(dd::RYmat(0.9), nqubits, 2), op);
+    dd->incRef(op);
+    const auto matrix = dd->getMatrix(op);
+    std::complex<dd::fp> expected{};
+    for (std::size_t i = 0; i < vector.size(); ++i) {
+        for (std::size_t j = 0; j < vector.size(); ++j) {
+            expected += std::conj(vector[i]) * matrix[i][j] * vector[j];
+        }
+    }
+    const auto value = dd->expectationValue(op, state);
+    EXPECT_NEAR(value.r, expected.real(), ACCURACY);
+    EXPECT_NEAR(value.i, expected.imag(), ACCURACY);
+    const auto hits   = dd->expectationValues.getHits();
+    const auto cached = dd->expectationValue(op, state);
+    EXPECT_EQ(dd->expectationValues.getHits(), hits + 1);
+    EXPECT_NEAR(cached.r, value.r, ACCURACY);
+    EXPECT_NEAR(cached.i, value.i, ACCURACY);
+    EXPECT_THROW(dd->expectationValue(dd->makeIdent(2), state), std::invalid_argument);
+
+    // Pauli strings match the expectation values of the corresponding operators
+    const std::map<char, dd::GateMatrix> paulis{{'X', dd::Xmat}, {'Y', dd::Ymat}, {'Z', dd::Zmat}};
+    for (const std::string pauli: {"IIII", "ZIII", "XZYI", "YYXZ", "IXIX", "ZZZZ"}) {
+        auto pauliOp = dd->makeIdent(nqubits);
+        for (std::size_t q = 0; q < nqubits; ++q) {
+            if (pauli[q] != 'I') {
+                pauliOp = dd->multiply(dd->makeGateDD(paulis.at(pauli[q]), nqubits, static_cast<dd::Qubit>(q)), pauliOp);
+            }
+        }
+        const auto reference = dd->expectationValue(pauliOp, state);
+        EXPECT_NEAR(dd->expectationValue(pauli, state), reference.r, ACCURACY);
+        EXPECT_NEAR(reference.i, 0., ACCURACY);
+    }
+    EXPECT_NEAR(dd->expectationValue("IIII", state), 1., ACCURACY);
+    EXPECT_THROW(dd->expectationValue("IIA", state), std::invalid_argument);
+    EXPECT_THROW(dd->expectationValue("IIAI", state), std::invalid_argument);
+    dd->decRef(op);
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, AdaptiveUniqueTable) {
+    auto       dd      = std::make_unique<dd::Package>(3);
+    const auto initial = dd->vUniqueTable.getBuckets(0);
+
+    // a dense level grows its buckets, while the others keep their initial size
+    // weights of the same magnitude, so that their normalized values stay far apart (also in single precision)
+    const auto weight = [&](std::size_t i) {
+        const auto phase = 2 * dd::PI * static_cast<dd::fp>(i) / static_cast<dd::fp>(4 * initial);
+        return dd->cn.lookup(std::cos(phase) / 2, std::sin(phase) / 2);
+    };
+    std::vector<dd::Package::vNode*> nodes{};
+    for (std::size_t i = 0; i < 4 * initial; ++i) {
+        const auto w = weight(i);
+        nodes.push_back(dd->makeDDNode(0, std::array{dd::Package::vEdge::one, dd::Package::vEdge::terminal(w)}).p);
+    }
+    EXPECT_GE(dd->vUniqueTable.getBuckets(0), dd->vUniqueTable.getNodeCount());
+    EXPECT_EQ(dd->vUniqueTable.getBuckets(1), initial);
+    // nodes are still found after rehashing
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        const auto w = weight(i);
+        EXPECT_EQ(dd->makeDDNode(0, std::array{dd::Package::vEdge::one, dd::Package::vEdge::terminal(w)}).p, nodes[i]);
+    }
+
+    dd->reset();
+    EXPECT_EQ(dd->vUniqueTable.getBuckets(0), initial);
+
+    // qubits can only be removed if none of their nodes are in use
+    auto state = dd->makeZeroState(3);
+    dd->incRef(state);
+    EXPECT_THROW(dd->resize(2), std::invalid_argument);
+    EXPECT_EQ(dd->qubits(), 3);
+    dd->decRef(state);
+    const auto nodeCount = dd->vUniqueTable.getNodeCount();
+    dd->resize(2);
+    EXPECT_EQ(dd->qubits(), 2);
+    EXPECT_EQ(dd->vUniqueTable.getNodeCount(), nodeCount - 1);
+    EXPECT_THROW(static_cast<void>(dd->vUniqueTable.getBuckets(2)), std::out_of_range);
+
+    // the package remains usable
+    dd->resize(3);
+    EXPECT_EQ(dd->vUniqueTable.getBuckets(2), initial);
+    state = dd->makeZeroState(3);
+    EXPECT_EQ(state.p->v, 2);
+}
+
+TEST(DDPackageTest, RetainMemoryOnReset) {
+    const auto build = [](dd::Package& dd) {
+        for (std::size_t i = 0; i < 5000; ++i) {
+            const auto w = dd.cn.lookup(static_cast<dd::fp>(i) / 5000., 1.);
+            dd.makeDDNode(0, std::array{dd::Package::vEdge::one, dd::Package::vEdge::terminal(w)});
+        }
+    };
+
+    // by default, all but the first chunk are released
+    auto dd = std::make_unique<dd::Package>(1);
+    build(*dd);
+    const auto nodeAllocations  = dd->vUniqueTable.getAllocations();
+    const auto entryAllocations = dd->cn.complexTable.getAllocations();
+    dd->reset();
+    dd->cn.clear();
+    EXPECT_LT(dd->vUniqueTable.getAllocations(), nodeAllocations);
+    EXPECT_LT(dd->cn.complexTable.getAllocations(), entryAllocations);
+
+    // with a sufficiently high limit, the memory is kept and reused
+    dd::PackageConfig config{};
+    config.retainedMemory = 1U << 30U;
+    auto retaining        = std::make_unique<dd::Package>(1, config);
+    build(*retaining);
+    EXPECT_EQ(retaining->vUniqueTable.getAllocations(), nodeAllocations);
+    for (std::size_t job = 0; job < 3; ++job) {
+        retaining->reset();
+        retaining->cn.clear();
+        EXPECT_EQ(retaining->vUniqueTable.getAllocations(), nodeAllocations);
+        EXPECT_EQ(retaining->cn.complexTable.getAllocations(), entryAllocations);
+        build(*retaining);
+        EXPECT_EQ(retaining->vUniqueTable.getNodeCount(), 5000);
+        EXPECT_EQ(retaining->vUniqueTable.getAllocations(), nodeAllocations);
+        EXPECT_EQ(retaining->cn.complexTable.getAllocations(), entryAllocations);
+    }
+
+    // memory beyond the limit is released
+    retaining->vUniqueTable.setRetainedMemory(4096 * sizeof(dd::Package::vNode));
+    retaining->reset();
+    EXPECT_LT(retaining->vUniqueTable.getAllocations(), nodeAllocations);
+}
+
+TEST(DDPackageTest, ChunkAllocator) {
+    dd::ChunkAllocator<std::uint64_t> allocator{};
+
+    // small chunks are obtained from the global operator new
+    auto* small = allocator.allocate(16);
+    small[15]   = 1;
+    allocator.deallocate(small, 16);
+
+    // large chunks are aligned to huge pages
+    constexpr std::size_t n     = 3 * dd::ChunkAllocatorSettings::HUGE_PAGE_SIZE / sizeof(std::uint64_t) + 1;
+    auto*                 large = allocator.allocate(n);
+#if defined(__linux__)
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % dd::ChunkAllocatorSettings::HUGE_PAGE_SIZE, 0U);
+#endif
+    large[0]     = 1;
+    large[n - 1] = 2;
+    EXPECT_EQ(large[0] + large[n - 1], 3U);
+    allocator.deallocate(large, n);
+
+#ifndef DD_PACKAGE_COMPACT_NODES
+    // pools accept other allocators (except in the compact build, where they have to allocate from the arenas)
+    auto unique = std::make_unique<dd::UniqueTable<dd::Package::mNode, 1024, 2048, 2, 131072, dd::UniqueTableLayout::Chaining, std::allocator>>(1);
+    for (std::size_t i = 0; i < 3000; ++i) {
+        EXPECT_NE(unique->getNode(), nullptr);
+    }
+    EXPECT_GT(unique->getAllocations(), 2048);
+    dd::ComplexCache<2048, 2, std::allocator> cache{};
+    EXPECT_NE(cache.getCachedComplex().r, nullptr);
+#endif
+}
+
+TEST(DDPackageTest, ComputeTableConfiguration) {
+    dd::PackageConfig config{};
+    config.multiplicationTableSize = 64;
+    config.kroneckerTableSize      = 128;
+    config.autoResizeComputeTables = true;
+    config.resizeFillFactor        = 0.25;
+    config.resizeHitRatio          = 1.01; // grow regardless of the hit ratio
+    config.maxComputeTableSize     = 128;
+    auto dd                        = std::make_unique<dd::Package>(4, config);
+
+    EXPECT_EQ(dd->getConfig().multiplicationTableSize, 64);
+    EXPECT_EQ(dd->matrixMatrixMultiplication.getBuckets(), 64);
+    EXPECT_EQ(dd->matrixVectorMultiplication.getBuckets(), 64);
+    EXPECT_EQ(dd->matrixKronecker.getBuckets(), 128);
+    EXPECT_EQ(dd->vectorAdd.getBuckets(), dd::PackageConfig{}.addTableSize);
+    EXPECT_THROW(dd->matrixAdd.resize(100), std::invalid_argument);
+
+    auto func = dd->makeIdent(4);
+    for (dd::Qubit q = 0; q < 4; ++q) {
+        func = dd->multiply(dd->makeGateDD(dd::Hmat, 4, q), func);
+        func = dd->multiply(dd->makeGateDD(dd::Tmat, 4, dd::Control{static_cast<dd::Qubit>((q + 1) % 4)}, q), func);
+    }
+    dd->incRef(func);
+    ASSERT_GE(dd->matrixMatrixMultiplication.getCount(), 16);
+
+    // entries survive resizing
+    auto lookupsBefore = dd->matrixMatrixMultiplication.getLookups();
+    auto hitsBefore    = dd->matrixMatrixMultiplication.getHits();
+    dd->matrixMatrixMultiplication.resize(64);
+    EXPECT_EQ(dd->matrixMatrixMultiplication.getLookups(), lookupsBefore);
+    dd->multiply(dd->makeGateDD(dd::Tmat, 4, dd::Control{0}, 3), func);
+    EXPECT_GT(dd->matrixMatrixMultiplication.getHits(), hitsBefore);
+
+    // the heavily used multiplication table is doubled once per garbage collection until the maximum is reached
+    dd->garbageCollect(true);
+    EXPECT_EQ(dd->matrixMatrixMultiplication.getBuckets(), 128);
+    EXPECT_EQ(dd->matrixKronecker.getBuckets(), 128);
+    dd->multiply(dd->makeGateDD(dd::Hmat, 4, 3), func);
+    dd->garbageCollect(true);
+    EXPECT_EQ(dd->matrixMatrixMultiplication.getBuckets(), 128);
+    dd->decRef(func);
+}
+
+TEST(DDPackageTest, GrownComputeTableIsCleared) {
+    using CachedEdge = dd::Package::vCachedEdge;
+    auto       table = std::make_unique<dd::ComputeTable<CachedEdge, CachedEdge, CachedEdge, 4>>();
+    const auto edge  = [](dd::fp x) { return CachedEdge{dd::Package::vNode::terminal, dd::ComplexValue{x, 0.}}; };
+    table->insert(edge(1.), edge(1.), edge(1.));
+    for (std::size_t i = 0; i < 10; ++i) {
+        EXPECT_EQ(table->lookup(edge(2.), edge(2.)).p, nullptr);
+    }
+    ASSERT_TRUE(table->growIfThrashing(0.5, 0.25, 16));
+    EXPECT_EQ(table->getBuckets(), 8);
+    EXPECT_EQ(table->getLookups(), 0);
+    EXPECT_EQ(table->lookup(edge(1.), edge(1.)).w.r, 1.);
+    // the rehashed result is still wiped
+    table->clear();
+    EXPECT_EQ(table->lookup(edge(1.), edge(1.)).p, nullptr);
+
+    // a table grown by a garbage collection does not keep results referring to the collected nodes
+    dd::PackageConfig config{};
+    config.multiplicationTableSize = 16;
+    config.autoResizeComputeTables = true;
+    config.resizeFillFactor        = 0.25;
+    config.resizeHitRatio          = 1.01; // grow regardless of the hit ratio
+    config.maxComputeTableSize     = 64;
+    auto dd                        = std::make_unique<dd::Package>(4, config);
+    auto func                      = dd->makeIdent(4);
+    for (dd::Qubit q = 0; q < 4; ++q) {
+        func = dd->multiply(dd->makeGateDD(dd::Hmat, 4, q), func);
+        func = dd->multiply(dd->makeGateDD(dd::Tmat, 4, dd::Control{static_cast<dd::Qubit>((q + 1) % 4)}, q), func);
+    }
+    ASSERT_GE(dd->matrixMatrixMultiplication.getCount(), 4);
+    dd->garbageCollect(true);
+    ASSERT_EQ(dd->matrixMatrixMultiplication.getBuckets(), 32);
+    for (std::size_t i = 0; i < dd->matrixMatrixMultiplication.getBuckets(); ++i) {
+        EXPECT_EQ(dd->matrixMatrixMultiplication.getEntry(i).result.p, nullptr);
+    }
+    EXPECT_EQ(dd->multiply(dd->makeGateDD(dd::Hmat, 4, 0), dd->makeIdent(4)), dd->makeGateDD(dd::Hmat, 4, 0));
+}
+
+TEST(DDPackageTest, ConcurrentComputeTable) {
+    using CachedEdge = dd::Package::vCachedEdge;
+    // a small table provokes many threads operating on the same entries
+    auto table = std::make_unique<dd::ComputeTable<CachedEdge, CachedEdge, CachedEdge, 16>>();
+
+    constexpr std::size_t    nthreads   = 4;
+    constexpr std::size_t    iterations = 20000;
+    std::vector<std::size_t> mismatches(nthreads, 0);
+    std::vector<std::thread> threads{};
+    table->enableConcurrency(nthreads);
+    for (std::size_t t = 0; t < nthreads; ++t) {
+        threads.emplace_back([&, t]() {
+            dd::workerIndex = t;
+            for (std::size_t k = 0; k < iterations; ++k) {
+                // the result is fully determined by the operands, so torn entries would be detected
+                const auto       x = static_cast<dd::fp>((k * (t + 1)) % 64);
+                const CachedEdge left{dd::Package::vNode::terminal, dd::ComplexValue{x, 0.}};
+                const CachedEdge right{dd::Package::vNode::terminal, dd::ComplexValue{0., x}};
+                const auto       r = table->lookup(left, right);
+                if (r.p != nullptr) {
+                    if (r.w.r != 2 * x || r.w.i != -x) {
+                        ++mismatches[t];
+                    }
+                } else {
+                    table->insert(left, right, {dd::Package::vNode::terminal, dd::ComplexValue{2 * x, -x}});
+                }
+            }
+        });
+    }
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    table->disableConcurrency();
+
+    for (const auto m: mismatches) {
+        EXPECT_EQ(m, 0);
+    }
+    // statistics of all threads are aggregated
+    EXPECT_EQ(table->getLookups(), nthreads * iterations);
+    EXPECT_LE(table->getCount(), nthreads * iterations - table->getHits());
+    table->printStatistics();
+
+    table->clear();
+    EXPECT_EQ(table->getLookups(), 0);
+    EXPECT_EQ(table->getEntry(0).result.p, nullptr);
+}
+
+TEST(DDPackageTest, SetAssociativeComputeTable) {
+    using CachedEdge = dd::Package::vCachedEdge;
+    // a single set of two buckets
+    auto table = std::make_unique<dd::ComputeTable<CachedEdge, CachedEdge, CachedEdge, 2, 2>>();
+    EXPECT_EQ(table->getBuckets(), 2);
+    EXPECT_THROW(table->resize(1), std::invalid_argument);
+
+    const auto edge = [](dd::fp x) { return CachedEdge{dd::Package::vNode::terminal, dd::ComplexValue{x, 0.}}; };
+    table->insert(edge(1.), edge(1.), edge(1.));
+    table->insert(edge(2.), edge(2.), edge(2.));
+    // both results reside in the same set
+    EXPECT_EQ(table->lookup(edge(2.), edge(2.)).w.r, 2.);
+    EXPECT_EQ(table->lookup(edge(1.), edge(1.)).w.r, 1.);
+
+    // the least recently used result is replaced
+    table->insert(edge(3.), edge(3.), edge(3.));
+    EXPECT_EQ(table->lookup(edge(2.), edge(2.)).p, nullptr);
+    EXPECT_EQ(table->lookup(edge(1.), edge(1.)).w.r, 1.);
+    EXPECT_EQ(table->lookup(edge(3.), edge(3.)).w.r, 3.);
+
+    // entries survive resizing
+    table->resize(8);
+    EXPECT_EQ(table->lookup(edge(1.), edge(1.)).w.r, 1.);
+    EXPECT_EQ(table->lookup(edge(3.), edge(3.)).w.r, 3.);
+
+    table->clear();
+    EXPECT_EQ(table->lookup(edge(1.), edge(1.)).p, nullptr);
+
+    // results for operands that are already stored replace the previous result in the same bucket
+    table->resize(2);
+    table->insert(edge(1.), edge(1.), edge(1.));
+    table->insert(edge(1.), edge(1.), edge(4.));
+    std::size_t stored = 0;
+    for (std::size_t i = 0; i < table->getBuckets(); ++i) {
+        const auto entry = table->getEntry(i);
+        if (entry.result.p != nullptr && entry.leftOperand == edge(1.)) {
+            ++stored;
+        }
+    }
+    EXPECT_EQ(stored, 1);
+    EXPECT_EQ(table->lookup(edge(1.), edge(1.)).w.r, 4.);
+}
+
+TEST(DDPackageTest, DepthReplacementComputeTable) {
+    using CachedEdge = dd::Package::vCachedEdge;
+    auto table       = std::make_unique<dd::ComputeTable<CachedEdge, CachedEdge, CachedEdge, 2, 2, dd::ComputeTableReplacement::Depth>>();
+    EXPECT_EQ(table->getReplacement(), dd::ComputeTableReplacement::Depth);
+
+    // the nodes of the zero state reside on the levels 2, 1 and 0
+    auto dd    = std::make_unique<dd::Package>(3);
+    auto state = dd->makeZeroState(3);
+    dd->incRef(state);
+    std::array<dd::Package::vNode*, 3> nodes{};
+    nodes[2] = dd::toPointer(state.p);
+    nodes[1] = dd::toPointer(nodes[2]->e[0].p);
+    nodes[0] = dd::toPointer(nodes[1]->e[0].p);
+    const auto edge = [&](dd::Qubit level, dd::fp x) { return CachedEdge{nodes[static_cast<std::size_t>(level)], dd::ComplexValue{x, 0.}}; };
+
+    table->insert(edge(2, 1.), edge(2, 1.), edge(2, 1.));
+    table->insert(edge(0, 2.), edge(0, 2.), edge(0, 2.));
+    EXPECT_EQ(table->lookup(edge(0, 2.), edge(0, 2.)).w.r, 2.);
+
+    // the shallowest result is replaced, even though the deep result has been used less recently
+    table->insert(edge(1, 3.), edge(1, 3.), edge(1, 3.));
+    EXPECT_EQ(table->lookup(edge(0, 2.), edge(0, 2.)).p, nullptr);
+    EXPECT_EQ(table->lookup(edge(2, 1.), edge(2, 1.)).w.r, 1.);
+    EXPECT_EQ(table->lookup(edge(1, 3.), edge(1, 3.)).w.r, 3.);
+    table->insert(edge(0, 4.), edge(0, 4.), edge(0, 4.));
+    EXPECT_EQ(table->lookup(edge(1, 3.), edge(1, 3.)).p, nullptr);
+    EXPECT_EQ(table->lookup(edge(2, 1.), edge(2, 1.)).w.r, 1.);
+
+    // the levels survive resizing and clearing empties the buckets
+    table->resize(4);
+    EXPECT_EQ(table->lookup(edge(2, 1.), edge(2, 1.)).w.r, 1.);
+    EXPECT_EQ(table->lookup(edge(0, 4.), edge(0, 4.)).w.r, 4.);
+    table->clear();
+    EXPECT_EQ(table->lookup(edge(2, 1.), edge(2, 1.)).p, nullptr);
+    dd->decRef(state);
+}
+
+TEST(DDPackageTest, ParallelMultiplication) {
+    const dd::QubitCount nqubits = 6;
+    auto                 dd      = std::make_unique<dd::Package>(nqubits);
+
+    // build the functionality of a QFT-like circuit
+    std::vector<dd::Package::mEdge> gates{};
+    for (dd::Qubit target = nqubits - 1; target >= 0; --target) {
+        gates.push_back(dd->makeGateDD(dd::Hmat, nqubits, target));
+        for (dd::Qubit control = target - 1; control >= 0; --control) {
+            gates.push_back(dd->makeGateDD(dd::Phasemat(dd::PI / (1U << (target - control))), nqubits, dd::Control{control}, target));
+        }
+    }
+    const auto buildFunctionality = [&]() {
+        auto func = dd->makeIdent(nqubits);
+        for (const auto& gate: gates) {
+            func = dd->multiply(gate, func);
+        }
+        return func;
+    };
+
+    const auto serialFunc  = buildFunctionality();
+    const auto serialState = dd->multiply(serialFunc, dd->makeBasisState(nqubits, {false, true, true, false, true, false}));
+    const auto serialSum   = dd->add(serialFunc, gates.front());
+
+    dd->setParallelism(4, 2);
+    EXPECT_EQ(dd->getParallelism(), 4);
+    EXPECT_EQ(dd->getParallelDepth(), 2);
+    dd->clearComputeTables();
+
+    const auto parallelFunc  = buildFunctionality();
+    const auto parallelState = dd->multiply(parallelFunc, dd->makeBasisState(nqubits, {false, true, true, false, true, false}));
+    const auto parallelSum   = dd->add(parallelFunc, gates.front());
+
+    // the unique tables guarantee that the same nodes are obtained
+    EXPECT_EQ(serialFunc, parallelFunc);
+    EXPECT_EQ(serialState, parallelState);
+    EXPECT_EQ(serialSum, parallelSum);
+
+    dd->setParallelism(1);
+    EXPECT_EQ(dd->getParallelism(), 1);
+}
+
 TEST(DDPackageTest, MatrixTranspose) {
     auto dd = std::make_unique<dd::Package>(2);
     auto cx = dd->makeGateDD(dd::Xmat, 2, 1_pc, 0);